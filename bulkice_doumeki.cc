@@ -1,13 +1,20 @@
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <sstream>
+#include <fstream>
 
-#include "G4RunManager.hh"
+#include "OMSimRunManager.hh"
 #include "G4UIterminal.hh"
 #include "G4UItcsh.hh"
 #include "FTFP_BERT.hh"
 #include "G4EmStandardPhysics_option4.hh"
 #include "G4OpticalPhysics.hh"
+#include "G4FastSimulationPhysics.hh"
 #include "G4SystemOfUnits.hh"
+#include "G4LogicalBorderSurface.hh"
+#include "G4LogicalSkinSurface.hh"
+#include "G4LogicalVolume.hh"
 
 #define G4VIS_USE 1
 #ifdef G4VIS_USE
@@ -22,9 +29,19 @@
 #include "OMSimEventAction.hh"
 #include "OMSimTrackingAction.hh"
 #include "OMSimSteppingAction.hh"
+#include "OMSimStackingAction.hh"
 #include "OMSimSteppingVerbose.hh"
 #include "OMSimAnalysisManager.hh"
+#include "OMSimTimeline.hh"
+#include "OMSimBenchmark.hh"
+#include "OMSimCADMesh.hh"
+#include "OMSimVoxelTuning.hh"
+#include "OMSimPhotonCache.hh"
+#include "OMSimPhotonList.hh"
+#include "OMSimAcceptanceTable.hh"
+#include "OMSimPropagationTable.hh"
 //#include "OMSimPMTQE.hh"
+#include "OMSimLogger.hh"
 
 //setting up the external variables
 G4int           gGlass = 1;
@@ -40,14 +57,81 @@ G4bool          gPlaceHarness = true;
 G4int           gHarness = 1;
 G4int           gRopeNumber = 1;
 G4double        gworldsize = 40.*m;
+G4int           gArrayStrings = 1; // strings of the module array (square grid in the x-y plane), 1 string with 1 module = single module at the origin
+G4int           gArrayModulesPerString = 1; // modules per string of the module array
+G4double        gArrayStringSpacing = 20 * m; // distance between neighbouring strings of the module array
+G4double        gArrayModuleSpacing = 3 * m; // vertical distance between the modules of a string
+G4bool          gArrayEnvelopes = true; // place the strings and modules of an array in ice envelopes (shallow navigation hierarchy)
+G4int           gArrayBenchmarkModules = 0; // benchmark photon steps per second of arrays of 1, 2, 4... up to this many modules, with and without envelopes, then exit; 0 = off
+G4int           gArrayBenchmarkEvents = 10; // events per array of the benchmark
+G4int           gModuleDetail = 2; // level of detail of the modules: 2 full (every harness part), 1 simplified (one merged proxy per harness material and surface), 0 minimal (vessel and PMTs)
+G4String        gDetailedModules = ""; // comma separated IDs of modules placed at full detail whatever gModuleDetail, e.g. "0,1"
+G4int           gDetailValidationEvents = 0; // compare the hit rates of the simplified and minimal levels with full detail, with this many events per level, then exit; 0 = off
+G4double        gDetailTolerance = 0.02; // largest accepted relative change of the hit rate of a level of detail w.r.t. full detail
+G4bool          gPMTBorderSurfaces = false; // border surfaces for every PMT placement instead of skin surfaces per PMT type (former behaviour)
+G4bool          gFlatSupportStructure = false; // mDOM holder as the foam minus one voxelised G4MultiUnion of all cut-outs, instead of a chain of ~35 subtractions
+G4int           gSupportStructureCheck = 0; // points at which the flat mDOM holder is compared with the boolean chain (equivalence and speed-up), 0 = off
+G4bool          gAnalyticPMTBulbs = false; // simple PMT bulbs as OMSimRevolvedSolid (closed-form navigation) instead of boolean solids
+G4int           gPMTBulbCheck = 0; // points at which the analytic PMT bulbs are compared with the boolean ones (equivalence and speed-up), 0 = off
+G4bool          gAnalyticVessels = false; // mDOM and LOM18 pressure vessels as OMSimRevolvedSolid instead of boolean solids / G4Polycone
+G4int           gVesselCheck = 0; // points at which the analytic pressure vessels are compared with the boolean ones (equivalence and speed-up), 0 = off
+G4double        gDEGGSegmentScale = 1; // factor on the segment counts of the polycones approximating the dEGG vessel tori (jOutSegments1/2, jInnSegments1/2 of om_DEGG)
+G4int           gDEGGSegmentBenchmarkEvents = 0; // benchmark the dEGG vessel for several segment scales (time per photon, deviation, hit rate) with this many events per scale, then exit; 0 = off
+G4bool          gVoxelTuning = true; // apply the smartless / voxelisation settings stored in the OM json files (jVoxelTuning, see OMSimVoxelTuning)
+G4int           gVoxelTuningEvents = 0; // sweep the voxelisation of the dense volumes of every OM with this many plane wave events per setting, record the fastest in the OM json files, then exit; 0 = off
+G4int           gSolidBenchmarkEvents = 0; // benchmark photon steps per second of the module with boolean and with analytic solids, with this many events per setup, then exit; 0 = off
 
 G4bool          gCADImport = false;
+G4double        gCADDecimation = 0; // edge length (mm) of the vertex clustering that decimates the facets of the CAD meshes, 0 = facets of the file
+G4bool          gCADMergeParts = false; // all parts of a CAD file as one tessellated solid instead of one solid per part
+G4int           gCADMeshCheck = 0; // points at which decimated CAD parts are compared with the original ones, 0 = off
+G4bool          gCADCache = true; // binary caches of the parsed CAD meshes (see OMSimCADMesh), the OBJ files are only parsed when their cache is missing
+G4String        gCADCacheDirectory = "CADmesh_cache"; // directory of the CAD mesh caches, relative to the working (build) directory and created if missing, so the data directory may be read-only; "" = next to the OBJ files
+G4int           gCADBenchmarkEvents = 0; // benchmark photon steps per second of the CAD internals for several decimations, with and without merging, with this many events per setup, then exit; 0 = off
 G4String        gHittype = "individual"; // seems like individual records each hit per pmt
 G4bool          gVisual = true; // may be visualization on?
 G4int           gEnvironment = 1; // I don't know what is it
 G4String        ghitsfilename = "/mnt/c/Users/Waly/bulkice_doumeki/hit.dat";
-G4int           gcounter = 0;
+G4long          gcounter = 0;
+G4long          gBoundarySteps = 0; // optical photon steps ending on a volume boundary (array benchmark)
+G4long          gPhotonTracks = 0; // optical photons tracked (dEGG segment benchmark)
+G4double        gDEGGSegmentDeviation = 0; // set by the dEGG construction: largest distance of the vessel polycones from the tori
 G4String        gQEFile = "/home/waly/bulkice_doumeki/mdom/InputFile/TA0001_HamamatsuQE.data";
+G4String        gTimelineFile = ""; // Chrome trace of initialisation and runs (e.g. "timeline.json"), empty = off
+G4bool          gTimelinePerEvent = false; // also add one span per event to the timeline
+G4double        gCullingK = 0; // kill photons more than k absorption lengths away from every module (e.g. 10), 0 = off
+G4bool          gCullingValidation = false; // only flag photons beyond the horizon and compare hit yields at the end of the run
+G4String        gGeneratorMode = "sntools"; // "sntools": IBD positrons from the sntools files, "acceptance": plane waves for the acceptance table, "proptable": photons for the propagation table, "photoncache": replay of a photon cache, "photonlist": optical photons of a photon list (no charged particles), "analytic": hits of the sntools positrons from the tables, without tracking, "showerbuild": positrons for the shower library, "showerlib": sntools positrons replaced by library showers
+G4String        gAcceptanceTableFile = ""; // acceptance table written in "acceptance" mode and read by the next-event estimator and the fast mode
+G4int           gAcceptancePhotons = 1000; // photons per event (= per table bin) in "acceptance" mode
+G4bool          gAcceptanceAllModules = false; // build the acceptance tables of all modules (gAcceptanceTableFile + "_<module>.dat") and exit
+G4int           gAcceptanceEventsPerBin = 100; // events per beam bin when building tables (about 3000 photons per impact bin with the default binning)
+G4double        gAcceptanceMinPhotons = 1000; // impact bins with fewer photons take the probabilities of their beam bin (merged over the impact bins)
+G4double        gAcceptanceLambdaMin = 300 * nm; // wavelength range of new acceptance tables, stored in the table; photons outside of the range of a table are tracked into the module
+G4double        gAcceptanceLambdaMax = 600 * nm;
+G4bool          gAcceptanceFastMode = false; // kill photons at the module bounding sphere and draw the PMT hits from the acceptance table
+G4double        gAnalyticTrackLength = 5.32 * mm; // "analytic" mode: effective Cherenkov track length of the positron cascade per MeV
+G4int           gAnalyticSamples = 100; // "analytic" mode: emission directions per positron
+G4String        gShowerLibraryFile = ""; // shower library written in "showerbuild" mode and read in "showerlib" mode
+G4int           gShowersPerBin = 10; // showers per energy bin of a new shower library
+G4bool          gNextEventEstimator = false; // score expected hits per PMT at every scattering vertex in the ice
+G4bool          gFastSimulation = false; // transport photons through the bulk ice with the propagation table (fast simulation)
+G4bool          gFastSimValidation = false; // with gFastSimulation: track photons in detail and compare with the table prediction
+G4String        gPropagationTableFile = ""; // propagation table written in "proptable" mode and read by the fast simulation
+G4double        gPropagationInnerRadius = 1 * m; // inner radius of the bulk ice envelope when building a propagation table
+G4int           gPropagationPhotons = 1000; // photons per event (= per table bin) in "proptable" mode
+G4int           gPropagationEventsPerBin = 1; // events per bin when the "analytic" mode builds a missing propagation table
+G4bool          gPhotonCacheRecord = false; // first stage: write photons entering the cache sphere to gPhotonCacheFile and stop them
+G4String        gPhotonCacheFile = ""; // photon cache written with gPhotonCacheRecord and replayed in "photoncache" mode
+G4double        gPhotonCacheRadius = 0; // radius of the cache sphere, 0 = module bounding radius + 1 cm
+G4String        gPhotonListFile = ""; // photon list (or photon cache) injected in "photonlist" mode
+G4int           gPhotonListBatch = 100000; // photons per event in "photonlist" mode
+G4int           gRecyclingFactor = 1; // replay every photon reaching a module K times with random rotations about its axis, 1 = off
+G4bool          gRecyclingMirror = false; // recycled copies are also mirrored at the equator (up-down symmetric modules)
+G4int           gImportanceShells = 0; // importance shells around the modules for photon splitting / Russian roulette, 0 = off
+G4double        gImportanceRadiusRatio = 2; // radius ratio of consecutive importance shells
+G4int           gImportanceSplit = 2; // importance ratio of neighbouring cells (number of copies per shell crossed inwards)
+G4String        gTrackBudgetFile = ""; // json with step/path/TIR budgets per volume (e.g. "../InputFile/TrackBudgets.json"), empty = defaults
 
 //G4String base_name = "/mnt/c/Users/Waly/bulkice_doumeki/" ;
 
@@ -119,6 +203,263 @@ std::vector<G4String> explode(char* cs, char d) {
         return explode(s,d);
 }
 
+/**
+ * Build a table with a run of the detailed simulation in generator mode pMode. The run action writes the table
+ * (gAcceptanceTableFile or gPropagationTableFile), the hits of the run go to <hits file>.<mode>.
+ */
+void BuildTable(G4RunManager* pRunManager, G4String pMode, G4int pEvents)
+{
+    const G4String lMode = gGeneratorMode;
+    const G4String lHitsFile = ghitsfilename;
+    gGeneratorMode = pMode;
+    ghitsfilename = lHitsFile + "." + pMode;
+    OMSimScopedTimer lTimer("Table building (" + pMode + ")", "run");
+    pRunManager->ReinitializeGeometry(true);
+    pRunManager->BeamOn(pEvents);
+    gGeneratorMode = lMode;
+    ghitsfilename = lHitsFile;
+    pRunManager->ReinitializeGeometry(true);
+}
+
+/**
+ * Photon steps per second for module arrays of 1, 2, 4... up to pMaxModules modules, in the current generator mode.
+ * Every array is simulated three times: modules placed directly in the world with border surfaces per PMT placement
+ * (former layout), the same with skin surfaces per PMT type, and in ice envelopes with skin surfaces. The modules are
+ * put on strings of up to 8, gArrayModuleSpacing apart vertically and horizontally. Photon steps ending on a volume
+ * boundary are counted separately: the run time difference between the surface layouts divided by them is the
+ * difference of the boundary process cost per step. Table: <hits file>.benchmark (see OMSimBenchmark).
+ */
+void BenchmarkArrays(G4RunManager* pRunManager, G4int pMaxModules, G4int pEvents)
+{
+    OMSimBenchmark lBenchmark(pRunManager, "benchmark");
+    lBenchmark.Keep(gArrayStrings);
+    lBenchmark.Keep(gArrayModulesPerString);
+    lBenchmark.Keep(gArrayStringSpacing);
+    lBenchmark.Keep(gArrayEnvelopes);
+    lBenchmark.Keep(gPMTBorderSurfaces);
+    gArrayStringSpacing = gArrayModuleSpacing;
+
+    lBenchmark.Table() << "# modules\tstrings\tenvelopes\tborder surfaces\tsurfaces\tsetup [s]\tphoton steps\tboundary steps\trun [s]\tsteps/s" << std::endl;
+    G4cout << "::::::::::::::Array benchmark (" << pEvents << " events per array)::::::::::::" << G4endl;
+    G4cout << "modules\tenvelopes\tborder surfaces\tsetup [s]\tsteps/s" << G4endl;
+    for (G4int lModules = 1; lModules <= pMaxModules; lModules *= 2) {
+        for (G4int lLayout = 0; lLayout < 3; lLayout++) {
+            gArrayModulesPerString = std::min(lModules, 8);
+            gArrayStrings = lModules / gArrayModulesPerString;
+            gArrayEnvelopes = lLayout == 2;
+            gPMTBorderSurfaces = lLayout == 0;
+            const OMSimBenchmark::Result lResult = lBenchmark.TimeSetup(pEvents, "Array benchmark, " + std::to_string(lModules) + " modules"
+                                                                        + (gArrayEnvelopes ? " in envelopes" : "") + (gPMTBorderSurfaces ? " with border surfaces" : ""));
+            const size_t lSurfaces = G4LogicalBorderSurface::GetNumberOfBorderSurfaces() + G4LogicalSkinSurface::GetNumberOfSkinSurfaces();
+            G4cout << lModules << "\t" << gArrayEnvelopes << "\t" << gPMTBorderSurfaces << "\t" << lResult.Setup << "\t" << lResult.GetStepRate() << G4endl;
+            lBenchmark.Table() << lModules << "\t" << gArrayStrings << "\t" << gArrayEnvelopes << "\t" << gPMTBorderSurfaces << "\t" << lSurfaces << "\t"
+                               << lResult.Setup << "\t" << lResult.Steps << "\t" << lResult.BoundarySteps << "\t" << lResult.Run << "\t" << lResult.GetStepRate() << std::endl;
+        }
+    }
+}
+
+/**
+ * Photon steps per second of the module built with the boolean solids and with their replacements: the flat mDOM holder,
+ * the analytic PMT bulbs, the analytic pressure vessels and all of them together, in the current generator mode.
+ * Table: <hits file>.solid_benchmark (see OMSimBenchmark).
+ */
+void BenchmarkSolids(G4RunManager* pRunManager, G4int pEvents)
+{
+    OMSimBenchmark lBenchmark(pRunManager, "solid_benchmark");
+    lBenchmark.Keep(gFlatSupportStructure);
+    lBenchmark.Keep(gAnalyticPMTBulbs);
+    lBenchmark.Keep(gAnalyticVessels);
+
+    const G4String lSetupNames[] = { "boolean", "flat holder", "analytic bulbs", "analytic vessels", "all" };
+    lBenchmark.Table() << "# solids	flat holder	analytic bulbs	analytic vessels	setup [s]	photon steps	run [s]	steps/s" << std::endl;
+    G4cout << "::::::::::::::Solid benchmark (" << pEvents << " events per setup)::::::::::::" << G4endl;
+    G4cout << "solids	setup [s]	steps/s" << G4endl;
+    for (G4int lSetup = 0; lSetup < 5; lSetup++) {
+        gFlatSupportStructure = lSetup == 1 || lSetup == 4;
+        gAnalyticPMTBulbs = lSetup == 2 || lSetup == 4;
+        gAnalyticVessels = lSetup == 3 || lSetup == 4;
+        const OMSimBenchmark::Result lResult = lBenchmark.TimeSetup(pEvents, "Solid benchmark, " + lSetupNames[lSetup] + " solids");
+        G4cout << lSetupNames[lSetup] << "\t" << lResult.Setup << "\t" << lResult.GetStepRate() << G4endl;
+        lBenchmark.Table() << lSetupNames[lSetup] << "\t" << gFlatSupportStructure << "\t" << gAnalyticPMTBulbs << "\t" << gAnalyticVessels << "\t"
+                           << lResult.Setup << "\t" << lResult.Steps << "\t" << lResult.Run << "\t" << lResult.GetStepRate() << std::endl;
+    }
+}
+
+/**
+ * Tessellation of the dEGG vessel: the segment counts of the data file are scaled by 1/4, 1/2, 1, 2 and 4 (at least 2
+ * segments), pEvents events per scale in the current generator mode. The table gives the largest deviation of the
+ * polycones from the tori, the run time per tracked photon and the hit rate (hit weight per tracked photon) with its
+ * statistical error, relative to the finest tessellation. Table: <hits file>.degg_segments (see OMSimBenchmark). The
+ * chosen scale is then set with gDEGGSegmentScale.
+ */
+void BenchmarkDEGGSegments(G4RunManager* pRunManager, G4int pEvents)
+{
+    OMSimBenchmark lBenchmark(pRunManager, "degg_segments");
+    lBenchmark.Keep(gDOM);
+    lBenchmark.Keep(gDEGGSegmentScale);
+    gDOM = 5;
+
+    const G4double lScales[] = { 0.25, 0.5, 1, 2, 4 };
+    const G4int lNrScales = 5;
+    G4double lDeviation[lNrScales];
+    OMSimBenchmark::Result lResults[lNrScales];
+    for (G4int i = 0; i < lNrScales; i++) {
+        gDEGGSegmentScale = lScales[i];
+        lResults[i] = lBenchmark.TimeSetup(pEvents, "dEGG segment benchmark, scale " + std::to_string(lScales[i]));
+        lDeviation[i] = gDEGGSegmentDeviation;
+    }
+
+    // the finest tessellation is the reference for the hit rate
+    const G4double lReferenceRate = lResults[lNrScales - 1].GetHitsPerPhoton();
+    lBenchmark.Table() << "# scale\tdeviation [mm]\tsetup [s]\tphotons\tphoton steps\trun [s]\ttime per photon [us]\thits\thits per photon\trelative hit rate\tstatistical error" << std::endl;
+    G4cout << "::::::::::::::dEGG segment benchmark (" << pEvents << " events per scale)::::::::::::" << G4endl;
+    G4cout << "scale\tdeviation [mm]\ttime per photon [us]\trelative hit rate" << G4endl;
+    for (G4int i = 0; i < lNrScales; i++) {
+        const OMSimBenchmark::Result& lResult = lResults[i];
+        const G4double lRelative = lReferenceRate > 0 ? lResult.GetHitsPerPhoton() / lReferenceRate : 0;
+        const G4double lError = lResult.Hits > 0 ? 1 / std::sqrt(lResult.Hits) : 0;
+        G4cout << lScales[i] << "\t" << lDeviation[i] / mm << "\t" << 1e6 * lResult.GetTimePerPhoton() << "\t" << lRelative << G4endl;
+        lBenchmark.Table() << lScales[i] << "\t" << lDeviation[i] / mm << "\t" << lResult.Setup << "\t" << lResult.Photons << "\t" << lResult.Steps << "\t"
+                           << lResult.Run << "\t" << 1e6 * lResult.GetTimePerPhoton() << "\t" << lResult.Hits << "\t" << lResult.GetHitsPerPhoton() << "\t"
+                           << lRelative << "\t" << lError << std::endl;
+    }
+}
+
+/**
+ * Photon steps per second of the module with the CAD internals (LOM16, LOM18 or dEGG) against their facet count: the
+ * meshes are decimated with gCADDecimation = 0 (file), 0.1, 0.3, 1 and 3 mm, every time with one solid per part and with
+ * merged parts, in the current generator mode. Table: <hits file>.cad_benchmark (see OMSimBenchmark).
+ */
+void BenchmarkCAD(G4RunManager* pRunManager, G4int pEvents)
+{
+    OMSimBenchmark lBenchmark(pRunManager, "cad_benchmark");
+    lBenchmark.Keep(gCADImport);
+    lBenchmark.Keep(gCADDecimation);
+    lBenchmark.Keep(gCADMergeParts);
+    gCADImport = true;
+
+    const G4double lDecimations[] = { 0, 0.1 * mm, 0.3 * mm, 1 * mm, 3 * mm };
+    lBenchmark.Table() << "# decimation [mm]\tmerged\tfacets\tsetup [s]\tphoton steps\trun [s]\tsteps/s" << std::endl;
+    G4cout << "::::::::::::::CAD benchmark (" << pEvents << " events per setup)::::::::::::" << G4endl;
+    G4cout << "decimation [mm]\tmerged\tfacets\tsteps/s" << G4endl;
+    for (G4double lTolerance : lDecimations) {
+        for (G4int lMerge = 0; lMerge < 2; lMerge++) {
+            gCADDecimation = lTolerance;
+            gCADMergeParts = lMerge == 1;
+            const G4long lFacetsBefore = OMSimCADMesh::GetNumberOfFacets();
+            const OMSimBenchmark::Result lResult = lBenchmark.TimeSetup(pEvents, "CAD benchmark, decimation " + std::to_string(lTolerance / mm) + " mm"
+                                                                        + (gCADMergeParts ? ", merged" : ""));
+            const G4long lFacets = OMSimCADMesh::GetNumberOfFacets() - lFacetsBefore;
+            G4cout << lTolerance / mm << "\t" << gCADMergeParts << "\t" << lFacets << "\t" << lResult.GetStepRate() << G4endl;
+            lBenchmark.Table() << lTolerance / mm << "\t" << gCADMergeParts << "\t" << lFacets << "\t" << lResult.Setup << "\t" << lResult.Steps << "\t"
+                               << lResult.Run << "\t" << lResult.GetStepRate() << std::endl;
+        }
+    }
+}
+
+/**
+ * Validation of the levels of detail: all modules are placed at full, simplified and minimal detail (with harness),
+ * pEvents events per level in the current generator mode. The hits per tracked photon of every level are compared with
+ * full detail; a level passes if the relative change is below gDetailTolerance. The statistical error of the change is
+ * given as well, if it is not well below the tolerance, the verdict needs more events. Table:
+ * <hits file>.detail_validation (see OMSimBenchmark).
+ */
+void ValidateDetailLevels(G4RunManager* pRunManager, G4int pEvents)
+{
+    OMSimBenchmark lBenchmark(pRunManager, "detail_validation");
+    lBenchmark.Keep(gPlaceHarness);
+    lBenchmark.Keep(gModuleDetail);
+    lBenchmark.Keep(gDetailedModules);
+    gPlaceHarness = true;
+    gDetailedModules = "";
+
+    const G4String lNames[] = { "minimal", "simplified", "full" };
+    OMSimBenchmark::Result lResults[3];
+    for (G4int lLevel = 2; lLevel >= 0; lLevel--) {
+        gModuleDetail = lLevel;
+        lResults[lLevel] = lBenchmark.TimeSetup(pEvents, "Detail validation, " + lNames[lLevel]);
+    }
+
+    const G4double lReferenceRate = lResults[2].GetHitsPerPhoton();
+    lBenchmark.Table() << "# level	photons	run [s]	time per photon [us]	hits	hits per photon	relative change	statistical error	tolerance	passed" << std::endl;
+    G4cout << "::::::::::::::Validation of the levels of detail (" << pEvents << " events per level, tolerance " << gDetailTolerance << ")::::::::::::" << G4endl;
+    G4cout << "level	time per photon [us]	relative change	statistical error	passed" << G4endl;
+    for (G4int lLevel = 2; lLevel >= 0; lLevel--) {
+        const OMSimBenchmark::Result& lResult = lResults[lLevel];
+        const G4double lChange = lReferenceRate > 0 ? lResult.GetHitsPerPhoton() / lReferenceRate - 1 : 0;
+        // independent runs: the errors of both rates add up, none for the reference itself
+        const G4double lError = (lLevel < 2 && lResult.Hits > 0 && lResults[2].Hits > 0) ? std::sqrt(1 / lResult.Hits + 1 / lResults[2].Hits) : 0;
+        const G4bool lPassed = std::fabs(lChange) < gDetailTolerance;
+        G4cout << lNames[lLevel] << "\t" << 1e6 * lResult.GetTimePerPhoton() << "\t" << lChange << "\t" << lError << "\t" << lPassed << G4endl;
+        lBenchmark.Table() << lNames[lLevel] << "\t" << lResult.Photons << "\t" << lResult.Run << "\t" << 1e6 * lResult.GetTimePerPhoton() << "\t" << lResult.Hits
+                           << "\t" << lResult.GetHitsPerPhoton() << "\t" << lChange << "\t" << lError << "\t" << gDetailTolerance << "\t" << lPassed << std::endl;
+        if (!lPassed) warning("The %s level changes the hit rate by more than the tolerance", lNames[lLevel].c_str());
+        if (lError > 0.5 * gDetailTolerance) warning("The statistical error of the %s level is not small against the tolerance, simulate more events", lNames[lLevel].c_str());
+    }
+}
+
+/**
+ * Tuning of the voxelisation of the modules with json file (mDOM, LOM16, LOM18, dEGG). Every module is built with its
+ * current settings, then the logical volumes with at least 16 daughters (gel of the mDOM, inner volumes of the LOMs...) are
+ * tuned one after the other: smartless 0.5, 1, 2 (Geant4 default), 4, 8 and 16 and no voxelisation at all are tried, the
+ * geometry is reoptimised and pEvents events of the plane waves of the "acceptance" mode (a fixed sequence of beam
+ * directions and wavelengths) are simulated. The fastest setting (photon steps per second) is kept if it beats the
+ * current one by more than 2 %, the noise of such short runs. The results are recorded in the json file of the module
+ * (OMSimVoxelTuning::Record). Table of all trials: <hits file>.voxel_tuning (see OMSimBenchmark).
+ */
+void TuneVoxels(G4RunManager* pRunManager, G4int pEvents)
+{
+    const G4String lAcceptanceFile = ghitsfilename + ".voxel_tuning_acceptance";
+    OMSimBenchmark lBenchmark(pRunManager, "voxel_tuning");
+    lBenchmark.Keep(gDOM);
+    lBenchmark.Keep(gVoxelTuning);
+    lBenchmark.Keep(gGeneratorMode);
+    lBenchmark.Keep(gAcceptanceTableFile);
+    gAcceptanceTableFile = lAcceptanceFile;
+    gGeneratorMode = "acceptance";
+    gVoxelTuning = true;
+
+    const G4int lMinDaughters = 16;
+    const G4double lMargin = 0.02;
+    const G4double lSmartless[] = { 0.5, 1, 2, 4, 8, 16 };
+
+    lBenchmark.Table() << "# module\tvolume\tdaughters\tsmartless\toptimise\tsteps/s\tbest" << std::endl;
+    G4cout << "::::::::::::::Voxel tuning (" << pEvents << " events per setting)::::::::::::" << G4endl;
+    G4cout << "module\tvolume\tsmartless\toptimise\tsteps/s" << G4endl;
+    for (const G4int lModule : { 1, 3, 4, 5 }) {
+        gDOM = lModule;
+        OMSimAcceptanceTable::GetInstance()->Clear();
+        lBenchmark.TimeSetup(0);
+        const G4String lKey = OMSimVoxelTuning::GetModuleKey();
+        OMSimScopedTimer lTimer("Voxel tuning, " + lKey, "run");
+
+        std::vector<std::pair<G4String, OMSimVoxelTuning::Setting>> lSettings;
+        for (G4LogicalVolume* lVolume : OMSimVoxelTuning::GetDenseVolumes(lMinDaughters)) {
+            OMSimVoxelTuning::Setting lBest = OMSimVoxelTuning::Get(lVolume);
+            G4double lBestRate = lBenchmark.TimeSetup(pEvents, "", false).GetStepRate();
+            std::vector<OMSimVoxelTuning::Setting> lCandidates;
+            for (G4double lValue : lSmartless) lCandidates.push_back({ lValue, true });
+            lCandidates.push_back({ lBest.Smartless, false });
+            for (const auto& lCandidate : lCandidates) {
+                OMSimVoxelTuning::Set(lVolume, lCandidate);
+                const G4double lRate = lBenchmark.TimeSetup(pEvents, "", false).GetStepRate();
+                G4cout << lKey << "\t" << lVolume->GetName() << "\t" << lCandidate.Smartless << "\t" << lCandidate.Optimise << "\t" << lRate << G4endl;
+                lBenchmark.Table() << lKey << "\t" << lVolume->GetName() << "\t" << lVolume->GetNoDaughters() << "\t" << lCandidate.Smartless << "\t"
+                                   << lCandidate.Optimise << "\t" << lRate << "\t" << (lRate > (1 + lMargin) * lBestRate) << std::endl;
+                if (lRate > (1 + lMargin) * lBestRate) {
+                    lBest = lCandidate;
+                    lBestRate = lRate;
+                }
+            }
+            OMSimVoxelTuning::Set(lVolume, lBest);
+            lSettings.push_back({ lVolume->GetName(), lBest });
+            G4cout << lKey << "\t" << lVolume->GetName() << ": smartless " << lBest.Smartless << (lBest.Optimise ? "" : ", not voxelised") << G4endl;
+        }
+        if (!lSettings.empty()) OMSimVoxelTuning::Record(lSettings);
+    }
+    OMSimAcceptanceTable::GetInstance()->Clear();
+}
+
 int main(int argc, char** argv)
 {
     G4String macroname;
@@ -128,14 +469,30 @@ int main(int argc, char** argv)
         macroname = G4String(argv[1]);
     }
 
-    G4RunManager* runmanager = new G4RunManager();
+    if (gTimelineFile != "") OMSimTimeline::GetInstance()->Open(gTimelineFile);
+
+    OMSimRunManager* runmanager = new OMSimRunManager();
 
     //OMSimDetectorConstruction* detector = new OMSimDetectorConstruction();
     //Generating Physics List
-    G4VModularPhysicsList* physicsList = new FTFP_BERT;
-    physicsList->ReplacePhysics(new G4EmStandardPhysics_option4());
+    G4VModularPhysicsList* physicsList;
+    if (gGeneratorMode == "photonlist") {
+        // only optical photons are injected: no hadronic physics, whose tables dominate the initialisation
+        physicsList = new G4VModularPhysicsList();
+        physicsList->RegisterPhysics(new G4EmStandardPhysics_option4());
+    }
+    else {
+        physicsList = new FTFP_BERT;
+        physicsList->ReplacePhysics(new G4EmStandardPhysics_option4());
+    }
     G4OpticalPhysics* opticalPhysics = new G4OpticalPhysics();
     physicsList->RegisterPhysics(opticalPhysics);
+    if (gFastSimulation) {
+        // photon transport through the bulk ice envelope with OMSimIceFastModel
+        G4FastSimulationPhysics* fastSimulationPhysics = new G4FastSimulationPhysics();
+        fastSimulationPhysics->ActivateFastSimulation("opticalphoton");
+        physicsList->RegisterPhysics(fastSimulationPhysics);
+    }
 
     runmanager -> SetUserInitialization(new OMSimDetectorConstruction);
     runmanager -> SetUserInitialization(physicsList);
@@ -145,12 +502,16 @@ int main(int argc, char** argv)
     runmanager -> SetUserAction(new OMSimRunAction);
     runmanager -> SetUserAction(new OMSimSteppingAction);
     runmanager -> SetUserAction(new OMSimTrackingAction);
+    runmanager -> SetUserAction(new OMSimStackingAction);
 
     #ifdef G4VIS_USE
   // initialize visualization package
     G4VisManager* vismanager = new G4VisExecutive();
   //G4VisManager* visManager= new J4VisManager;
-    vismanager -> Initialize();
+    {
+        OMSimScopedTimer lTimer("Vis manager initialisation");
+        vismanager -> Initialize();
+    }
     std::cerr << " ------------------------------- " << std::endl
          << " ---- VisManager created! ---- " << std::endl
          << " ------------------------------- " << std::endl;
@@ -160,18 +521,72 @@ int main(int argc, char** argv)
     std::cerr << "about to initialize runManager" << std::endl;
     /*OMSimPMTQE* pmt_qe = new OMSimPMTQE();
     pmt_qe -> ReadQeTable();*/
-    runmanager-> Initialize();
+    {
+        OMSimScopedTimer lTimer("G4RunManager::Initialize");
+        runmanager-> Initialize();
+    }
     std::cerr << "initialize runManager succeed" << std::endl;
 
+    if ( gGeneratorMode == "analytic" ) {
+    // tables of the ice and of the module that is built, made with the detailed simulation if they do not exist yet
+        if ( !std::ifstream(gPropagationTableFile.c_str()).good() ) {
+            G4cout << "::::::::::::::Building propagation table " << gPropagationTableFile << "::::::::::::" << G4endl;
+            BuildTable(runmanager, "proptable", OMSimPropagationTable::GetDefaultNumberOfBins() * gPropagationEventsPerBin);
+        }
+        OMSimAcceptanceTable* lAcceptance = OMSimAcceptanceTable::GetInstance();
+        if ( !std::ifstream(gAcceptanceTableFile.c_str()).good() || !lAcceptance->Load(gAcceptanceTableFile) ) {
+            G4cout << "::::::::::::::Building acceptance table " << gAcceptanceTableFile << "::::::::::::" << G4endl;
+            lAcceptance->Clear();
+            BuildTable(runmanager, "acceptance", OMSimAcceptanceTable::GetDefaultNumberOfBeamBins() * gAcceptanceEventsPerBin);
+        }
+    }
+
     G4UImanager* UImanager = G4UImanager::GetUIpointer();
 
     G4UIExecutive* ui = 0;
 
-    if ( argc!=1 ) {
+    if ( gArrayBenchmarkModules > 0 ) {
+    // navigation performance of module arrays, with and without envelopes
+        BenchmarkArrays(runmanager, gArrayBenchmarkModules, gArrayBenchmarkEvents);
+    }
+    else if ( gDEGGSegmentBenchmarkEvents > 0 ) {
+    // tessellation of the dEGG vessel: navigation time against deviation and hit rate
+        BenchmarkDEGGSegments(runmanager, gDEGGSegmentBenchmarkEvents);
+    }
+    else if ( gCADBenchmarkEvents > 0 ) {
+    // navigation performance of the CAD internals against their facet count
+        BenchmarkCAD(runmanager, gCADBenchmarkEvents);
+    }
+    else if ( gVoxelTuningEvents > 0 ) {
+    // smartless / voxelisation of the dense module volumes, recorded in the OM json files
+        TuneVoxels(runmanager, gVoxelTuningEvents);
+    }
+    else if ( gDetailValidationEvents > 0 ) {
+    // hit rates of the simplified levels of detail against full detail
+        ValidateDetailLevels(runmanager, gDetailValidationEvents);
+    }
+    else if ( gSolidBenchmarkEvents > 0 ) {
+    // navigation performance of the boolean solids and of their analytic / flat replacements
+        BenchmarkSolids(runmanager, gSolidBenchmarkEvents);
+    }
+    else if ( gAcceptanceAllModules ) {
+    // acceptance tables of all modules, one run per module with the detailed simulation
+        const G4String lBaseName = gAcceptanceTableFile;
+        const G4String lModuleNames[] = { "", "mDOM", "pDOM", "LOM16", "LOM18", "dEGG" };
+        for (gDOM = 1; gDOM <= 5; gDOM++) {
+            gAcceptanceTableFile = lBaseName + "_" + lModuleNames[gDOM] + ".dat";
+            G4cout << "::::::::::::::Building acceptance table of " << lModuleNames[gDOM] << "::::::::::::" << G4endl;
+            OMSimAcceptanceTable::GetInstance()->Clear();
+            BuildTable(runmanager, "acceptance", OMSimAcceptanceTable::GetDefaultNumberOfBeamBins() * gAcceptanceEventsPerBin);
+        }
+        gAcceptanceTableFile = lBaseName;
+    }
+    else if ( argc!=1 ) {
     // batch mode
         std::cerr << ":::::::::::::::::::Batch Mode Called:::::::::::::::::" << std::endl;
         G4String command = "/control/execute " + macroname;
         std::cout << "command " << command << std::endl;
+        OMSimScopedTimer lTimer("Macro " + macroname, "run");
         UImanager->ApplyCommand(command);
         }
     else {
@@ -191,6 +606,10 @@ int main(int argc, char** argv)
   // terminating...
   //-----------------------
 
+    OMSimTimeline::GetInstance()->Close();
+    OMSimPhotonCache::GetInstance()->Close();
+    OMSimPhotonList::GetInstance()->Close();
+
     #ifdef G4VIS_USE
     delete vismanager;
     #endif
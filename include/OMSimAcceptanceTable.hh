@@ -0,0 +1,105 @@
+/** @file OMSimAcceptanceTable.hh
+ *  @brief Detection probability of each PMT for photons arriving at the module bounding sphere.
+ *
+ *  @date October 2026
+ *
+ *  @version Geant4 10.7
+ */
+
+#ifndef OMSimAcceptanceTable_h
+#define OMSimAcceptanceTable_h 1
+
+#include "G4String.hh"
+#include "G4ThreeVector.hh"
+#include "G4Types.hh"
+
+#include <cstdint>
+#include <vector>
+
+class G4Track;
+
+/**
+ * @class OMSimAcceptanceTable
+ * @brief Tabulated response of the module to a plane wave.
+ *
+ * Beam bins are the direction of travel of the photons in the module frame (cos(theta), phi) and the wavelength.
+ * Each beam bin is divided in impact bins, the position where the photon line crosses the disk through the module
+ * center perpendicular to the beam: b = distance from the center / R (bins of equal area) and the angle psi in that
+ * disk (see DiskBasis()). For every bin the table holds the number of photons fired at the bounding sphere and the
+ * number of hits per PMT (quantum efficiency included). GetProbability() is the detection probability of a photon
+ * arriving at the bounding sphere; without impact bin it is averaged over a uniform illumination of the disk, so
+ * pi*R^2 times it is the effective area. Impact bins with fewer than gAcceptanceMinPhotons photons use the average of
+ * their beam bin.
+ *
+ * Tables are built by the "acceptance" generator mode (gGeneratorMode): event i fires gAcceptancePhotons photons of
+ * beam bin i % GetNumberOfBeamBins() from a disk of radius R in front of the module, the stepping action adds the
+ * hits, and the table is written to gAcceptanceTableFile at the end of the run. The wavelength range of new tables is
+ * gAcceptanceLambdaMin - gAcceptanceLambdaMax; it is stored in the table header and FindBin() returns -1 outside of it.
+ * Tables carry a hash of the geometry parameters they were built with (module, globals and json parameter files) and
+ * are refused for other geometries.
+ */
+class OMSimAcceptanceTable
+{
+public:
+    static OMSimAcceptanceTable* GetInstance();
+
+    void SetBinning(G4int pNrCosTheta, G4int pNrPhi, G4int pNrLambda, G4double pLambdaMin, G4double pLambdaMax,
+                    G4int pNrB, G4int pNrPsi, G4int pNrPMTs, G4double pRadius);
+    void SetDefaultBinning(G4int pNrPMTs, G4double pRadius);
+    static G4int GetDefaultNumberOfBeamBins();
+    void Clear();
+    G4bool Load(G4String pFileName);
+    void Save(G4String pFileName);
+    G4bool IsLoaded() { return mLoaded; }
+
+    void SetGeometryHash(uint64_t pHash);
+    static uint64_t Hash(const std::string& pText);
+
+    G4int GetNumberOfBeamBins() { return mNrCosTheta * mNrPhi * mNrLambda; }
+    G4int GetNumberOfImpactBins() { return mNrB * mNrPsi; }
+    G4int GetNumberOfPMTs() { return mNrPMTs; }
+    G4double GetRadius() { return mRadius; }
+    G4double GetLambdaMin() { return mLambdaMin; }
+    G4double GetLambdaMax() { return mLambdaMax; }
+    G4int FindBin(const G4ThreeVector& pDirection, G4double pLambda);
+    G4int FindImpactBin(const G4ThreeVector& pDirection, const G4ThreeVector& pFromCenter);
+    static void DiskBasis(const G4ThreeVector& pDirection, G4ThreeVector& pE1, G4ThreeVector& pE2);
+    void SampleBin(G4int pBin, G4ThreeVector& pDirection, G4double& pLambda);
+    G4double GetProbability(G4int pBin, G4int pPMT);
+    G4double GetProbability(G4int pBin, G4int pImpactBin, G4int pPMT);
+    G4double GetDetectionProbability(G4int pBin, G4int pImpactBin);
+    G4int SamplePMT(G4int pBin, G4int pImpactBin);
+    G4int SampleDetectingPMT(G4int pBin, G4int pImpactBin);
+
+    // building
+    void SetCurrentBin(G4int pBin) { mCurrentBin = pBin; }
+    void AddPhoton(G4int pBin, G4int pImpactBin);
+    void AddHit(const G4Track* pTrack, G4int pPMT, G4ThreeVector pCenter);
+
+private:
+    OMSimAcceptanceTable() {}
+    G4int UpdateProbabilities();
+
+    G4int mNrCosTheta = 0;
+    G4int mNrPhi = 0;
+    G4int mNrLambda = 0;
+    G4double mLambdaMin = 0;
+    G4double mLambdaMax = 0;
+    G4int mNrB = 1;
+    G4int mNrPsi = 1;
+    G4int mNrPMTs = 0;
+    G4double mRadius = 0;
+
+    std::vector<G4double> mPhotons;       // per beam and impact bin
+    std::vector<G4double> mHits;          // per beam bin, impact bin and PMT
+    std::vector<G4double> mProbabilities; // per beam bin, impact bin and PMT
+    std::vector<G4double> mAveraged;      // per beam bin and PMT, averaged over the impact bins
+    std::vector<G4double> mDetection;     // per beam and impact bin, summed over the PMTs
+    G4bool mLoaded = false;
+    G4int mCurrentBin = -1;
+    uint64_t mGeometryHash = 0; // of the geometry that is built
+    uint64_t mTableHash = 0;    // of the geometry the table was built with
+};
+
+#endif
+//
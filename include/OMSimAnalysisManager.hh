@@ -8,6 +8,8 @@
 #include <vector>
 #include <fstream>
 
+class G4Track;
+
 class OMSimAnalysisManager
 {
 	public:
@@ -17,6 +19,10 @@ class OMSimAnalysisManager
 		void Reset();
 		void Write();
 		void WriteAccept();
+		G4int GetNumberOfPMTs();
+		void AddHit(G4int pPMT, G4int pModule, const G4Track* pTrack, G4ThreeVector pPosition, G4double pTime);
+		void AddHit(G4int pPMT, G4int pModule, G4double pWeight, G4ThreeVector pPosition, G4ThreeVector pDirection, G4double pTime, G4double pFlightTime,
+		            G4double pTrackLength, G4double pEnergy, G4ThreeVector pVertex, G4int pAncestorID);
 		void Debug() { std::cerr << "OMSimAnalysisManager is alive" << std::endl; }
 
 		// run quantities
@@ -29,11 +35,16 @@ class OMSimAnalysisManager
 		std::vector<G4double>	stats_photon_track_length;
 		std::vector<G4double>	stats_photon_energy;
 		std::vector<G4int>	stats_PMT_hit;
+		std::vector<G4int>	stats_module_id; // module of the hit PMT (index in OMSimModuleBounds)
 		std::vector<G4ThreeVector>	stats_photon_direction;
 		std::vector<G4ThreeVector>	stats_photon_position;
 		std::vector<G4ThreeVector> stats_vertex_position;
 		std::vector<G4double>	stats_event_distance;
 		std::vector<G4int> stats_positron_id;
+		std::vector<G4double> stats_weight; // statistical weight of the photon (importance biasing), 1 otherwise
+		G4bool weighted = false; // write the weights (individual) or sum them instead of counting hits (collective)
+		G4int modules = 1; // number of placed modules, the module IDs are written if there are several
+		G4double total_hit_weight = 0; // summed weight of all hits since the start of the program, not cleared by Reset (benchmarks)
 
 
 
@@ -0,0 +1,89 @@
+/** @file OMSimAnalyticHits.hh
+ *  @brief Expected hits per PMT of IBD positrons from tabulated light yield, ice propagation and module acceptance.
+ *
+ *  @date October 2026
+ *
+ *  @version Geant4 10.7
+ */
+
+#ifndef OMSimAnalyticHits_h
+#define OMSimAnalyticHits_h 1
+
+#include "G4MaterialPropertyVector.hh"
+#include "G4ThreeVector.hh"
+#include "G4Types.hh"
+
+#include <vector>
+
+/**
+ * @class OMSimAnalyticHits
+ * @brief Hits of the "analytic" generator mode, computed without tracking a single particle.
+ *
+ * For each positron of the sntools files:
+ * - the Cherenkov yield is the Frank-Tamm spectrum of the ice (RINDEX of the world material) times the effective
+ *   track length of the electromagnetic cascade, gAnalyticTrackLength per MeV of kinetic energy; all light is
+ *   emitted at the positron vertex,
+ * - gAnalyticSamples emission directions are drawn from the angular distribution of electromagnetic cascades around
+ *   the positron direction (Raedel & Wiebusch 2012) and wavelengths from the Frank-Tamm spectrum, each carrying an
+ *   equal share of the yield,
+ * - photons starting outside the inner sphere of the propagation table (OMSimPropagationTable) reach it with the
+ *   tabulated probability; every stored arrival of the bin is followed in a straight line to the module bounding
+ *   sphere. Photons starting inside go straight to the module. Straight paths are attenuated with the absorption
+ *   and scattering lengths of the ice (scattered photons are lost there),
+ * - the acceptance table (OMSimAcceptanceTable) gives the detection probability of the arrival on the bounding sphere.
+ *
+ * With a module array, this is done for every module, each treated as if it were alone.
+ *
+ * The sum of all contributions is the expected number of hits of the positron. The number of hits is Poisson
+ * distributed around it, each hit takes the time, position and PMT of a contribution drawn with its weight. Hits are
+ * stored in gAnalysisManager like detected photons; the expected hits per PMT of the run go to <hits file>.expected.
+ */
+class OMSimAnalyticHits
+{
+public:
+    static OMSimAnalyticHits* GetInstance();
+
+    void AddPositron(G4ThreeVector pPosition, G4ThreeVector pDirection, G4double pEnergy, G4double pTime, G4int pID);
+    void PrintSummary();
+    void Reset();
+
+private:
+    OMSimAnalyticHits() {}
+    G4bool Initialise();
+    G4double SampleWavelength();
+    G4double SampleCosTheta(G4double pLambda);
+    void AddModule(G4int pModule, G4ThreeVector pPosition, G4ThreeVector pAxis, G4double pShare);
+    void AddStraightPath(G4int pModule, G4ThreeVector pFromCenter, G4ThreeVector pDirection, G4double pLambda, G4double pExpected, G4double pTime);
+
+    struct Contribution
+    {
+        G4int Module;
+        G4int Bin;
+        G4int ImpactBin;
+        G4double Expected;
+        G4double Time; // arrival on the bounding sphere, relative to the emission
+        G4double Lambda;
+        G4ThreeVector Position; // on the bounding sphere, relative to the module center
+        G4ThreeVector Direction;
+    };
+
+    G4bool mInitialised = false;
+    G4bool mActive = false;
+    G4MaterialPropertyVector* mRefractiveIndex = nullptr;
+    G4MaterialPropertyVector* mAbsorptionLength = nullptr;
+    G4MaterialPropertyVector* mScatteringLength = nullptr;
+    G4double mModuleRadius = 0;
+    G4double mYieldPerLength = 0;     // Cherenkov photons per unit track length in the wavelength range of the tables
+    std::vector<G4double> mLambda;    // wavelength grid of the Frank-Tamm spectrum
+    std::vector<G4double> mCumulative; // normalised cumulative spectrum on mLambda
+
+    std::vector<Contribution> mContributions; // of the current positron
+    std::vector<G4double> mExpectedBins;      // expected hits of the run per beam and impact bin of the acceptance table
+    std::vector<G4long> mSampled;             // hits of the run per PMT
+    G4double mExpected = 0;
+    G4long mHits = 0;
+    G4long mPositrons = 0;
+};
+
+#endif
+//
@@ -0,0 +1,69 @@
+/** @file OMSimBenchmark.hh
+ *  @brief Timing of simulation setups, shared by the benchmark and tuning drivers of the main.
+ *
+ *  @date October 2026
+ *
+ *  @version Geant4 10.7
+ */
+
+#ifndef OMSimBenchmark_h
+#define OMSimBenchmark_h 1
+
+#include "G4String.hh"
+#include "G4Types.hh"
+
+#include <fstream>
+#include <functional>
+#include <vector>
+
+class G4RunManager;
+
+/**
+ * @class OMSimBenchmark
+ * @brief Runs the setups of one benchmark and restores the globals afterwards.
+ *
+ * A driver keeps the globals it changes (Keep()), sets up one variant after the other and measures it with TimeSetup():
+ * the geometry is built and closed (voxelisation) by an empty run, then the events are simulated in the current
+ * generator mode. While the benchmark exists, the hits go to <hits file>.benchmark_hits and its table to
+ * <hits file>.<table name>. At destruction the globals are restored and the geometry is built again.
+ */
+class OMSimBenchmark
+{
+public:
+    struct Result
+    {
+        G4double Setup;       // s, building and closing of the geometry
+        G4double Run;         // s, simulation of the events
+        G4long Steps;         // optical photon steps
+        G4long BoundarySteps; // optical photon steps ending on a volume boundary
+        G4long Photons;       // optical photons tracked
+        G4double Hits;        // summed hit weight
+        G4double GetStepRate() const { return Run > 0 ? Steps / Run : 0; }
+        G4double GetTimePerPhoton() const { return Photons > 0 ? Run / Photons : 0; }
+        G4double GetHitsPerPhoton() const { return Photons > 0 ? Hits / Photons : 0; }
+    };
+
+    OMSimBenchmark(G4RunManager* pRunManager, G4String pTableName);
+    ~OMSimBenchmark();
+
+    /**
+     * Restore pGlobal to its current value when the benchmark ends.
+     */
+    template <class T>
+    void Keep(T& pGlobal)
+    {
+        const T lValue = pGlobal;
+        mRestore.push_back([&pGlobal, lValue]() { pGlobal = lValue; });
+    }
+
+    Result TimeSetup(G4int pEvents, G4String pName = "", G4bool pRebuild = true);
+    std::ofstream& Table() { return mTable; }
+
+private:
+    G4RunManager* mRunManager;
+    std::ofstream mTable;
+    std::vector<std::function<void()>> mRestore;
+};
+
+#endif
+//
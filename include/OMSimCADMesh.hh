@@ -0,0 +1,65 @@
+/** @file OMSimCADMesh.hh
+ *  @brief Import of CAD meshes (with a binary cache) and preprocessing of their tessellated solids: decimation, merging and checks.
+ *
+ *  @date October 2026
+ *
+ *  @version Geant4 10.7
+ */
+
+#ifndef OMSimCADMesh_h
+#define OMSimCADMesh_h 1
+
+#include "G4String.hh"
+#include "G4Types.hh"
+#include "G4ThreeVector.hh"
+
+#include <array>
+#include <vector>
+
+class G4VSolid;
+class G4TessellatedSolid;
+
+/**
+ * @class OMSimCADMesh
+ * @brief Turns the parts of a CAD file (one G4TessellatedSolid per part, as given by CADMesh) into the solids that are placed.
+ *
+ * With gCADDecimation > 0 the facets are decimated by vertex clustering: vertices in the same cube of that edge length
+ * are replaced by their mean, facets that collapse (two corners in one cube) or that become duplicates are dropped.
+ * The surface moves by less than the cube diagonal; a decimated part with open edges is replaced by the original part.
+ * With gCADMergeParts all parts of a file become one solid, so the mother volume has one daughter instead of dozens;
+ * parts with open edges or overlapping parts are not merged. Every resulting solid is checked: open edges (edges not
+ * shared by exactly two facets) and the voxelisation of G4TessellatedSolid, without which every query loops over all facets.
+ * gCADMeshCheck > 0 compares decimated parts with the original ones (OMSimSolidCheck).
+ *
+ * Load() replaces CADMesh::TessellatedMesh::FromOBJ. The text OBJ file is parsed by CADMesh only once: the parts (with
+ * offset and scale applied) are written to a binary cache in gCADCacheDirectory (below the working directory by
+ * default, not in the data directory), named after a hash of the OBJ file content, the offset and the scale. Later
+ * startups map the cache and build the solids from its vertex and triangle arrays directly.
+ * Cache format: "OMSIMCM1", number of parts (uint32), then per part the length of the name (uint32), the name, the
+ * numbers of vertices and triangles (uint32), the vertices (3 doubles each) and the triangles (3 uint32 vertex indices).
+ */
+class OMSimCADMesh
+{
+public:
+    static std::vector<G4VSolid*> Load(G4String pFileName, G4ThreeVector pOffset = G4ThreeVector(), G4double pScale = 1);
+    static std::vector<G4VSolid*> Process(const std::vector<G4VSolid*>& pParts, G4String pName);
+    static G4long GetNumberOfFacets() { return mFacets; }
+
+private:
+    typedef std::array<G4ThreeVector, 3> Triangle;
+
+    static std::vector<Triangle> GetTriangles(const G4TessellatedSolid* pSolid);
+    static std::vector<Triangle> Decimate(const std::vector<Triangle>& pTriangles, G4double pTolerance);
+    static G4TessellatedSolid* Build(const std::vector<Triangle>& pTriangles, G4String pName);
+    static G4int CountOpenEdges(const std::vector<Triangle>& pTriangles);
+    static G4bool Overlap(const std::vector<G4TessellatedSolid*>& pSolids, const std::vector<std::vector<Triangle>>& pTriangles);
+    static G4bool Verify(G4TessellatedSolid* pSolid, const std::vector<Triangle>& pTriangles);
+    static G4String CacheFileName(G4String pFileName, G4ThreeVector pOffset, G4double pScale);
+    static G4bool ReadCache(G4String pCacheFile, std::vector<G4VSolid*>& pParts);
+    static void WriteCache(G4String pCacheFile, const std::vector<G4VSolid*>& pParts);
+
+    static G4long mFacets; // facets of all processed solids since the start (CAD benchmark)
+};
+
+#endif
+//
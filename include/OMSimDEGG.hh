@@ -16,6 +16,7 @@ public:
     dEGG(OMSimInputData* pData,G4bool pPlaceHarness=true);
     G4double mOut_sphere_r_max;
     void Construction();
+    G4String GetDataKey() { return mDataKey; }
 private:
     OMSimPMTConstruction *mPMTManager;
     dEGGHarness* mHarness;
@@ -64,11 +65,13 @@ private:
     G4double mHVBoardPosition;
     G4double mGelOffset;
     G4String mDataKey = "om_DEGG";
+    G4double mSegmentDeviation = 0; // largest distance of the vessel polycones from the torus surfaces they approximate
     
     void GetSharedData();
     void PlaceGel();
     void PlacePMT();
     void PlaceCADSupportStructure(G4LogicalVolume* lInnerVolumeLogical);
+    G4double ChordDeviation(G4double pRadius, G4double pZMax, G4double pStep, G4int pChords);
     
     G4LogicalVolume* lgelsolid;
     G4LogicalVolume* lgelsolid1;
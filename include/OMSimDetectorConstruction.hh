@@ -13,6 +13,8 @@
 #include "OMSimInputData.hh"
 #include "OMSimPMTConstruction.hh"
 
+class abcDetectorComponent;
+
 class OMSimDetectorConstruction : public G4VUserDetectorConstruction
 {
 public:
@@ -27,6 +29,9 @@ private:
     G4VPhysicalVolume *mWorldPhysical;
     void ConstructWorld();
     void ConstructWorldMat();
+    void PlaceModuleArray(abcDetectorComponent* pModule);
+    void ConstructBulkIceEnvelope();
+    G4String GetGeometryFingerprint();
     OMSimInputData *mData;
     OMSimPMTConstruction* mPMTManager;
 
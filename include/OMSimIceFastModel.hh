@@ -0,0 +1,72 @@
+/** @file OMSimIceFastModel.hh
+ *  @brief Fast simulation of the photon transport through the bulk ice with propagation tables.
+ *
+ *  @date October 2026
+ *
+ *  @version Geant4 10.7
+ */
+
+#ifndef OMSimIceFastModel_h
+#define OMSimIceFastModel_h 1
+
+#include "G4VFastSimulationModel.hh"
+#include "G4ThreeVector.hh"
+
+#include <vector>
+
+class G4Step;
+class OMSimPropagationTable;
+
+/**
+ * @class OMSimIceFastModel
+ * @brief Replaces the step-by-step tracking of optical photons in the bulk-ice envelope.
+ *
+ * The envelope ("BulkIce" region) is a spherical ice shell around the module, with inner radius
+ * gPropagationInnerRadius; the module and the ice inside the shell are tracked in detail. A photon in the shell
+ * either reaches the inner sphere or is lost, with the probability of the propagation table (OMSimPropagationTable).
+ * Arriving photons are moved onto the inner sphere with a time, position and direction sampled from the table and
+ * continue with detailed tracking; the others are killed.
+ *
+ * With gFastSimValidation the photons are not touched: for every photon entering the shell the table prediction is
+ * histogrammed, the full tracking continues and the real arrivals on the inner sphere are histogrammed as well. Both
+ * are compared at the end of the run and written to <hits file>.fastsim_validation.
+ */
+class OMSimIceFastModel : public G4VFastSimulationModel
+{
+public:
+    OMSimIceFastModel(G4String pName, G4Region* pEnvelope, G4ThreeVector pCenter);
+    ~OMSimIceFastModel() {}
+
+    G4bool IsApplicable(const G4ParticleDefinition& pParticle) override;
+    G4bool ModelTrigger(const G4FastTrack& pFastTrack) override;
+    void DoIt(const G4FastTrack& pFastTrack, G4FastStep& pFastStep) override;
+
+    static OMSimIceFastModel* GetInstance() { return mInstance; }
+    static G4bool IsInnerSphereArrival(const G4Step* pStep);
+    void RecordValidationArrival(const G4Step* pStep);
+    void PrintValidation();
+    void Reset();
+
+private:
+    struct Histogram
+    {
+        std::vector<G4double> Predicted;
+        std::vector<G4double> Tracked;
+    };
+    void FillValidation(Histogram& pHistogram, G4double pValue, G4double pMin, G4double pMax, G4double pWeight, G4bool pPredicted);
+
+    static OMSimIceFastModel* mInstance;
+    OMSimPropagationTable* mTable;
+    G4ThreeVector mCenter;
+    G4double mInnerRadius;
+    G4bool mValidation;
+
+    Histogram mDelay;      // arrival delay, 0-2000 ns
+    Histogram mArrivalCos; // cosine between arrival direction and inward normal
+    G4double mPredictedArrivals = 0;
+    G4double mTrackedArrivals = 0;
+    G4long mPhotons = 0;
+};
+
+#endif
+//
@@ -0,0 +1,55 @@
+/** @file OMSimImportanceBiasing.hh
+ *  @brief Splitting and Russian roulette of optical photons on concentric importance shells around the modules.
+ *
+ *  @date October 2026
+ *
+ *  @version Geant4 10.7
+ */
+
+#ifndef OMSimImportanceBiasing_h
+#define OMSimImportanceBiasing_h 1
+
+#include "G4ThreeVector.hh"
+#include "G4TrackVector.hh"
+#include "G4Types.hh"
+
+class G4Step;
+class G4Track;
+
+/**
+ * @class OMSimImportanceBiasing
+ * @brief Geometry importance biasing for optical photons in the ice.
+ *
+ * gImportanceShells spheres with radii R * gImportanceRadiusRatio^i (i = 1...N, R = module bounding radius) are laid
+ * around the closest module. A cell between two shells has an importance gImportanceSplit times larger than the next
+ * cell outwards. After every step in the bulk ice the cells of the pre- and post-step points are compared:
+ * - moving inwards by n cells, the photon is split into gImportanceSplit^n copies sharing its weight,
+ * - moving outwards by n cells, it survives with probability gImportanceSplit^-n and its weight is scaled accordingly.
+ * The shells are not geometry volumes, so a long step crossing several shells is handled at once.
+ * Weights end up in the hit record (OMSimAnalysisManager::stats_weight).
+ */
+class OMSimImportanceBiasing
+{
+public:
+    static OMSimImportanceBiasing* GetInstance();
+
+    G4bool IsActive() { return mNrShells > 0; }
+    void Apply(const G4Step* pStep, G4TrackVector* pSecondaries);
+    void PrintSummary();
+    void Reset();
+
+private:
+    OMSimImportanceBiasing();
+    G4int GetCell(const G4ThreeVector& pPosition);
+
+    G4int mNrShells;
+    G4double mLogRadiusRatio;
+    G4double mSplit;
+
+    G4long mSplitCopies = 0;
+    G4long mRouletteKilled = 0;
+    G4long mRouletteSurvived = 0;
+};
+
+#endif
+//
@@ -22,6 +22,7 @@ public:
     void AppendParameterTable(G4String pFileName);
 //private:
     std::map<G4String, pt::ptree> mTable;
+    std::map<G4String, G4String> mFileNames; // json file each table was read from
 };
 
 
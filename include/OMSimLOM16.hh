@@ -21,6 +21,7 @@ public:
     G4double mGlassOutRad;
     G4double mCylHigh;
     G4String mDataKey = "om_LOM16";
+    G4String GetDataKey() { return mDataKey; }
 
   
 
@@ -21,6 +21,7 @@ public:
     G4double mCylinderAngle;
     G4double mGlassOutRad;
     G4String mDataKey = "om_LOM18";
+    G4String GetDataKey() { return mDataKey; }
 
   
 
@@ -33,6 +34,7 @@ private:
 
     G4Polycone* CreateLOM18OuterSolid();
     G4Polycone* CreateLOM18InnerSolid();
+    G4VSolid* AnalyticVessel(G4Polycone* pPolycone, G4String pName);
 
     G4LogicalVolume* CreateEquatorBand();
     void PlaceCADSupportStructure(G4LogicalVolume* lInnerVolumeLogical);
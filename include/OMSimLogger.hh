@@ -1,7 +1,14 @@
 /*
 I Took this from a github... but I can't find it right now for giving the credits :(
+
+The threshold LOG_LEVEL is fixed at compile time (CMake cache variable OMSIM_LOG_LEVEL), messages below it
+are removed by the preprocessor and cost nothing. Pass strings as arguments, e.g. info("%s", mssg.c_str()),
+never as the format itself.
+
+diag(limit, ...) is the channel for per-photon / per-step debugging output. It only exists in builds with
+OMSIM_DIAGNOSTICS (CMake option WITH_OMSIM_DIAGNOSTICS) and prints at most `limit` messages per call site
+and thread, so it can stay in the stepping action without flooding the console.
 */
-#define LOG_LEVEL DEBUG
 
 #ifndef OMSimLogger_h
 #define OMSimLogger_h 1
@@ -11,7 +18,7 @@ I Took this from a github... but I can't find it right now for giving the credit
 
 /* Default level */
 #ifndef LOG_LEVEL
-    #define LOG_LEVEL   WARNING
+    #define LOG_LEVEL   INFO
 #endif
 
 /* Colour customization */
@@ -21,6 +28,7 @@ I Took this from a github... but I can't find it right now for giving the credit
 #define WARNING_COLOUR  "\x1B[33m"
 #define ERROR_COLOUR    "\x1B[31m"
 #define CRITICAL_COLOUR "\x1B[41;1m"
+#define DIAG_COLOUR     "\x1B[35m"
 
 /* Do not change this. */
 #define RESET_COLOUR    "\x1B[0m"
@@ -97,58 +105,62 @@ I Took this from a github... but I can't find it right now for giving the credit
 #define SILENT      6
 
 /* DEBUG LOG */
-#define debug(...) do {                                                             \
-    if (LOG_LEVEL == DEBUG) {                                                       \
-        emit_log(                                                                   \
-            DEBUG_COLOUR, "[DEBUG]", __FILE__, __func__, __LINE__, __VA_ARGS__      \
-        );                                                                          \
-    }                                                                               \
-} while (0)
+#if LOG_LEVEL <= DEBUG
+#define debug(...) emit_log(DEBUG_COLOUR, "[DEBUG]", __FILE__, __func__, __LINE__, __VA_ARGS__)
+#else
+#define debug(...) do {} while (0)
+#endif
 
 /* INFO LOG */
-#define info(...) do {                                                              \
-    if (LOG_LEVEL <= INFO) {                                                        \
-        emit_log(                                                                   \
-            INFO_COLOUR, "[INFO]", __FILE__, __func__, __LINE__, __VA_ARGS__        \
-        );                                                                          \
-    }                                                                               \
-} while (0)
+#if LOG_LEVEL <= INFO
+#define info(...) emit_log(INFO_COLOUR, "[INFO]", __FILE__, __func__, __LINE__, __VA_ARGS__)
+#else
+#define info(...) do {} while (0)
+#endif
 
 /* NOTICE LOG */
-#define notice(...) do {                                                            \
-    if (LOG_LEVEL <= NOTICE) {                                                      \
-        emit_log(                                                                   \
-            NOTICE_COLOUR, "[NOTICE]", __FILE__, __func__, __LINE__, __VA_ARGS__    \
-        );                                                                          \
-    }                                                                               \
-} while (0)
+#if LOG_LEVEL <= NOTICE
+#define notice(...) emit_log(NOTICE_COLOUR, "[NOTICE]", __FILE__, __func__, __LINE__, __VA_ARGS__)
+#else
+#define notice(...) do {} while (0)
+#endif
 
 /* WARNING LOG */
-#define warning(...) do {                                                           \
-    if (LOG_LEVEL <= WARNING) {                                                     \
-        emit_log(                                                                   \
-            WARNING_COLOUR, "[WARNING]", __FILE__, __func__, __LINE__, __VA_ARGS__  \
-        );                                                                          \
-    }                                                                               \
-} while (0)
+#if LOG_LEVEL <= WARNING
+#define warning(...) emit_log(WARNING_COLOUR, "[WARNING]", __FILE__, __func__, __LINE__, __VA_ARGS__)
+#else
+#define warning(...) do {} while (0)
+#endif
 
 /* ERROR LOG */
-#define error(...) do {                                                             \
-    if (LOG_LEVEL <= ERROR) {                                                       \
-        emit_log(                                                                   \
-            ERROR_COLOUR, "[ERROR]", __FILE__, __func__, __LINE__, __VA_ARGS__      \
-        );                                                                          \
-    }                                                                               \
-} while (0)
+#if LOG_LEVEL <= ERROR
+#define error(...) emit_log(ERROR_COLOUR, "[ERROR]", __FILE__, __func__, __LINE__, __VA_ARGS__)
+#else
+#define error(...) do {} while (0)
+#endif
 
 /* CRITICAL LOG */
-#define critical(...) do {                                                          \
-    if (LOG_LEVEL <= CRITICAL) {                                                    \
-        emit_log(                                                                   \
-            CRITICAL_COLOUR, "[CRITICAL]", __FILE__, __func__, __LINE__, __VA_ARGS__\
-        );                                                                          \
+#if LOG_LEVEL <= CRITICAL
+#define critical(...) emit_log(CRITICAL_COLOUR, "[CRITICAL]", __FILE__, __func__, __LINE__, __VA_ARGS__)
+#else
+#define critical(...) do {} while (0)
+#endif
+
+/* RATE-LIMITED DIAGNOSTICS */
+#ifdef OMSIM_DIAGNOSTICS
+#define diag(limit, ...) do {                                                       \
+    static thread_local long diag_count = 0;                                        \
+    if (diag_count < (limit)) {                                                     \
+        emit_log(DIAG_COLOUR, "[DIAG]", __FILE__, __func__, __LINE__, __VA_ARGS__); \
+    } else if (diag_count == (limit)) {                                             \
+        emit_log(DIAG_COLOUR, "[DIAG]", __FILE__, __func__, __LINE__,               \
+                 "limit of %ld messages reached, suppressing this site", (long)(limit)); \
     }                                                                               \
+    ++diag_count;                                                                   \
 } while (0)
+#else
+#define diag(limit, ...) do {} while (0)
+#endif
 
 #endif 
 //
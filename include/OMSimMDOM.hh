@@ -25,6 +25,7 @@ public:
     G4double mGlassOutRad;
     G4double mCylHigh;
     G4String mDataKey = "om_mDOM";
+    G4String GetDataKey() { return mDataKey; }
     G4int mNrTotalLED;
     std::vector<G4Transform3D> mLEDTransformers; //coordinates from center of the module
     std::vector<std::vector<G4double>> mLED_AngFromSphere; //stores rho (mm),theta (deg),phi (deg) of each LED from the center of its corresponding spherical part. Useful to run the particles.
@@ -35,11 +36,12 @@ protected:
     void GetSharedData();
     G4SubtractionSolid* EquatorialReflector(G4VSolid* pSupportStructure, G4Cons* pReflCone, G4double pAngle, G4String pSuffix);
     void SetPMTPositions();
-    G4UnionSolid* PressureVessel(const G4double pOutRad, G4String pSuffix);
+    G4VSolid* PressureVessel(const G4double pOutRad, G4String pSuffix);
     G4SubtractionSolid* SubstractHarnessPlug(G4VSolid* pSolid);
     std::tuple<G4SubtractionSolid*, G4UnionSolid*> SupportStructure();
     std::tuple<G4SubtractionSolid*, G4UnionSolid*, G4UnionSolid*, G4Tubs*>  LedFlashers(G4VSolid* lSupStructureSolid);
     void SetLEDPositions();
+    G4VSolid* FlatSupportStructure(G4VSolid* pFoam, G4VSolid* pChain);
 
     // K.H. separated code to generate logicals from Construction function
     void GenerateLogicals();
@@ -50,6 +52,7 @@ protected:
     std::vector<G4RotationMatrix> mPMTRotations;
     std::vector<G4RotationMatrix> mPMTRotPhi;
     std::vector<G4ThreeVector> mReflectorPositions;
+    std::vector<std::pair<G4VSolid*, G4Transform3D>> mHolderCutouts; //all solids subtracted from the foam of the holder, for FlatSupportStructure
 
     G4LogicalVolume *lGlassLogical;
     G4LogicalVolume *lSupStructureLogical;
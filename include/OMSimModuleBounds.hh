@@ -0,0 +1,59 @@
+/** @file OMSimModuleBounds.hh
+ *  @brief Bounding spheres of the placed optical modules.
+ *
+ *  The detector construction registers every module it places, photon-level shortcuts (culling, biasing,
+ *  caching at the module boundary...) query the nearest sphere from here. Ice volumes placed in the world besides
+ *  the modules (e.g. the envelope of the fast simulation) are registered as bulk ice, so that these shortcuts treat
+ *  them like the world volume.
+ *
+ *  @date October 2026
+ *
+ *  @version Geant4 10.7
+ */
+
+#ifndef OMSimModuleBounds_h
+#define OMSimModuleBounds_h 1
+
+#include "G4ThreeVector.hh"
+#include "G4Types.hh"
+
+#include <utility>
+#include <vector>
+
+class G4LogicalVolume;
+class G4Step;
+class G4VPhysicalVolume;
+class G4VTouchable;
+
+class OMSimModuleBounds
+{
+public:
+    struct Sphere
+    {
+        G4ThreeVector Center;
+        G4double Radius;
+    };
+
+    static void Clear();
+    static G4int AddModule(G4ThreeVector pCenter, G4double pRadius);
+    static G4int NearestModule(const G4ThreeVector& pPosition);
+    static G4double DistanceToNearest(const G4ThreeVector& pPosition);
+    static const Sphere& GetModule(G4int pIndex) { return mModules.at(pIndex); }
+    static G4int GetNumberOfModules() { return (G4int)mModules.size(); }
+    static G4int GetModuleID(const G4VTouchable* pTouchable);
+
+    static G4bool StepEntersSphere(const G4Step* pStep, const G4ThreeVector& pCenter, G4double pRadius, G4ThreeVector& pCrossing, G4double& pFraction);
+    static G4int FirstEnteredModule(const G4Step* pStep, G4ThreeVector& pCrossing, G4double& pFraction);
+
+    static void AddBulkIce(const G4LogicalVolume* pVolume);
+    static void AddEnvelope(const G4LogicalVolume* pVolume, G4int pStride);
+    static G4bool IsBulkIce(const G4VPhysicalVolume* pVolume);
+
+private:
+    static std::vector<Sphere> mModules;
+    static std::vector<const G4LogicalVolume*> mBulkIce;
+    static std::vector<std::pair<const G4LogicalVolume*, G4int>> mEnvelopes; // ice envelopes of the module array and their module ID strides
+};
+
+#endif
+//
@@ -0,0 +1,75 @@
+/** @file OMSimNextEventEstimator.hh
+ *  @brief Next-event estimator of the expected hits per PMT from photons scattered in the bulk ice.
+ *
+ *  @date October 2026
+ *
+ *  @version Geant4 10.7
+ */
+
+#ifndef OMSimNextEventEstimator_h
+#define OMSimNextEventEstimator_h 1
+
+#include "G4MaterialPropertyVector.hh"
+#include "G4ThreeVector.hh"
+#include "G4Types.hh"
+
+#include <vector>
+
+class G4Step;
+class G4Track;
+class G4VProcess;
+
+/**
+ * @class OMSimNextEventEstimator
+ * @brief Scores at every Mie scattering vertex in the ice the probability that the next flight ends in a hit.
+ *
+ * For a vertex at distance D from a module bounding sphere of radius R, the photon is scattered into the cone of the
+ * sphere with probability p_HG(cos theta) * Omega, Omega = 2 pi (1 - sqrt(1 - R^2/D^2)), reaches it without further
+ * interaction with probability exp(-(D - R) / L_abs - (D - R) / L_scat) and is then detected by PMT k with the
+ * probability of the acceptance table (OMSimAcceptanceTable) for its direction and wavelength. p_HG is the phase
+ * function of G4OpMieHG (forward and backward Henyey-Greenstein lobes) with the constants of the world material.
+ * The real photon continues unchanged, so the analog hits of the run are not affected.
+ *
+ * Photons that are detected without having been scattered in the ice cannot be scored this way and are counted
+ * analogously. The estimate of the run is the sum of both parts; the event-by-event spread gives its uncertainty.
+ */
+class OMSimNextEventEstimator
+{
+public:
+    static OMSimNextEventEstimator* GetInstance();
+
+    G4bool IsActive() { return mActive; }
+    void ScoreStep(const G4Step* pStep);
+    void CountHit(const G4Track* pTrack, G4int pPMT);
+    void BeginOfEvent();
+    void EndOfEvent();
+    void PrintSummary();
+    void Reset();
+
+private:
+    OMSimNextEventEstimator();
+    G4bool LoadMaterial();
+    G4double PhaseFunction(G4double pCosTheta);
+
+    G4bool mActive = false;
+    G4bool mMaterialChecked = false;
+    const G4VProcess* mMieProcess = nullptr;
+    G4MaterialPropertyVector* mAbsorptionLength = nullptr;
+    G4MaterialPropertyVector* mScatteringLength = nullptr;
+    G4double mForwardG = 0;
+    G4double mBackwardG = 0;
+    G4double mForwardRatio = 1;
+
+    std::vector<G4double> mEventScore;  // per PMT, current event (scattered + direct)
+    std::vector<G4double> mEventDirect; // per PMT, current event, unscattered photons
+    std::vector<G4double> mSum;
+    std::vector<G4double> mSumSquares;
+    std::vector<G4double> mDirect;
+    G4double mTotalSum = 0;
+    G4double mTotalSumSquares = 0;
+    G4long mEvents = 0;
+    G4long mVertices = 0;
+};
+
+#endif
+//
@@ -11,10 +11,13 @@
 #include "G4PVPlacement.hh"
 #include "OMSimInputData.hh"
 #include "G4Tubs.hh"
+#include "G4OpticalSurface.hh"
 #include <tuple>
 #include <map>
 namespace pt = boost::property_tree;
 
+class OMSimRevolvedSolid;
+
 class OMSimPMTConstruction
 {
 public:
@@ -40,11 +43,15 @@ protected:
         void BasicShape();
         std::tuple<G4UnionSolid *, G4SubtractionSolid *> BulbConstructionSimple(G4String pSide);
         std::tuple<G4UnionSolid *, G4SubtractionSolid *> BulbConstructionFull(G4String pSide);
-        void CathodeBackShield(G4LogicalVolume *pPMTIinner);
+        std::tuple<OMSimRevolvedSolid *, OMSimRevolvedSolid *> AnalyticBulbConstruction(G4String pSide, G4VSolid *pBulb, G4VSolid *pPhotocathode);
+        G4PVPlacement *CathodeBackShield(G4LogicalVolume *pPMTIinner);
+        void AssignSurfaces(G4PVPlacement *pPMTPhysical, G4String pMirror);
+        void NeutralBorder(G4VPhysicalVolume *pVolume1, G4VPhysicalVolume *pVolume2);
         void DynodeSystemConstruction(G4LogicalVolume *pMother);
         void ReadParameters(G4String pSide);
 
         virtual G4UnionSolid *FrontalBulbConstruction() = 0; // abstract method
+        virtual G4bool FrontalBulbPieces(OMSimRevolvedSolid *pSolid, G4double pZMin) = 0; // analytic counterpart of FrontalBulbConstruction
 
         G4LogicalVolume *mPMTlogical;
         G4UnionSolid *mGlassInside;
@@ -53,7 +60,12 @@ protected:
         G4PVPlacement *mVacuumPhotocathodePlacement;
         G4SubtractionSolid *mVacuumPhotocathodeSolid;
         G4Tubs *mBulkSolid;
+        G4VSolid *mAnalyticPMTSolid = nullptr; // analytic solids of the simple bulb (gAnalyticPMTBulbs), used instead of the booleans
+        G4VSolid *mAnalyticGlassInside = nullptr;
+        G4VSolid *mAnalyticPhotocathodeSolid = nullptr;
         G4PVPlacement *mVacuumTubePlacement;
+        G4OpticalSurface *mMirrorSurface = nullptr; // skin of the mirrored back, set at the first placement
+        G4OpticalSurface *mNeutralSurface = nullptr;
 
         bool mCheckOverlaps = true;
 
@@ -98,6 +110,7 @@ protected:
 
     public:
         G4UnionSolid *FrontalBulbConstruction();
+        G4bool FrontalBulbPieces(OMSimRevolvedSolid *pSolid, G4double pZMin);
     };
     class SphereDoubleEllipsePhotocathode : public PMT
     {
@@ -106,6 +119,7 @@ protected:
 
     public:
         G4UnionSolid *FrontalBulbConstruction();
+        G4bool FrontalBulbPieces(OMSimRevolvedSolid *pSolid, G4double pZMin);
     };
 
 public:
@@ -0,0 +1,91 @@
+/** @file OMSimPhotonCache.hh
+ *  @brief Binary cache of the photons crossing a sphere around the module, for two-stage simulations.
+ *
+ *  @date October 2026
+ *
+ *  @version Geant4 10.7
+ */
+
+#ifndef OMSimPhotonCache_h
+#define OMSimPhotonCache_h 1
+
+#include "G4String.hh"
+#include "G4ThreeVector.hh"
+#include "G4Types.hh"
+
+#include <cstdint>
+#include <fstream>
+#include <vector>
+
+class G4Step;
+class G4StepPoint;
+class G4Track;
+
+/**
+ * @class OMSimPhotonCache
+ * @brief Records photons entering the cache sphere (stage one) and reads them back for replay (stage two).
+ *
+ * Stage one (gPhotonCacheRecord) runs the usual simulation of the IBD positrons. Every optical photon entering the
+ * sphere of radius gPhotonCacheRadius around the module is written to gPhotonCacheFile at its first crossing, also if
+ * it passes the sphere without touching the module. Photons whose step ends inside the sphere are killed, so the
+ * stage-one module does not select what is stored; the others fly on but are not written again. The crossing point is computed exactly on the straight step through the sphere; time,
+ * direction and polarisation are those of the photon on that step. Photons created inside the sphere are written at
+ * their creation point and killed. The weight of the track (importance splitting, Russian roulette, recycling) is
+ * stored and given to the primary of the replay.
+ * Stage two uses the "photoncache" generator mode: every event injects the photons of one recorded event as
+ * primaries into whatever module is built (gDOM), with the vertex and positron id of the original photon.
+ * Photons that would leave the module again and come back after scattering in the ice are lost in this scheme.
+ *
+ * File layout: header (magic "OMSIMPC2", radius in mm, center in mm), then fixed-size records. Runs and jobs writing
+ * to the same file append to it, event numbers continue. Caches of the first version ("OMSIMPC1", integer weight that
+ * was always 1) are replayed with weight 1.
+ */
+class OMSimPhotonCache
+{
+public:
+    struct Record
+    {
+        G4double Time;         // ns
+        G4float Position[3];   // mm, relative to the center of the cache sphere
+        G4float Direction[3];
+        G4float Polarization[3];
+        G4float Vertex[3];     // mm, emission point of the photon, relative to the center
+        G4float Wavelength;    // nm
+        int32_t EventID;       // consecutive over all runs of the file
+        int32_t AncestorID;    // positron id of the hit record
+        G4float Weight;        // weight of the track, 1 for analog photons
+    };
+
+    static OMSimPhotonCache* GetInstance();
+
+    // stage one
+    void OpenForWriting(G4String pFileName, G4double pRadius, G4ThreeVector pCenter);
+    G4bool IsRecording() { return mOutput.is_open(); }
+    void BeginOfEvent() { mEventID++; }
+    G4bool RecordCrossing(const G4Step* pStep);
+    static G4bool IsLegacy(const char* pMagic);
+    void Close();
+
+    // stage two
+    G4bool OpenForReading(G4String pFileName);
+    G4bool ReadEvent(std::vector<Record>& pRecords);
+    G4double GetRadius() { return mRadius; }
+    G4ThreeVector GetCenter() { return mCenter; }
+
+private:
+    OMSimPhotonCache() {}
+    void Write(G4Track* pTrack, const G4StepPoint* pPoint, G4ThreeVector pPosition, G4double pTime);
+
+    std::ofstream mOutput;
+    std::ifstream mInput;
+    G4double mRadius = 0;
+    G4ThreeVector mCenter;
+    int32_t mEventID = -1;
+    G4long mRecorded = 0;
+    G4bool mHavePending = false;
+    G4bool mLegacy = false; // cache of the first version, read with weight 1
+    Record mPending;
+};
+
+#endif
+//
@@ -0,0 +1,68 @@
+/** @file OMSimPhotonCulling.hh
+ *  @brief Kills optical photons that are too far from every module to be detected.
+ *
+ *  @date October 2026
+ *
+ *  @version Geant4 10.7
+ */
+
+#ifndef OMSimPhotonCulling_h
+#define OMSimPhotonCulling_h 1
+
+#include "G4MaterialPropertyVector.hh"
+#include "G4ThreeVector.hh"
+#include "G4Types.hh"
+
+#include <unordered_set>
+
+class G4Track;
+class G4Step;
+
+/**
+ * @class OMSimPhotonCulling
+ * @brief Photon horizon around the optical modules.
+ *
+ * A photon at distance d from the closest module bounding sphere needs a path of at least d to reach it, so it
+ * survives absorption with a probability of at most exp(-d/L_abs). Photons with d > k * L_abs(lambda) are culled when
+ * they are stacked and after every step in the bulk ice (scattering may take them further away). A culled photon would
+ * have been detected with a probability below exp(-k); this bounds the loss per photon, not the relative loss of hits,
+ * which can be much larger when the culled photons far outnumber the near ones. The direction of the photon is not
+ * used: with scattering lengths well below the absorption length, a photon heading away can turn back after its next
+ * scattering, so the distance is the only safe bound. L_abs is taken from the material of the world volume.
+ *
+ * The loss of hits has to be measured: in validation mode (gCullingValidation) nothing is killed. Photons that would
+ * have been culled are only flagged, and at the end of the run the hits of flagged and of kept photons are compared.
+ */
+class OMSimPhotonCulling
+{
+public:
+    static OMSimPhotonCulling* GetInstance();
+
+    G4bool IsActive() { return mK > 0; }
+    G4bool CullAtCreation(const G4Track* pTrack);
+    G4bool CullAfterStep(const G4Step* pStep);
+    void CountHit(const G4Track* pTrack);
+    void BeginOfEvent() { mFlagged.clear(); }
+    void PrintSummary();
+    void Reset();
+
+private:
+    OMSimPhotonCulling();
+    G4bool BeyondHorizon(const G4ThreeVector& pPosition, G4double pEnergy);
+    G4bool Cull(const G4Track* pTrack, G4long& pCounter);
+
+    G4double mK;
+    G4bool mValidation;
+    G4MaterialPropertyVector* mAbsorptionLength = nullptr;
+    G4bool mMaterialChecked = false;
+
+    G4long mStacked = 0;
+    G4long mCulledAtCreation = 0;
+    G4long mCulledInFlight = 0;
+    G4long mHits = 0;
+    G4long mHitsOfCulled = 0;
+    std::unordered_set<G4int> mFlagged; // validation mode: track IDs (of this event) that would have been culled
+};
+
+#endif
+//
@@ -0,0 +1,67 @@
+/** @file OMSimPhotonInfo.hh
+ *  @brief User track information of optical photons created by the simulation itself (splitting, recycling...).
+ *
+ *  Geant4 resets the vertex of every track when its tracking starts, so copies of a photon would lose the position
+ *  where the original photon was emitted. The original vertex is kept here and used in the hit record.
+ *
+ *  @date October 2026
+ *
+ *  @version Geant4 10.7
+ */
+
+#ifndef OMSimPhotonInfo_h
+#define OMSimPhotonInfo_h 1
+
+#include "G4Track.hh"
+#include "G4ThreeVector.hh"
+#include "G4VUserTrackInformation.hh"
+#include "G4VUserPrimaryParticleInformation.hh"
+
+class OMSimPhotonInfo : public G4VUserTrackInformation
+{
+public:
+    OMSimPhotonInfo(G4ThreeVector pVertexPosition) : G4VUserTrackInformation("OMSimPhotonInfo"), VertexPosition(pVertexPosition) {}
+    ~OMSimPhotonInfo() {}
+
+    /**
+     * @return Position where the photon (or the photon it was copied from) was emitted
+     */
+    static G4ThreeVector GetOriginalVertex(const G4Track* pTrack)
+    {
+        OMSimPhotonInfo* lInfo = (OMSimPhotonInfo*)pTrack->GetUserInformation();
+        return lInfo ? lInfo->VertexPosition : pTrack->GetVertexPosition();
+    }
+
+    /**
+     * @return Track ID of the particle that emitted the photon (positron id of the hit record)
+     */
+    static G4int GetAncestorID(const G4Track* pTrack)
+    {
+        OMSimPhotonInfo* lInfo = (OMSimPhotonInfo*)pTrack->GetUserInformation();
+        return (lInfo && lInfo->AncestorID >= 0) ? lInfo->AncestorID : pTrack->GetParentID();
+    }
+
+    G4ThreeVector VertexPosition;
+    G4int AncestorID = -1; // set for photons injected as primaries (replayed caches), -1 = parent of the track
+    G4bool Recycled = false; // already replayed at the module boundary (OMSimPhotonRecycling)
+    G4bool Cached = false; // already written to the photon cache (OMSimPhotonCache), later crossings are not recorded
+    G4bool Scattered = false; // scattered in the bulk ice (next-event estimator)
+    G4double FastSimStartTime = -1; // fast simulation validation: time the photon entered the ice envelope (-2 after its arrival)
+};
+
+/**
+ * @class OMSimPrimaryPhotonInfo
+ * @brief Ancestry of an optical photon injected as primary, turned into OMSimPhotonInfo by the tracking action.
+ */
+class OMSimPrimaryPhotonInfo : public G4VUserPrimaryParticleInformation
+{
+public:
+    OMSimPrimaryPhotonInfo(G4ThreeVector pVertexPosition, G4int pAncestorID) : VertexPosition(pVertexPosition), AncestorID(pAncestorID) {}
+    void Print() const override {}
+
+    G4ThreeVector VertexPosition;
+    G4int AncestorID;
+};
+
+#endif
+//
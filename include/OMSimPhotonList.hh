@@ -0,0 +1,73 @@
+/** @file OMSimPhotonList.hh
+ *  @brief Memory-mapped list of optical photons injected as primaries.
+ *
+ *  @date October 2026
+ *
+ *  @version Geant4 10.7
+ */
+
+#ifndef OMSimPhotonList_h
+#define OMSimPhotonList_h 1
+
+#include "G4String.hh"
+#include "G4ThreeVector.hh"
+#include "G4Types.hh"
+
+#include <cstddef>
+#include <cstdint>
+
+class G4Event;
+
+/**
+ * @class OMSimPhotonList
+ * @brief Read-only view of a binary photon list, mapped into memory.
+ *
+ * The "photonlist" generator mode injects the photons of gPhotonListFile as primaries, gPhotonListBatch photons per
+ * event, and aborts the run when the list is exhausted. Only optical photons are simulated, so the run measures the
+ * detector response alone (no charged particles are generated).
+ *
+ * Two layouts are accepted:
+ * - photon lists (magic "OMSIMPL1"): fixed-size Photon records in world coordinates, e.g. written by an external
+ *   propagator,
+ * - photon caches of earlier runs (magic "OMSIMPC2" or "OMSIMPC1", see OMSimPhotonCache): positions relative to the
+ *   cache sphere, placed around the module that is built, with the weights of the recorded tracks.
+ * The file is mapped with mmap and read sequentially, so lists larger than the memory can be replayed.
+ */
+class OMSimPhotonList
+{
+public:
+    struct Photon
+    {
+        G4double Time;           // ns
+        G4float Position[3];     // mm
+        G4float Direction[3];
+        G4float Polarization[3];
+        G4float Wavelength;      // nm
+        int32_t AncestorID;      // positron id written to the hits, -1 if unknown
+    };
+
+    static OMSimPhotonList* GetInstance();
+
+    G4bool Open(G4String pFileName);
+    void Close();
+    G4bool IsOpen() { return mData != nullptr; }
+    size_t GetNumberOfPhotons() { return mNrPhotons; }
+    size_t AddBatch(G4Event* pEvent, size_t pBatch);
+
+private:
+    OMSimPhotonList() {}
+    ~OMSimPhotonList() { Close(); }
+
+    const char* mData = nullptr; // mapped file
+    size_t mSize = 0;
+    const char* mRecords = nullptr;
+    size_t mRecordSize = 0;
+    size_t mNrPhotons = 0;
+    size_t mNext = 0;
+    G4bool mCache = false;       // photon cache layout
+    G4bool mLegacyCache = false; // photon cache of the first version, weights are 1
+    G4ThreeVector mOffset;       // added to the positions of photon caches
+};
+
+#endif
+//
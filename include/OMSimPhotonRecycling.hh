@@ -0,0 +1,49 @@
+/** @file OMSimPhotonRecycling.hh
+ *  @brief Oversampling of photons arriving at the module, using its azimuthal (and up-down) symmetry.
+ *
+ *  @date October 2026
+ *
+ *  @version Geant4 10.7
+ */
+
+#ifndef OMSimPhotonRecycling_h
+#define OMSimPhotonRecycling_h 1
+
+#include "G4TrackVector.hh"
+#include "G4Types.hh"
+
+class G4Step;
+
+/**
+ * @class OMSimPhotonRecycling
+ * @brief Replays every photon reaching a module bounding sphere gRecyclingFactor times.
+ *
+ * When a photon enters a bounding sphere for the first time, K - 1 copies are started at the crossing point rotated
+ * by random angles about the module axis (z) through the module center; position, direction and polarisation are
+ * rotated together. With gRecyclingMirror a copy is also reflected at the equatorial plane with probability 1/2
+ * (for modules that are symmetric up and down, e.g. mDOM and LOM). Original and copies carry 1/K of the weight.
+ *
+ * For an isotropic source (supernova) the hit distribution is unchanged, while the expensive propagation through the
+ * ice is done once for K photons reaching the module. The factor is written to the head of the hit file.
+ */
+class OMSimPhotonRecycling
+{
+public:
+    static OMSimPhotonRecycling* GetInstance();
+
+    G4bool IsActive() { return mFactor > 1; }
+    G4int GetFactor() { return mFactor; }
+    void Apply(const G4Step* pStep, G4TrackVector* pSecondaries);
+    void PrintSummary();
+    void Reset() { mRecycled = 0; }
+
+private:
+    OMSimPhotonRecycling();
+
+    G4int mFactor;
+    G4bool mMirror;
+    G4long mRecycled = 0;
+};
+
+#endif
+//
@@ -32,6 +32,12 @@ private:
 	//creating particle gun and make it read from sntools output files
 
 	void SetUpEnergyAndPosition();
+	void GeneratePlaneWave(G4Event* anEvent);
+	void GeneratePropagationBin(G4Event* anEvent);
+	void GenerateFromPhotonCache(G4Event* anEvent);
+	void GenerateFromPhotonList(G4Event* anEvent);
+	void GenerateAnalyticHits();
+	void GenerateLibraryShower(G4Event* anEvent);
 
 	G4ParticleGun *fParticleGun;
     G4int numParticles;
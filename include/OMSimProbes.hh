@@ -0,0 +1,41 @@
+/** @file OMSimProbes.hh
+ *  @brief Static tracepoints (USDT) on the simulation hot paths.
+ *
+ *  If the project is configured with WITH_OMSIM_USDT and sys/sdt.h is found, OMSIM_USDT is defined and each
+ *  OMSIM_PROBE* becomes a systemtap/dtrace style probe in the provider "omsim". Such a probe is a single nop in the
+ *  binary until a tracer attaches to it, e.g.
+ *
+ *      perf buildid-cache --add ./bulkice_doumeki && perf probe sdt_omsim:photocathode_hit
+ *      bpftrace -e 'usdt:./bulkice_doumeki:omsim:qe_decision { @[arg1] = count(); }'
+ *
+ *  Without OMSIM_USDT the macros expand to nothing. Arguments must be integers or pointers.
+ *
+ *  Probes (arguments in brackets):
+ *  - event_begin (event id)
+ *  - event_end (event id, number of hits stored so far in the run)
+ *  - photon_created (track id, wavelength in pm)
+ *  - photocathode_hit (track id, wavelength in pm)
+ *  - qe_decision (track id, 1 if detected else 0)
+ *  - output_flush (number of hits written, 0 = individual / 1 = collective)
+ *
+ *  @date October 2026
+ *
+ *  @version Geant4 10.7
+ */
+
+#ifndef OMSimProbes_h
+#define OMSimProbes_h 1
+
+#ifdef OMSIM_USDT
+#include <sys/sdt.h>
+#define OMSIM_PROBES_ENABLED 1
+#define OMSIM_PROBE1(name, a1) DTRACE_PROBE1(omsim, name, a1)
+#define OMSIM_PROBE2(name, a1, a2) DTRACE_PROBE2(omsim, name, a1, a2)
+#else
+#define OMSIM_PROBES_ENABLED 0
+#define OMSIM_PROBE1(name, a1) do {} while (0)
+#define OMSIM_PROBE2(name, a1, a2) do {} while (0)
+#endif
+
+#endif
+//
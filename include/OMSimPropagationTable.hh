@@ -0,0 +1,90 @@
+/** @file OMSimPropagationTable.hh
+ *  @brief Photon propagation tables of the bulk ice for the fast simulation.
+ *
+ *  @date October 2026
+ *
+ *  @version Geant4 10.7
+ */
+
+#ifndef OMSimPropagationTable_h
+#define OMSimPropagationTable_h 1
+
+#include "G4String.hh"
+#include "G4ThreeVector.hh"
+#include "G4Types.hh"
+
+#include <vector>
+
+class G4Step;
+
+/**
+ * @class OMSimPropagationTable
+ * @brief Probability and phase space of photons reaching the inner sphere of the bulk-ice envelope.
+ *
+ * A photon in the ice at distance r >= R from the module center, moving at angle alpha to the direction towards the
+ * center and with wavelength lambda, reaches the sphere of radius R (inner surface of the envelope, see
+ * OMSimIceFastModel) with probability P(r, cos(alpha), lambda). For every bin a reservoir of arrivals is kept:
+ * delay, position and direction on the sphere in the local frame of the photon (z from the center to the photon,
+ * x along the transverse part of the photon direction). The ice is homogeneous and isotropic, so this frame
+ * describes the problem completely (up to the reflection y -> -y, used when sampling).
+ *
+ * Tables are built by the "proptable" generator mode: event i fires gPropagationPhotons photons of bin
+ * i % GetNumberOfBins() with random orientation, the stepping action records their arrivals with RecordArrival()
+ * and the table is written to gPropagationTableFile at the end of the run.
+ */
+class OMSimPropagationTable
+{
+public:
+    struct Arrival
+    {
+        G4float Delay;       // ns
+        G4float Position[3]; // unit vector, local frame
+        G4float Direction[3];
+    };
+
+    static OMSimPropagationTable* GetInstance();
+
+    void SetBinning(G4int pNrR, G4int pNrCosAlpha, G4int pNrLambda, G4double pRMin, G4double pRMax,
+                    G4double pLambdaMin, G4double pLambdaMax, G4int pReservoir);
+    void SetDefaultBinning(G4double pRMin, G4double pRMax);
+    static G4int GetDefaultNumberOfBins();
+    G4bool Load(G4String pFileName);
+    void Save(G4String pFileName);
+    G4bool IsLoaded() { return mLoaded; }
+
+    G4int GetNumberOfBins() { return mNrR * mNrCosAlpha * mNrLambda; }
+    G4double GetInnerRadius() { return mRMin; }
+    G4int FindBin(G4double pR, G4double pCosAlpha, G4double pLambda);
+    void SampleBin(G4int pBin, G4double& pR, G4double& pCosAlpha, G4double& pLambda);
+    G4double GetArrivalProbability(G4int pBin);
+    const Arrival* SampleArrival(G4int pBin);
+    const std::vector<Arrival>& GetArrivals(G4int pBin) { return mSamples.at(pBin); }
+
+    static void LocalFrame(const G4ThreeVector& pFromCenter, const G4ThreeVector& pDirection, G4ThreeVector& pX, G4ThreeVector& pY, G4ThreeVector& pZ);
+
+    // building
+    void SetCurrentBin(G4int pBin) { mCurrentBin = pBin; }
+    void AddPhotons(G4int pBin, G4long pPhotons);
+    void RecordArrival(const G4Step* pStep, G4ThreeVector pCenter);
+
+private:
+    OMSimPropagationTable() {}
+
+    G4int mNrR = 0;
+    G4int mNrCosAlpha = 0;
+    G4int mNrLambda = 0;
+    G4double mRMin = 0;
+    G4double mRMax = 0;
+    G4double mLambdaMin = 0;
+    G4double mLambdaMax = 0;
+    G4int mReservoir = 0;
+
+    std::vector<G4double> mPhotons;  // per bin
+    std::vector<G4double> mArrivals; // per bin
+    std::vector<std::vector<Arrival>> mSamples;
+    G4bool mLoaded = false;
+    G4int mCurrentBin = -1;
+};
+
+#endif
+//
@@ -0,0 +1,101 @@
+/** @file OMSimRevolvedSolid.hh
+ *  @brief Analytic solid of revolution (union of ellipsoids, sphere sectors, frustums and convex polycones) for PMT bulbs and pressure vessels.
+ *
+ *  @date October 2026
+ *
+ *  @version Geant4 10.7
+ */
+
+#ifndef OMSimRevolvedSolid_h
+#define OMSimRevolvedSolid_h 1
+
+#include "G4VSolid.hh"
+
+class G4Polycone;
+
+#include <vector>
+
+/**
+ * @class OMSimRevolvedSolid
+ * @brief Rotationally symmetric (around z) union of convex pieces, answering the navigation queries in closed form.
+ *
+ * The fitted PMT bulbs (sphere + ellipse, sphere + two ellipses, plus the tube of the neck) and the pressure vessels
+ * (polycone + two hemispheres) are built as trees of G4UnionSolid and G4SubtractionSolid. This class describes the
+ * same shape as a flat list of pieces, each one an ellipsoid, a sphere sector, a frustum or a convex polycone,
+ * optionally cut by planes of constant z. Rays are intersected with every piece analytically (quadratic equations),
+ * the union is resolved by merging the intervals along the ray, so a query costs one quadratic per surface instead
+ * of a walk through the boolean tree.
+ *
+ * The boolean solid of the same shape can be given as reference; it is only used for the visualisation
+ * (CreatePolyhedron) and to sample points on the surface. Without reference, the polyhedron is built from the profile
+ * of the union (each piece is a solid of revolution around z, so the union is the disc of the largest piece radius at
+ * every z).
+ */
+class OMSimRevolvedSolid : public G4VSolid
+{
+public:
+    OMSimRevolvedSolid(const G4String &pName, G4VSolid *pReference = nullptr);
+    virtual ~OMSimRevolvedSolid() {}
+
+    void AddEllipsoid(G4double pXYaxis, G4double pZaxis, G4double pZ, G4double pZMin = -kInfinity, G4double pZMax = kInfinity);
+    void AddSphereSector(G4double pRadius, G4double pZ, G4double pTheta, G4double pZMin = -kInfinity, G4double pZMax = kInfinity);
+    void AddCylinder(G4double pRadius, G4double pZMin, G4double pZMax);
+    void AddFrustum(G4double pRadiusLow, G4double pRadiusHigh, G4double pZLow, G4double pZHigh);
+    G4bool AddConvexPolycone(const G4Polycone *pPolycone);
+    size_t GetNumberOfPieces() const { return mPieces.size(); }
+
+    EInside Inside(const G4ThreeVector &p) const;
+    G4ThreeVector SurfaceNormal(const G4ThreeVector &p) const;
+    G4double DistanceToIn(const G4ThreeVector &p, const G4ThreeVector &v) const;
+    G4double DistanceToIn(const G4ThreeVector &p) const;
+    G4double DistanceToOut(const G4ThreeVector &p, const G4ThreeVector &v, const G4bool calcNorm = false, G4bool *validNorm = nullptr, G4ThreeVector *n = nullptr) const;
+    G4double DistanceToOut(const G4ThreeVector &p) const;
+
+    void BoundingLimits(G4ThreeVector &pMin, G4ThreeVector &pMax) const;
+    G4bool CalculateExtent(const EAxis pAxis, const G4VoxelLimits &pVoxelLimit, const G4AffineTransform &pTransform, G4double &pMin, G4double &pMax) const;
+    G4GeometryType GetEntityType() const { return "OMSimRevolvedSolid"; }
+    G4VSolid *Clone() const { return new OMSimRevolvedSolid(*this); }
+    std::ostream &StreamInfo(std::ostream &os) const;
+    G4ThreeVector GetPointOnSurface() const;
+    void DescribeYourselfTo(G4VGraphicsScene &scene) const;
+    G4Polyhedron *CreatePolyhedron() const;
+
+private:
+    enum ConstraintKind
+    {
+        kQuadric, // Alpha * rho^2 + Beta * (z - Z)^2 - Gamma <= 0 (ellipsoid or cylinder)
+        kCone,    // rho <= Slope * Direction * (z - Z), one nappe only
+        kZMin,    // z >= Z
+        kZMax     // z <= Z
+    };
+    struct Constraint
+    {
+        ConstraintKind Kind;
+        G4double Alpha = 0, Beta = 0, Gamma = 0;
+        G4double Z = 0;
+        G4double Slope = 0;     // tangent of the half-angle of cones
+        G4double Direction = 1; // +1: cone opening towards +z, -1: towards -z
+        G4double MinAxis = 0;   // smallest semi-axis of quadrics, for the safety
+    };
+    struct Piece
+    {
+        std::vector<Constraint> Constraints;
+        G4double Radius;        // largest rho of the piece
+        G4double ZMin, ZMax;
+    };
+
+    void AddPiece(Piece &pPiece, G4double pZMin, G4double pZMax);
+    void AddSide(Piece &pPiece, G4double pRadiusLow, G4double pRadiusHigh, G4double pZLow, G4double pZHigh);
+    G4double Distance(const Constraint &pConstraint, const G4ThreeVector &p, G4bool pSafety) const;
+    G4ThreeVector Normal(const Constraint &pConstraint, const G4ThreeVector &p) const;
+    G4bool Interval(const Constraint &pConstraint, const G4ThreeVector &p, const G4ThreeVector &v, G4double &pEnter, G4double &pExit) const;
+    G4bool Interval(const Piece &pPiece, const G4ThreeVector &p, const G4ThreeVector &v, G4double &pEnter, G4double &pExit, const Constraint *&pExitConstraint) const;
+    G4double Radius(const Piece &pPiece, G4double pZ) const;
+
+    std::vector<Piece> mPieces;
+    G4VSolid *mReference;
+    G4double mHalfTolerance;
+};
+
+#endif
+//
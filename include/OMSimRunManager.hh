@@ -0,0 +1,29 @@
+/** @file OMSimRunManager.hh
+ *  @brief G4RunManager with the initialisation and run phases wrapped in timeline spans.
+ *
+ *  @date October 2026
+ *
+ *  @version Geant4 10.7
+ */
+
+#ifndef OMSimRunManager_h
+#define OMSimRunManager_h 1
+
+#include "G4RunManager.hh"
+
+class OMSimRunManager : public G4RunManager
+{
+public:
+    OMSimRunManager();
+    ~OMSimRunManager(){};
+
+    void InitializeGeometry() override;
+    void InitializePhysics() override;
+    void RunInitialization() override;
+    void DoEventLoop(G4int pNumberOfEvents, const char* pMacroFile = 0, G4int pNumberSelected = -1) override;
+    void ProcessOneEvent(G4int pEventID) override;
+    void RunTermination() override;
+};
+
+#endif
+//
@@ -0,0 +1,104 @@
+/** @file OMSimShowerLibrary.hh
+ *  @brief Library of pre-simulated Cherenkov emission of IBD positrons, replayed instead of tracking the cascade.
+ *
+ *  @date October 2026
+ *
+ *  @version Geant4 10.7
+ */
+
+#ifndef OMSimShowerLibrary_h
+#define OMSimShowerLibrary_h 1
+
+#include "G4String.hh"
+#include "G4ThreeVector.hh"
+#include "G4TrackVector.hh"
+#include "G4Types.hh"
+
+#include <vector>
+
+class G4Step;
+class G4Track;
+
+/**
+ * @class OMSimShowerLibrary
+ * @brief Optical photons emitted by positrons of given energy, relative to the positron vertex and direction.
+ *
+ * Building ("showerbuild" generator mode): event i fires one positron of energy bin i % GetNumberOfBins() along +z
+ * from a vertex far from the module. The stacking action hands every new optical photon to RecordPhoton() and kills
+ * it, so only the electromagnetic cascade (positron, annihilation gammas, Compton electrons) is tracked. The shower of
+ * the event is stored at its end; the library is written to gShowerLibraryFile at the end of the run.
+ *
+ * Replay ("showerlib" generator mode): the sntools positrons are generated as usual. At the first step of each
+ * primary positron, ReplaceShower() kills it and pushes the photons of the library shower closest in energy (in its
+ * energy bin or the neighbouring ones) as secondaries, rotated to the positron direction with a random azimuth. A
+ * shower of energy E_lib is used for a positron of energy E by giving every photon floor(E/E_lib) copies plus one more
+ * with the probability of the remainder. E/E_lib is capped at 2 (with a warning), so that a shower of much lower energy
+ * does not turn a few photons into many correlated copies. The photons are stacked positron by positron, like the
+ * photons of the tracked cascade.
+ *
+ * File layout: magic "OMSIMSL1", number of bins (int32), showers per bin (int32), energy range (2 x double, MeV),
+ * then per bin the number of showers (int32) and per shower its energy (float, MeV), its number of photons (int32)
+ * and the photons. The library is only valid for the ice (RINDEX) of the job that built it.
+ */
+class OMSimShowerLibrary
+{
+public:
+    struct Photon
+    {
+        G4float Position[3];     // mm, relative to the vertex, positron along +z
+        G4float Direction[3];
+        G4float Polarization[3];
+        G4float Time;            // ns after the positron started
+        G4float Wavelength;      // nm
+    };
+
+    static OMSimShowerLibrary* GetInstance();
+
+    // building
+    void SetBinning(G4int pNrBins, G4double pEMin, G4double pEMax, G4int pShowersPerBin);
+    void SetDefaultBinning();
+    static G4int GetDefaultNumberOfShowers();
+    G4int GetNumberOfBins() { return mNrBins; }
+    G4double SampleEnergy(G4int pBin);
+    void BeginShower(G4int pBin, G4double pEnergy, G4ThreeVector pVertex);
+    G4bool RecordPhoton(const G4Track* pTrack);
+    void EndShower();
+    void Save(G4String pFileName);
+
+    // replay
+    G4bool Load(G4String pFileName);
+    G4bool IsLoaded() { return mLoaded; }
+    G4bool ReplaceShower(const G4Step* pStep, G4TrackVector* pSecondaries);
+    void PrintSummary();
+    void Reset();
+
+private:
+    OMSimShowerLibrary() {}
+    G4int FindBin(G4double pEnergy);
+
+    struct Shower
+    {
+        G4float Energy; // MeV
+        std::vector<Photon> Photons;
+    };
+    const Shower* FindClosestShower(G4double pEnergy);
+
+    G4int mNrBins = 0;
+    G4double mEMin = 0;
+    G4double mEMax = 0;
+    G4int mShowersPerBin = 0;
+    std::vector<std::vector<Shower>> mShowers; // per bin
+    G4bool mLoaded = false;
+
+    // shower being built
+    G4int mCurrentBin = -1;
+    Shower mCurrent;
+    G4ThreeVector mVertex;
+
+    G4long mReplaced = 0;
+    G4long mPhotons = 0;
+    G4long mCapped = 0; // showers replayed with capped copies
+};
+
+#endif
+//
@@ -0,0 +1,47 @@
+/** @file OMSimSolidCheck.hh
+ *  @brief Comparison of two solids that should describe the same shape (exactness and navigation speed).
+ *
+ *  @date October 2026
+ *
+ *  @version Geant4 10.7
+ */
+
+#ifndef OMSimSolidCheck_h
+#define OMSimSolidCheck_h 1
+
+#include "G4String.hh"
+#include "G4Types.hh"
+
+class G4VSolid;
+
+/**
+ * @class OMSimSolidCheck
+ * @brief Samples points in the bounding box of a reference solid and compares a faster replacement with it.
+ *
+ * For every point, Inside() of both solids is compared (inside/outside disagreements are counted, disagreements
+ * involving kSurface are counted separately), as well as DistanceToIn or DistanceToOut along a random direction
+ * (outside or inside the reference). Where the rays of inside points leave the solid, the surface normals are compared
+ * as well. The queries are timed for both solids, so the summary also gives the speed-up
+ * of the replacement for the navigation. A fixed-seed private engine is used, the random sequence of the simulation
+ * is not affected.
+ */
+class OMSimSolidCheck
+{
+public:
+    struct Result
+    {
+        G4int Points = 0;
+        G4int InsideMismatches = 0;     // one solid inside, the other outside
+        G4int SurfaceMismatches = 0;    // one solid on the surface, the other not
+        G4int DistanceMismatches = 0;   // distances along the same ray differ by more than the tolerance
+        G4int NormalMismatches = 0;     // different normals where the ray from an inside point leaves the solid
+        G4double ReferenceTime = 0;     // s
+        G4double CandidateTime = 0;     // s
+    };
+
+    static Result Compare(const G4VSolid* pReference, const G4VSolid* pCandidate, G4int pPoints, G4double pTolerance);
+    static Result CompareAndPrint(const G4VSolid* pReference, const G4VSolid* pCandidate, G4int pPoints, G4String pName, G4double pTolerance = 1e-6);
+};
+
+#endif
+//
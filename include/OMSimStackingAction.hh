@@ -0,0 +1,30 @@
+/** @file OMSimStackingAction.hh
+ *  @brief Stacking action: photon culling at creation and photon recording of the shower library.
+ *
+ *  @date October 2026
+ *
+ *  @version Geant4 10.7
+ */
+
+#ifndef OMSimStackingAction_h
+#define OMSimStackingAction_h 1
+
+#include "G4UserStackingAction.hh"
+
+class OMSimPhotonCulling;
+class OMSimShowerLibrary;
+
+class OMSimStackingAction : public G4UserStackingAction
+{
+	public:
+		OMSimStackingAction();
+		~OMSimStackingAction();
+
+		G4ClassificationOfNewTrack ClassifyNewTrack(const G4Track* aTrack);
+
+	private:
+		OMSimPhotonCulling* mCulling;
+		OMSimShowerLibrary* mShowers;
+};
+
+#endif
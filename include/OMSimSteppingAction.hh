@@ -5,6 +5,14 @@
 #include "G4ThreeVector.hh"
 #include "G4UserSteppingAction.hh"
 #include "OMSimPMTQE.hh"
+#include "OMSimTrackGuard.hh"
+#include "OMSimPhotonCulling.hh"
+#include "OMSimImportanceBiasing.hh"
+#include "OMSimNextEventEstimator.hh"
+#include "OMSimPhotonCache.hh"
+#include "OMSimPhotonRecycling.hh"
+#include "OMSimAcceptanceTable.hh"
+#include "OMSimShowerLibrary.hh"
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 extern G4String gQEFile;
@@ -17,9 +25,23 @@ class OMSimSteppingAction : public G4UserSteppingAction
 
     void UserSteppingAction(const G4Step*);
     bool QEcheck(G4double lambda);
+    void BeginOfRun();
 
   private:
     OMSimPMTQE* pmt_qe = new OMSimPMTQE();
+    OMSimTrackGuard* mTrackGuard;
+    OMSimPhotonCulling* mCulling;
+    OMSimImportanceBiasing* mBiasing;
+    OMSimNextEventEstimator* mEstimator;
+    OMSimPhotonCache* mCache;
+    OMSimPhotonRecycling* mRecycling;
+    OMSimAcceptanceTable* mAcceptance;
+    OMSimShowerLibrary* mShowers;
+
+    // generator mode (gGeneratorMode) of the run, decoded once per run instead of comparing strings on every step
+    G4bool mShowerReplay = false;     // "showerlib"
+    G4bool mPropagationTable = false; // "proptable"
+    G4bool mAcceptanceTable = false;  // "acceptance"
 
 };
 
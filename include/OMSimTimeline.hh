@@ -0,0 +1,72 @@
+/** @file OMSimTimeline.hh
+ *  @brief Wall-clock spans written as a Chrome trace-format JSON file.
+ *
+ *  Open the timeline with a file name (gTimelineFile) and every OMSimScopedTimer that runs afterwards
+ *  ends up as a complete ("ph":"X") event. The file can be loaded in chrome://tracing or ui.perfetto.dev.
+ *  Each Geant4 thread gets its own track (tid 0 is the master / sequential thread).
+ *
+ *  @date October 2026
+ *
+ *  @version Geant4 10.7
+ */
+
+#ifndef OMSimTimeline_h
+#define OMSimTimeline_h 1
+
+#include "G4String.hh"
+#include "G4Types.hh"
+#include "G4Threading.hh"
+
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+class OMSimTimeline
+{
+public:
+    static OMSimTimeline* GetInstance();
+
+    void Open(G4String pFileName);
+    void Close();
+    G4bool IsActive() { return mActive; }
+    G4double Now();
+    void AddSpan(const G4String& pName, const G4String& pCategory, G4double pStart, G4double pDuration);
+
+private:
+    OMSimTimeline(){};
+
+    struct Span
+    {
+        G4String Name;
+        G4String Category;
+        G4double Start;    // microseconds since Open()
+        G4double Duration; // microseconds
+        G4int ThreadID;
+    };
+
+    std::atomic<G4bool> mActive{false}; // read without the lock by every OMSimScopedTimer
+    G4String mFileName;
+    std::chrono::steady_clock::time_point mOrigin;
+    std::vector<Span> mSpans;
+    std::vector<G4int> mThreads;
+};
+
+/**
+ * @class OMSimScopedTimer
+ * @brief Records a span on the timeline from construction to destruction. Costs one branch if the timeline is closed.
+ */
+class OMSimScopedTimer
+{
+public:
+    OMSimScopedTimer(const G4String& pName, const G4String& pCategory = "init");
+    ~OMSimScopedTimer();
+
+private:
+    G4String mName;
+    G4String mCategory;
+    G4double mStart;
+    G4bool mActive;
+};
+
+#endif
+//
@@ -0,0 +1,84 @@
+/** @file OMSimTrackGuard.hh
+ *  @brief Step and path-length budgets against looping tracks, with counters of the killed tracks per volume.
+ *
+ *  @date October 2026
+ *
+ *  @version Geant4 10.7
+ */
+
+#ifndef OMSimTrackGuard_h
+#define OMSimTrackGuard_h 1
+
+#include "G4String.hh"
+#include "G4Types.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <map>
+
+class G4Step;
+class G4OpBoundaryProcess;
+
+/**
+ * @class OMSimTrackGuard
+ * @brief Decides in the stepping action whether a track is stuck.
+ *
+ * A track is killed if
+ * - its total number of steps exceeds the global step budget,
+ * - it makes more consecutive steps, or travels a longer path, inside one volume than the budget of that volume allows,
+ * - an optical photon undergoes more consecutive total internal reflections than allowed (light trapped in glass or gel).
+ *
+ * Budgets of single logical volumes can be set in a json file (gTrackBudgetFile, see InputFile/TrackBudgets.json).
+ * Killed tracks are counted per logical volume and reason; the summary is printed at the end of each run.
+ */
+class OMSimTrackGuard
+{
+public:
+    static OMSimTrackGuard* GetInstance();
+
+    void LoadBudgets(G4String pFileName);
+    G4bool IsStuck(const G4Step* pStep);
+    void PrintSummary();
+    void Reset();
+
+private:
+    OMSimTrackGuard();
+
+    struct Budget
+    {
+        G4long MaxSteps;
+        G4double MaxPathLength;
+        G4long MaxTIR;
+    };
+
+    struct KillCounter
+    {
+        G4long Steps = 0;  // killed because of the volume step budget
+        G4long Path = 0;   // killed because of the volume path budget
+        G4long TIR = 0;    // killed because of a total internal reflection loop
+        G4long Total = 0;  // killed because of the global step budget
+        G4long WastedSteps = 0;
+    };
+
+    const Budget& GetBudget(const G4String& pVolume);
+    void Kill(const G4String& pVolume, G4long KillCounter::*pReason, G4long pSteps);
+    G4OpBoundaryProcess* FindBoundaryProcess();
+
+    G4long mMaxTotalSteps = 100000;
+    Budget mDefaultBudget = {100000, 1 * km, 500};
+    std::map<G4String, Budget> mVolumeBudgets;
+    std::map<G4String, KillCounter> mKilled;
+
+    // state of the track being stepped
+    G4int mTrackID = -1;
+    const void* mCurrentVolume = nullptr;
+    const Budget* mCurrentBudget = nullptr;
+    G4long mVolumeSteps = 0;
+    G4double mVolumePath = 0;
+    G4long mConsecutiveTIR = 0;
+
+    G4OpBoundaryProcess* mBoundaryProcess = nullptr;
+    G4bool mBoundarySearched = false;
+};
+
+#endif
+//
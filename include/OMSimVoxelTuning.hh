@@ -0,0 +1,63 @@
+/** @file OMSimVoxelTuning.hh
+ *  @brief Smartless and voxelisation settings of the dense logical volumes of the optical modules, stored in the OM json files.
+ *
+ *  @date October 2026
+ *
+ *  @version Geant4 10.7
+ */
+
+#ifndef OMSimVoxelTuning_h
+#define OMSimVoxelTuning_h 1
+
+#include "G4String.hh"
+#include "G4Types.hh"
+
+#include <utility>
+#include <vector>
+
+class G4LogicalVolume;
+class OMSimInputData;
+class abcDetectorComponent;
+
+/**
+ * @class OMSimVoxelTuning
+ * @brief Applies and records per logical volume voxelisation settings of an optical module.
+ *
+ * Geant4 voxelises every logical volume with the same quality (smartless = 2, the average number of slices per daughter).
+ * The gel of the mDOM (holder, 24 PMTs, 24 reflectors, LED cut-outs) and the inner volumes of the LOMs hold far more
+ * daughters than usual volumes, so another quality, or no voxelisation at all, can navigate faster. The settings of a
+ * module are an object "jVoxelTuning" in the json table of the module (abcDetectorComponent::GetDataKey()), one entry
+ * per logical volume name:
+ *
+ *     "jVoxelTuning": { "Gelcorpus logical": { "jSmartless": 4, "jOptimise": 1 } }
+ *
+ * A setting is keyed on the module and the volume name: it only applies to the logical volumes of that module
+ * (abcDetectorComponent::GetLogicalVolumes()), volumes of the same name elsewhere in the world are left alone. The
+ * detector construction hands the module to SetModule() after building it and applies the settings (gVoxelTuning).
+ * They are found by the tuning run of the main (gVoxelTuningEvents) and written to the json file with Record().
+ */
+class OMSimVoxelTuning
+{
+public:
+    struct Setting
+    {
+        G4double Smartless;
+        G4bool Optimise;
+    };
+
+    static void SetModule(OMSimInputData* pData, abcDetectorComponent* pModule);
+    static G4String GetModuleKey() { return mKey; }
+    static void Apply();
+    static std::vector<G4LogicalVolume*> GetDenseVolumes(G4int pMinDaughters);
+    static Setting Get(const G4LogicalVolume* pVolume);
+    static void Set(G4LogicalVolume* pVolume, const Setting& pSetting);
+    static G4bool Record(const std::vector<std::pair<G4String, Setting>>& pSettings);
+
+private:
+    static OMSimInputData* mData;                   // input data of the last constructed module
+    static G4String mKey;                           // json table of the last constructed module
+    static std::vector<G4LogicalVolume*> mVolumes;  // logical volumes of the last constructed module
+};
+
+#endif
+//
@@ -24,11 +24,16 @@ class Component {     // Struct of variables of component of a DetectorComponent
         G4ThreeVector Position; //Position of component wrt to 0
         G4RotationMatrix Rotation; //Rotation of component wrt to 0
         G4String Name; // Name of Component
+        G4int Levels = 7; // Bit mask of the detail levels (abcDetectorComponent::DetailLevel) at which the component is placed
 };
 
 class abcDetectorComponent
 {
 public:
+    /** Level of detail of a placement: minimal = vessel and everything inside, simplified = plus one merged proxy solid
+     *  per harness material and surface, full = plus every harness part on its own. */
+    enum DetailLevel { kMinimalDetail = 0, kSimplifiedDetail = 1, kFullDetail = 2 };
+
     abcDetectorComponent(){};
     virtual void Construction() = 0; // Abstract method you have to define in order to make a derived class from abcDetectorComponent
 
@@ -44,10 +49,16 @@ public:
     virtual Component GetComponent(G4String pName);
     G4Transform3D GetNewPosition(G4ThreeVector pPosition, G4RotationMatrix pRotation, G4ThreeVector pObjectPosition, G4RotationMatrix pObjectRotation);
     virtual void IntegrateDetectorComponent(abcDetectorComponent* pToIntegrate, G4ThreeVector pPosition, G4RotationMatrix pRotation, G4String pNameExtension);
-    virtual void PlaceIt(G4ThreeVector pPosition, G4RotationMatrix pRotation, G4LogicalVolume*& pMother, G4String pNameExtension = "");
+    void IntegrateHarness(abcDetectorComponent* pHarness, std::vector<G4String> pAllLevels = {});
+    virtual void PlaceIt(G4ThreeVector pPosition, G4RotationMatrix pRotation, G4LogicalVolume*& pMother, G4String pNameExtension = "", G4int pCopyNumber = 0, G4int pDetailLevel = kFullDetail);
     G4SubtractionSolid* SubstractToVolume(G4VSolid* pInputVolume, G4ThreeVector pSubstractionPos, G4RotationMatrix pSubstractionRot, G4String pNewVolumeName);
+    G4double GetBoundingRadius();
+    virtual G4String GetDataKey() { return ""; } // json table of the component in mData, "" if it has none
+    std::vector<G4LogicalVolume*> GetLogicalVolumes();
     
 protected:
+    void AppendHarnessProxies(const std::vector<Component*>& pParts);
+    void AddLeaves(G4MultiUnion* pUnion, G4VSolid* pSolid, G4Transform3D pTransform);
     
     const G4VisAttributes* mGlassVis = new G4VisAttributes(G4Colour(0.7, 0.7, 0.8, 0.2));
     const G4VisAttributes* mGelVis = new G4VisAttributes(G4Colour(0.45, 0.5, 0.35, 0.2));
@@ -0,0 +1,386 @@
+/** @file OMSimAcceptanceTable.cc
+ *  @brief Detection probability of each PMT for photons arriving at the module bounding sphere.
+ *
+ *  @date October 2026
+ *
+ *  @version Geant4 10.7
+ */
+
+#include "OMSimAcceptanceTable.hh"
+#include "OMSimPhotonInfo.hh"
+
+#include "G4PhysicalConstants.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4Track.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include "OMSimLogger.hh"
+
+extern G4double gAcceptanceLambdaMin;
+extern G4double gAcceptanceLambdaMax;
+extern G4double gAcceptanceMinPhotons;
+
+namespace
+{
+    // default binning of new tables
+    const G4int gDefaultNrCosTheta = 20;
+    const G4int gDefaultNrPhi = 24;
+    const G4int gDefaultNrLambda = 10;
+    const G4int gDefaultNrB = 4;
+    const G4int gDefaultNrPsi = 8;
+}
+
+OMSimAcceptanceTable* OMSimAcceptanceTable::GetInstance()
+{
+    static G4ThreadLocal OMSimAcceptanceTable* lInstance = nullptr;
+    if (!lInstance) lInstance = new OMSimAcceptanceTable();
+    return lInstance;
+}
+
+/**
+ * Define the bins of an empty table (for building).
+ */
+void OMSimAcceptanceTable::SetBinning(G4int pNrCosTheta, G4int pNrPhi, G4int pNrLambda, G4double pLambdaMin, G4double pLambdaMax,
+                                      G4int pNrB, G4int pNrPsi, G4int pNrPMTs, G4double pRadius)
+{
+    mNrCosTheta = pNrCosTheta;
+    mNrPhi = pNrPhi;
+    mNrLambda = pNrLambda;
+    mLambdaMin = pLambdaMin;
+    mLambdaMax = pLambdaMax;
+    mNrB = pNrB;
+    mNrPsi = pNrPsi;
+    mNrPMTs = pNrPMTs;
+    mRadius = pRadius;
+    const size_t lNrBins = (size_t)GetNumberOfBeamBins() * GetNumberOfImpactBins();
+    mPhotons.assign(lNrBins, 0);
+    mHits.assign(lNrBins * mNrPMTs, 0);
+    mProbabilities.assign(lNrBins * mNrPMTs, 0);
+    mAveraged.assign((size_t)GetNumberOfBeamBins() * mNrPMTs, 0);
+    mDetection.assign(lNrBins, 0);
+    mTableHash = mGeometryHash;
+    mLoaded = false;
+}
+
+/**
+ * Default binning, over the wavelength range gAcceptanceLambdaMin - gAcceptanceLambdaMax.
+ */
+void OMSimAcceptanceTable::SetDefaultBinning(G4int pNrPMTs, G4double pRadius)
+{
+    SetBinning(gDefaultNrCosTheta, gDefaultNrPhi, gDefaultNrLambda, gAcceptanceLambdaMin, gAcceptanceLambdaMax, gDefaultNrB, gDefaultNrPsi, pNrPMTs, pRadius);
+}
+
+G4int OMSimAcceptanceTable::GetDefaultNumberOfBeamBins()
+{
+    return gDefaultNrCosTheta * gDefaultNrPhi * gDefaultNrLambda;
+}
+
+/**
+ * Forget the table, the next building run starts with the default binning.
+ */
+void OMSimAcceptanceTable::Clear()
+{
+    mNrCosTheta = mNrPhi = mNrLambda = 0;
+    mPhotons.clear();
+    mHits.clear();
+    mProbabilities.clear();
+    mAveraged.clear();
+    mDetection.clear();
+    mLoaded = false;
+}
+
+/**
+ * FNV-1a hash, used to version tables against the geometry description.
+ */
+uint64_t OMSimAcceptanceTable::Hash(const std::string& pText)
+{
+    uint64_t lHash = 14695981039346656037ULL;
+    for (unsigned char c : pText)
+    {
+        lHash ^= c;
+        lHash *= 1099511628211ULL;
+    }
+    return lHash;
+}
+
+/**
+ * Called by the detector construction with the hash of the geometry it built. A loaded table of another geometry
+ * is dropped.
+ */
+void OMSimAcceptanceTable::SetGeometryHash(uint64_t pHash)
+{
+    mGeometryHash = pHash;
+    if (mLoaded && mTableHash != mGeometryHash)
+    {
+        error("Acceptance table was built for another geometry (%016llx, current %016llx), table not used",
+              (unsigned long long)mTableHash, (unsigned long long)mGeometryHash);
+        Clear();
+    }
+}
+
+/**
+ * Probabilities from the photon and hit counts. Impact bins with fewer than gAcceptanceMinPhotons photons are merged:
+ * they take the probabilities of their beam bin, averaged over all its impact bins.
+ * @return Number of merged impact bins
+ */
+G4int OMSimAcceptanceTable::UpdateProbabilities()
+{
+    const G4int lNrImpact = GetNumberOfImpactBins();
+    std::fill(mAveraged.begin(), mAveraged.end(), 0);
+    G4int lMerged = 0;
+    for (G4int i = 0; i < GetNumberOfBeamBins(); i++)
+    {
+        G4double lPhotons = 0;
+        for (G4int j = 0; j < lNrImpact; j++)
+        {
+            const size_t lBin = (size_t)i * lNrImpact + j;
+            lPhotons += mPhotons[lBin];
+            for (G4int k = 0; k < mNrPMTs; k++) mAveraged[(size_t)i * mNrPMTs + k] += mHits[lBin * mNrPMTs + k];
+        }
+        for (G4int k = 0; k < mNrPMTs; k++) mAveraged[(size_t)i * mNrPMTs + k] = lPhotons > 0 ? mAveraged[(size_t)i * mNrPMTs + k] / lPhotons : 0;
+
+        for (G4int j = 0; j < lNrImpact; j++)
+        {
+            const size_t lBin = (size_t)i * lNrImpact + j;
+            const G4bool lMerge = mPhotons[lBin] < gAcceptanceMinPhotons;
+            if (lMerge) lMerged++;
+            mDetection[lBin] = 0;
+            for (G4int k = 0; k < mNrPMTs; k++)
+            {
+                mProbabilities[lBin * mNrPMTs + k] = lMerge ? mAveraged[(size_t)i * mNrPMTs + k] : mHits[lBin * mNrPMTs + k] / mPhotons[lBin];
+                mDetection[lBin] += mProbabilities[lBin * mNrPMTs + k];
+            }
+        }
+    }
+    return lMerged;
+}
+
+/**
+ * Text format: comment lines start with #, a line "# geometry <hash>", then one line
+ *     nCosTheta nPhi nLambda lambdaMin[nm] lambdaMax[nm] nB nPsi nPMTs radius[mm]
+ * followed by one line per beam and impact bin
+ *     bin photons hits_PMT0 ... hits_PMTn
+ * with bin = beam bin * nB * nPsi + impact bin. Tables without impact bins (nB, nPsi missing) are read as well.
+ */
+G4bool OMSimAcceptanceTable::Load(G4String pFileName)
+{
+    std::ifstream lFile(pFileName.c_str());
+    if (!lFile.is_open())
+    {
+        error("Could not open acceptance table %s", pFileName.c_str());
+        return false;
+    }
+    std::string lLine;
+    G4bool lHeader = true;
+    uint64_t lTableHash = 0;
+    while (std::getline(lFile, lLine))
+    {
+        if (lLine.rfind("# geometry ", 0) == 0)
+        {
+            lTableHash = std::stoull(lLine.substr(11), nullptr, 16);
+            continue;
+        }
+        if (lLine.empty() || lLine[0] == '#') continue;
+        std::istringstream lStream(lLine);
+        if (lHeader)
+        {
+            std::vector<G4double> lValues;
+            G4double lValue;
+            while (lStream >> lValue) lValues.push_back(lValue);
+            if (lValues.size() == 7) lValues.insert(lValues.begin() + 5, {1, 1});
+            if (lValues.size() != 9)
+            {
+                error("Malformed header in acceptance table %s", pFileName.c_str());
+                return false;
+            }
+            SetBinning((G4int)lValues[0], (G4int)lValues[1], (G4int)lValues[2], lValues[3] * nm, lValues[4] * nm,
+                       (G4int)lValues[5], (G4int)lValues[6], (G4int)lValues[7], lValues[8] * mm);
+            lHeader = false;
+            continue;
+        }
+        size_t lBin;
+        lStream >> lBin;
+        if (lBin >= mPhotons.size()) continue;
+        lStream >> mPhotons[lBin];
+        for (G4int k = 0; k < mNrPMTs; k++) lStream >> mHits[lBin * mNrPMTs + k];
+    }
+    if (lHeader) return false;
+    const G4int lMerged = UpdateProbabilities();
+    if (lMerged > 0)
+    {
+        warning("%d of %d impact bins of acceptance table %s have fewer than %.0f photons and use the probabilities of their beam bin",
+                lMerged, (G4int)mPhotons.size(), pFileName.c_str(), gAcceptanceMinPhotons);
+    }
+    mTableHash = lTableHash;
+    mLoaded = true;
+    info("Acceptance table %s loaded (%d x %d bins, %d PMTs)", pFileName.c_str(), GetNumberOfBeamBins(), GetNumberOfImpactBins(), mNrPMTs);
+    if (mGeometryHash != 0) SetGeometryHash(mGeometryHash);
+    return mLoaded;
+}
+
+void OMSimAcceptanceTable::Save(G4String pFileName)
+{
+    std::ofstream lFile(pFileName.c_str());
+    if (!lFile.is_open())
+    {
+        error("Could not write acceptance table %s", pFileName.c_str());
+        return;
+    }
+    lFile << "# OMSim acceptance table v2: photons arriving at the bounding sphere, hits per PMT" << std::endl;
+    lFile << "# geometry " << std::hex << std::setw(16) << std::setfill('0') << mTableHash << std::dec << std::setfill(' ') << std::endl;
+    lFile << "# nCosTheta nPhi nLambda lambdaMin[nm] lambdaMax[nm] nB nPsi nPMTs radius[mm]" << std::endl;
+    lFile << mNrCosTheta << " " << mNrPhi << " " << mNrLambda << " " << mLambdaMin / nm << " " << mLambdaMax / nm << " "
+          << mNrB << " " << mNrPsi << " " << mNrPMTs << " " << mRadius / mm << std::endl;
+    lFile << "# bin photons hits_PMT0 ... hits_PMTn" << std::endl;
+    for (size_t i = 0; i < mPhotons.size(); i++)
+    {
+        if (mPhotons[i] == 0) continue;
+        lFile << i << " " << mPhotons[i];
+        for (G4int k = 0; k < mNrPMTs; k++) lFile << " " << mHits[i * mNrPMTs + k];
+        lFile << std::endl;
+    }
+    info("Acceptance table written to %s", pFileName.c_str());
+}
+
+/**
+ * @param pDirection Direction of travel in the module frame (unit vector)
+ * @param pLambda Wavelength
+ * @return Beam bin index, -1 if the wavelength is outside of the table
+ */
+G4int OMSimAcceptanceTable::FindBin(const G4ThreeVector& pDirection, G4double pLambda)
+{
+    if (pLambda < mLambdaMin || pLambda >= mLambdaMax) return -1;
+    const G4int lCos = std::min(mNrCosTheta - 1, (G4int)((pDirection.z() + 1) / 2 * mNrCosTheta));
+    const G4int lPhi = std::min(mNrPhi - 1, (G4int)((pDirection.phi() + pi) / twopi * mNrPhi));
+    const G4int lLambda = (G4int)((pLambda - mLambdaMin) / (mLambdaMax - mLambdaMin) * mNrLambda);
+    return (lCos * mNrPhi + lPhi) * mNrLambda + lLambda;
+}
+
+/**
+ * Orthonormal basis of the disk perpendicular to the beam: e1 along z x direction (x for beams along z), e2 = direction x e1.
+ */
+void OMSimAcceptanceTable::DiskBasis(const G4ThreeVector& pDirection, G4ThreeVector& pE1, G4ThreeVector& pE2)
+{
+    pE1 = G4ThreeVector(0, 0, 1).cross(pDirection);
+    pE1 = pE1.mag2() < 1e-12 ? G4ThreeVector(1, 0, 0) : pE1.unit();
+    pE2 = pDirection.cross(pE1);
+}
+
+/**
+ * @param pDirection Direction of travel
+ * @param pFromCenter Any point of the photon line, relative to the module center
+ * @return Impact bin of the photon line, -1 if it misses the bounding sphere
+ */
+G4int OMSimAcceptanceTable::FindImpactBin(const G4ThreeVector& pDirection, const G4ThreeVector& pFromCenter)
+{
+    G4ThreeVector lE1, lE2;
+    DiskBasis(pDirection, lE1, lE2);
+    const G4double lX = pFromCenter.dot(lE1) / mRadius;
+    const G4double lY = pFromCenter.dot(lE2) / mRadius;
+    const G4double lB2 = lX * lX + lY * lY;
+    if (lB2 >= 1) return -1;
+    const G4int lB = std::min(mNrB - 1, (G4int)(lB2 * mNrB));
+    const G4int lPsi = std::min(mNrPsi - 1, (G4int)((std::atan2(lY, lX) + pi) / twopi * mNrPsi));
+    return lB * mNrPsi + lPsi;
+}
+
+/**
+ * Random direction and wavelength uniformly distributed inside a beam bin.
+ */
+void OMSimAcceptanceTable::SampleBin(G4int pBin, G4ThreeVector& pDirection, G4double& pLambda)
+{
+    const G4int lLambda = pBin % mNrLambda;
+    const G4int lPhi = (pBin / mNrLambda) % mNrPhi;
+    const G4int lCos = pBin / (mNrLambda * mNrPhi);
+    const G4double lCosTheta = -1 + 2. * (lCos + G4UniformRand()) / mNrCosTheta;
+    const G4double lPhiValue = -pi + twopi * (lPhi + G4UniformRand()) / mNrPhi;
+    const G4double lSinTheta = std::sqrt(std::max(0., 1 - lCosTheta * lCosTheta));
+    pDirection = G4ThreeVector(lSinTheta * std::cos(lPhiValue), lSinTheta * std::sin(lPhiValue), lCosTheta);
+    pLambda = mLambdaMin + (mLambdaMax - mLambdaMin) * (lLambda + G4UniformRand()) / mNrLambda;
+}
+
+/**
+ * @return Probability that a photon of this beam bin arriving at the bounding sphere (uniform over the disk) is detected by PMT pPMT
+ */
+G4double OMSimAcceptanceTable::GetProbability(G4int pBin, G4int pPMT)
+{
+    if (pBin < 0 || pPMT < 0 || pPMT >= mNrPMTs || mAveraged.empty()) return 0;
+    return mAveraged[(size_t)pBin * mNrPMTs + pPMT];
+}
+
+/**
+ * @return Probability that a photon of this beam and impact bin is detected by PMT pPMT
+ */
+G4double OMSimAcceptanceTable::GetProbability(G4int pBin, G4int pImpactBin, G4int pPMT)
+{
+    if (pBin < 0 || pImpactBin < 0 || pPMT < 0 || pPMT >= mNrPMTs || mProbabilities.empty()) return 0;
+    return mProbabilities[((size_t)pBin * GetNumberOfImpactBins() + pImpactBin) * mNrPMTs + pPMT];
+}
+
+/**
+ * @return Probability that a photon of this beam and impact bin is detected by any PMT
+ */
+G4double OMSimAcceptanceTable::GetDetectionProbability(G4int pBin, G4int pImpactBin)
+{
+    if (pBin < 0 || pImpactBin < 0 || mDetection.empty()) return 0;
+    return mDetection[(size_t)pBin * GetNumberOfImpactBins() + pImpactBin];
+}
+
+/**
+ * Draw the PMT that detects a photon of this beam and impact bin (a photon is detected by at most one PMT).
+ * @return PMT number, -1 if the photon is not detected
+ */
+G4int OMSimAcceptanceTable::SamplePMT(G4int pBin, G4int pImpactBin)
+{
+    if (pBin < 0 || pImpactBin < 0 || mProbabilities.empty()) return -1;
+    G4double lRandom = G4UniformRand();
+    const size_t lOffset = ((size_t)pBin * GetNumberOfImpactBins() + pImpactBin) * mNrPMTs;
+    for (G4int k = 0; k < mNrPMTs; k++)
+    {
+        lRandom -= mProbabilities[lOffset + k];
+        if (lRandom < 0) return k;
+    }
+    return -1;
+}
+
+/**
+ * Draw the PMT of a photon of this beam and impact bin that is known to be detected.
+ * @return PMT number, -1 if no PMT of the bin has hits
+ */
+G4int OMSimAcceptanceTable::SampleDetectingPMT(G4int pBin, G4int pImpactBin)
+{
+    const G4double lTotal = GetDetectionProbability(pBin, pImpactBin);
+    if (lTotal <= 0) return -1;
+    G4double lRandom = G4UniformRand() * lTotal;
+    const size_t lOffset = ((size_t)pBin * GetNumberOfImpactBins() + pImpactBin) * mNrPMTs;
+    for (G4int k = 0; k < mNrPMTs; k++)
+    {
+        lRandom -= mProbabilities[lOffset + k];
+        if (lRandom < 0) return k;
+    }
+    return mNrPMTs - 1;
+}
+
+void OMSimAcceptanceTable::AddPhoton(G4int pBin, G4int pImpactBin)
+{
+    if (pBin < 0 || pBin >= GetNumberOfBeamBins() || pImpactBin < 0) return;
+    mPhotons[(size_t)pBin * GetNumberOfImpactBins() + pImpactBin] += 1;
+}
+
+/**
+ * Building: add the hit of a plane-wave photon to the bin of the current event. The impact bin is computed from
+ * the start point and direction of the photon.
+ */
+void OMSimAcceptanceTable::AddHit(const G4Track* pTrack, G4int pPMT, G4ThreeVector pCenter)
+{
+    if (mCurrentBin < 0 || mCurrentBin >= GetNumberOfBeamBins() || pPMT < 0 || pPMT >= mNrPMTs) return;
+    const G4int lImpact = FindImpactBin(pTrack->GetVertexMomentumDirection(), OMSimPhotonInfo::GetOriginalVertex(pTrack) - pCenter);
+    if (lImpact < 0) return;
+    mHits[((size_t)mCurrentBin * GetNumberOfImpactBins() + lImpact) * mNrPMTs + pPMT] += 1;
+}
@@ -2,9 +2,15 @@
 #include "G4ios.hh"
 //since Geant4.10: include units manually
 #include "G4SystemOfUnits.hh"
+#include "OMSimProbes.hh"
+#include "OMSimPhotonInfo.hh"
+#include "G4Track.hh"
+
+#include <algorithm>
 
 extern G4int gDOM;
 extern G4String ghitsfilename;
+extern G4String gHittype;
 
 OMSimAnalysisManager::OMSimAnalysisManager(){
     std::cerr << "OMSimAnalysisManager is generated" << std::endl;}
@@ -15,6 +21,7 @@ void OMSimAnalysisManager::Write()
 {
 	if(datafile.is_open())
 	{
+        OMSIM_PROBE2(output_flush, stats_event_id.size(), 0);
         G4cout << "+++++++++++++The size of this event is " << stats_event_id.size() << " ++++++++++++" << G4endl;
         for (int i = 0; i < (int) stats_event_id.size(); i++)
         {
@@ -32,6 +39,8 @@ void OMSimAnalysisManager::Write()
             datafile << stats_vertex_position.at(i).y()/m << "\t";
             datafile << stats_vertex_position.at(i).z()/m << "\t";
             datafile << stats_positron_id.at(i) << "\t";
+            if (modules > 1) datafile << stats_module_id.at(i) << "\t";
+            if (weighted) datafile << std::scientific << stats_weight.at(i) << std::fixed << "\t";
            // datafile << stats_photon_direction.at(i).x() << "\t";
             //datafile << stats_photon_direction.at(i).y() << "\t";
             //datafile << stats_photon_direction.at(i).z() << "\t";
@@ -47,30 +56,81 @@ void OMSimAnalysisManager::Write()
 
 }
 
-void OMSimAnalysisManager::WriteAccept()
+/**
+ * Store a detected photon. Photon vertex and positron id are those of the photon that was emitted (copies of split
+ * or recycled photons keep them).
+ * @param pPMT PMT number
+ * @param pModule ID of the module the PMT belongs to
+ * @param pTrack Detected photon
+ * @param pPosition Position of the detection
+ * @param pTime Global time of the detection
+ */
+void OMSimAnalysisManager::AddHit(G4int pPMT, G4int pModule, const G4Track* pTrack, G4ThreeVector pPosition, G4double pTime)
 {
-	int num_pmts;
-	if (gDOM==0){num_pmts = 1;} //single PMT
-	else if (gDOM==1){num_pmts = 24;} //mDOM
-	else if (gDOM==2){num_pmts = 1;} //PDOM
-	else if (gDOM==3){num_pmts = 16;} //LOM16
-	else if (gDOM==4){num_pmts = 18;} //LOM18
-	else if (gDOM==5){num_pmts = 2;} //DEGG
-        else{num_pmts = 99;} //custom
+	AddHit(pPMT, pModule, pTrack->GetWeight(), pPosition, pTrack->GetMomentumDirection(), pTime, pTrack->GetLocalTime(), pTrack->GetTrackLength(),
+	       pTrack->GetKineticEnergy(), OMSimPhotonInfo::GetOriginalVertex(pTrack), OMSimPhotonInfo::GetAncestorID(pTrack));
+}
 
+/**
+ * Store a hit that was not produced by a tracked photon (parametric modes).
+ * @param pFlightTime Time between emission and detection
+ * @param pTrackLength Path length of the photon
+ * @param pEnergy Photon energy
+ * @param pVertex Emission point
+ * @param pAncestorID Id of the positron that emitted the photon
+ */
+void OMSimAnalysisManager::AddHit(G4int pPMT, G4int pModule, G4double pWeight, G4ThreeVector pPosition, G4ThreeVector pDirection, G4double pTime, G4double pFlightTime,
+                                  G4double pTrackLength, G4double pEnergy, G4ThreeVector pVertex, G4int pAncestorID)
+{
+	stats_PMT_hit.push_back(pPMT);
+	stats_module_id.push_back(pModule);
+	stats_weight.push_back(pWeight);
+	total_hit_weight += pWeight;
+	if (gHittype == "individual") {
+		stats_photon_direction.push_back(pDirection);
+		stats_photon_position.push_back(pPosition);
+		stats_event_id.push_back(current_event_id);
+		stats_photon_flight_time.push_back(pFlightTime);
+		stats_photon_track_length.push_back(pTrackLength/m);
+		stats_hit_time.push_back(pTime /ns);
+		stats_photon_energy.push_back(pEnergy/eV);
+		stats_event_distance.push_back((pVertex - pPosition).mag()/m);
+		stats_vertex_position.push_back(pVertex);
+		stats_positron_id.push_back(pAncestorID);
+	}
+}
 
+/**
+ * @return Number of PMTs of the selected module (gDOM)
+ */
+G4int OMSimAnalysisManager::GetNumberOfPMTs()
+{
+	if (gDOM==0){return 1;} //single PMT
+	else if (gDOM==1){return 24;} //mDOM
+	else if (gDOM==2){return 1;} //PDOM
+	else if (gDOM==3){return 16;} //LOM16
+	else if (gDOM==4){return 18;} //LOM18
+	else if (gDOM==5){return 2;} //DEGG
+	return 99; //custom
+}
 
+void OMSimAnalysisManager::WriteAccept()
+{
+	int num_pmts = GetNumberOfPMTs();
+	int num_channels = num_pmts * std::max(1, modules); // module after module
 
 	//int	pmthits[num_pmts+1] = {0};
-        std::vector<int> pmthits(num_pmts+1, 0);
-	int sum = 0;
+        std::vector<G4double> pmthits(num_channels+1, 0);
+	G4double sum = 0;
 
+	OMSIM_PROBE2(output_flush, stats_PMT_hit.size(), 1);
 	// repacking hits:
 	for (int i = 0; i < (int) stats_PMT_hit.size(); i++) {
-		pmthits[stats_PMT_hit.at(i)] += 1;
+		const int channel = std::max(0, stats_module_id.at(i)) * num_pmts + stats_PMT_hit.at(i);
+		if (channel < num_channels) pmthits[channel] += weighted ? stats_weight.at(i) : 1;
 	}
 	// wrinting collective hits
-	for (int j = 0; j < num_pmts; j++) {
+	for (int j = 0; j < num_channels; j++) {
 		datafile << "\t" << pmthits[j];
 		sum += pmthits[j];
 		pmthits[j] = 0;
@@ -88,7 +148,12 @@ void OMSimAnalysisManager::Reset()
 	stats_hit_time.clear();
 	stats_photon_energy.clear();
 	stats_PMT_hit.clear();
+	stats_module_id.clear();
 	stats_photon_direction.clear();
 	stats_photon_position.clear();
+	stats_vertex_position.clear();
+	stats_event_distance.clear();
+	stats_positron_id.clear();
+	stats_weight.clear();
 
 }
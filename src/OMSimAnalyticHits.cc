@@ -0,0 +1,312 @@
+/** @file OMSimAnalyticHits.cc
+ *  @brief Expected hits per PMT of IBD positrons from tabulated light yield, ice propagation and module acceptance.
+ *
+ *  @date October 2026
+ *
+ *  @version Geant4 10.7
+ */
+
+#include "OMSimAnalyticHits.hh"
+#include "OMSimAcceptanceTable.hh"
+#include "OMSimAnalysisManager.hh"
+#include "OMSimModuleBounds.hh"
+#include "OMSimPropagationTable.hh"
+
+#include "G4LogicalVolume.hh"
+#include "G4Material.hh"
+#include "G4Navigator.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4Poisson.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4TransportationManager.hh"
+#include "G4VPhysicalVolume.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+
+#include "OMSimLogger.hh"
+
+extern OMSimAnalysisManager gAnalysisManager;
+extern G4String ghitsfilename;
+extern G4String gAcceptanceTableFile;
+extern G4String gPropagationTableFile;
+extern G4double gAnalyticTrackLength;
+extern G4int gAnalyticSamples;
+
+namespace
+{
+    // angular distribution of the Cherenkov light of electromagnetic cascades, a exp(b |cos - 1/n|^c) + d
+    // (Raedel & Wiebusch, Astropart. Phys. 38 (2012) 53, electrons)
+    const G4double gAngularA = 4.27033;
+    const G4double gAngularB = -6.02527;
+    const G4double gAngularC = 0.29887;
+    const G4double gAngularD = -0.00103;
+
+    const G4int gSpectrumPoints = 100;
+}
+
+OMSimAnalyticHits* OMSimAnalyticHits::GetInstance()
+{
+    static G4ThreadLocal OMSimAnalyticHits* lInstance = nullptr;
+    if (!lInstance) lInstance = new OMSimAnalyticHits();
+    return lInstance;
+}
+
+/**
+ * Load the tables and tabulate the Frank-Tamm spectrum in the wavelength range of the acceptance table. Called with
+ * the first positron, when the geometry (and so the geometry hash of the acceptance table) is known.
+ */
+G4bool OMSimAnalyticHits::Initialise()
+{
+    mInitialised = true;
+    OMSimAcceptanceTable* lAcceptance = OMSimAcceptanceTable::GetInstance();
+    if (!lAcceptance->IsLoaded() && !lAcceptance->Load(gAcceptanceTableFile))
+    {
+        error("Analytic mode needs an acceptance table of the module (gAcceptanceTableFile), no hits are produced");
+        return false;
+    }
+    OMSimPropagationTable* lPropagation = OMSimPropagationTable::GetInstance();
+    if (!lPropagation->IsLoaded() && !lPropagation->Load(gPropagationTableFile))
+    {
+        warning("No propagation table (gPropagationTableFile), only positrons close to the module produce hits");
+    }
+
+    G4VPhysicalVolume* lWorld = G4TransportationManager::GetTransportationManager()->GetNavigatorForTracking()->GetWorldVolume();
+    G4MaterialPropertiesTable* lMPT = lWorld->GetLogicalVolume()->GetMaterial()->GetMaterialPropertiesTable();
+    if (lMPT)
+    {
+        mRefractiveIndex = lMPT->GetProperty("RINDEX");
+        mAbsorptionLength = lMPT->GetProperty("ABSLENGTH");
+        mScatteringLength = lMPT->GetProperty("MIEHG");
+    }
+    if (!mRefractiveIndex || !mAbsorptionLength || !mScatteringLength)
+    {
+        error("World material has no RINDEX, ABSLENGTH or MIEHG, analytic mode disabled");
+        return false;
+    }
+    mModuleRadius = lAcceptance->GetRadius();
+
+    // Frank-Tamm: d^2N / dx dlambda = 2 pi alpha / lambda^2 (1 - 1 / n^2) for beta = 1
+    mLambda.resize(gSpectrumPoints);
+    mCumulative.assign(gSpectrumPoints, 0);
+    auto lDensity = [&](G4double pLambda) {
+        const G4double lN = mRefractiveIndex->Value(h_Planck * c_light / pLambda);
+        return twopi * fine_structure_const / (pLambda * pLambda) * std::max(0., 1 - 1 / (lN * lN));
+    };
+    for (G4int i = 0; i < gSpectrumPoints; i++)
+    {
+        mLambda[i] = lAcceptance->GetLambdaMin() + (lAcceptance->GetLambdaMax() - lAcceptance->GetLambdaMin()) * i / (gSpectrumPoints - 1);
+        if (i > 0) mCumulative[i] = mCumulative[i - 1] + 0.5 * (lDensity(mLambda[i - 1]) + lDensity(mLambda[i])) * (mLambda[i] - mLambda[i - 1]);
+    }
+    mYieldPerLength = mCumulative.back();
+    if (mYieldPerLength <= 0)
+    {
+        error("No Cherenkov light in the wavelength range of the acceptance table, analytic mode disabled");
+        return false;
+    }
+    for (G4double& lValue : mCumulative) lValue /= mYieldPerLength;
+
+    Reset();
+    info("Analytic mode: %.1f Cherenkov photons per cm between %.0f and %.0f nm", mYieldPerLength * cm,
+         lAcceptance->GetLambdaMin() / nm, lAcceptance->GetLambdaMax() / nm);
+    return true;
+}
+
+G4double OMSimAnalyticHits::SampleWavelength()
+{
+    const G4double lRandom = G4UniformRand();
+    const size_t i = std::max<size_t>(1, std::lower_bound(mCumulative.begin(), mCumulative.end(), lRandom) - mCumulative.begin());
+    const G4double lFraction = (lRandom - mCumulative[i - 1]) / std::max(1e-12, mCumulative[i] - mCumulative[i - 1]);
+    return mLambda[i - 1] + lFraction * (mLambda[i] - mLambda[i - 1]);
+}
+
+/**
+ * Angle between a photon and the positron direction, by rejection from the cascade parametrisation.
+ */
+G4double OMSimAnalyticHits::SampleCosTheta(G4double pLambda)
+{
+    const G4double lCosCherenkov = 1. / mRefractiveIndex->Value(h_Planck * c_light / pLambda);
+    const G4double lMax = gAngularA + gAngularD;
+    while (true)
+    {
+        const G4double lCos = 2 * G4UniformRand() - 1;
+        const G4double lValue = gAngularA * std::exp(gAngularB * std::pow(std::abs(lCos - lCosCherenkov), gAngularC)) + gAngularD;
+        if (G4UniformRand() * lMax < lValue) return lCos;
+    }
+}
+
+/**
+ * Follow a photon line to the module bounding sphere and store its contribution.
+ * @param pModule Module index (OMSimModuleBounds)
+ * @param pFromCenter Start point relative to the module center
+ * @param pExpected Number of photons on this line
+ * @param pTime Time already spent before the start point
+ */
+void OMSimAnalyticHits::AddStraightPath(G4int pModule, G4ThreeVector pFromCenter, G4ThreeVector pDirection, G4double pLambda, G4double pExpected, G4double pTime)
+{
+    const G4double lB = pFromCenter.dot(pDirection);
+    const G4double lDiscriminant = lB * lB - pFromCenter.mag2() + mModuleRadius * mModuleRadius;
+    if (lDiscriminant <= 0) return;
+    const G4double lDistance = -lB - std::sqrt(lDiscriminant);
+    if (lDistance < 0) return;
+
+    OMSimAcceptanceTable* lAcceptance = OMSimAcceptanceTable::GetInstance();
+    const G4int lBin = lAcceptance->FindBin(pDirection, pLambda);
+    const G4int lImpact = lAcceptance->FindImpactBin(pDirection, pFromCenter);
+    const G4double lDetection = lAcceptance->GetDetectionProbability(lBin, lImpact);
+    if (lDetection <= 0) return;
+
+    const G4double lEnergy = h_Planck * c_light / pLambda;
+    const G4double lAttenuation = std::exp(-lDistance * (1. / mAbsorptionLength->Value(lEnergy) + 1. / mScatteringLength->Value(lEnergy)));
+    const G4double lExpected = pExpected * lAttenuation * lDetection;
+    const G4double lTime = pTime + lDistance * mRefractiveIndex->Value(lEnergy) / c_light;
+    mContributions.push_back({pModule, lBin, lImpact, lExpected, lTime, pLambda, pFromCenter + lDistance * pDirection, pDirection});
+    mExpectedBins[(size_t)lBin * lAcceptance->GetNumberOfImpactBins() + lImpact] += pExpected * lAttenuation;
+}
+
+/**
+ * Contributions of the light of one positron to one module, treated as if it were alone (the propagation table knows
+ * no shadowing by other modules), with its own emission samples.
+ * @param pModule Module index (OMSimModuleBounds)
+ * @param pPosition Vertex
+ * @param pAxis Direction of the positron (unit vector)
+ * @param pShare Number of photons per emission sample
+ */
+void OMSimAnalyticHits::AddModule(G4int pModule, G4ThreeVector pPosition, G4ThreeVector pAxis, G4double pShare)
+{
+    const G4ThreeVector lE1 = pAxis.orthogonal().unit();
+    const G4ThreeVector lE2 = pAxis.cross(lE1);
+    const G4ThreeVector lFromCenter = pPosition - OMSimModuleBounds::GetModule(pModule).Center;
+    const G4double lR = lFromCenter.mag();
+
+    OMSimPropagationTable* lPropagation = OMSimPropagationTable::GetInstance();
+    const G4bool lDirect = !lPropagation->IsLoaded() || lR < lPropagation->GetInnerRadius();
+    const G4double lInnerRadius = lPropagation->GetInnerRadius();
+
+    for (G4int i = 0; i < gAnalyticSamples; i++)
+    {
+        const G4double lLambda = SampleWavelength();
+        const G4double lCos = SampleCosTheta(lLambda);
+        const G4double lSin = std::sqrt(std::max(0., 1 - lCos * lCos));
+        const G4double lPhi = twopi * G4UniformRand();
+        const G4ThreeVector lDirection = lCos * pAxis + lSin * (std::cos(lPhi) * lE1 + std::sin(lPhi) * lE2);
+
+        if (lDirect)
+        {
+            AddStraightPath(pModule, lFromCenter, lDirection, lLambda, pShare, 0);
+            continue;
+        }
+
+        // through the ice to the inner sphere of the propagation table, then straight to the module
+        const G4int lBin = lPropagation->FindBin(lR, -lDirection.dot(lFromCenter) / lR, lLambda);
+        const G4double lProbability = lPropagation->GetArrivalProbability(lBin);
+        if (lProbability <= 0) continue;
+        const std::vector<OMSimPropagationTable::Arrival>& lArrivals = lPropagation->GetArrivals(lBin);
+        if (lArrivals.empty()) continue;
+
+        G4ThreeVector lX, lY, lZ;
+        OMSimPropagationTable::LocalFrame(lFromCenter, lDirection, lX, lY, lZ);
+        const G4double lWeight = pShare * lProbability / lArrivals.size();
+        for (size_t k = 0; k < lArrivals.size(); k++)
+        {
+            const OMSimPropagationTable::Arrival& lArrival = lArrivals[k];
+            const G4ThreeVector lYk = (k % 2) ? -lY : lY; // mirror symmetry of the local frame
+            const G4ThreeVector lPosition = (lArrival.Position[0] * lX + lArrival.Position[1] * lYk + lArrival.Position[2] * lZ).unit();
+            const G4ThreeVector lArrivalDirection = (lArrival.Direction[0] * lX + lArrival.Direction[1] * lYk + lArrival.Direction[2] * lZ).unit();
+            AddStraightPath(pModule, lInnerRadius * lPosition, lArrivalDirection, lLambda, lWeight, lArrival.Delay * ns);
+        }
+    }
+}
+
+/**
+ * Expected hits of one positron in all modules and their Poisson realisation.
+ * @param pPosition Vertex
+ * @param pDirection Direction of the positron
+ * @param pEnergy Kinetic energy
+ * @param pTime Time of the interaction
+ * @param pID Positron id written to the hits
+ */
+void OMSimAnalyticHits::AddPositron(G4ThreeVector pPosition, G4ThreeVector pDirection, G4double pEnergy, G4double pTime, G4int pID)
+{
+    if (!mInitialised) mActive = Initialise();
+    if (!mActive || OMSimModuleBounds::GetNumberOfModules() == 0) return;
+    mPositrons++;
+
+    const G4double lPhotons = mYieldPerLength * gAnalyticTrackLength * pEnergy / MeV;
+    if (lPhotons <= 0 || gAnalyticSamples <= 0) return;
+
+    mContributions.clear();
+    for (G4int lModule = 0; lModule < OMSimModuleBounds::GetNumberOfModules(); lModule++)
+    {
+        AddModule(lModule, pPosition, pDirection.unit(), lPhotons / gAnalyticSamples);
+    }
+
+    G4double lTotal = 0;
+    std::vector<G4double> lCumulative(mContributions.size());
+    for (size_t i = 0; i < mContributions.size(); i++)
+    {
+        lTotal += mContributions[i].Expected;
+        lCumulative[i] = lTotal;
+    }
+    mExpected += lTotal;
+    if (lTotal <= 0) return;
+
+    OMSimAcceptanceTable* lAcceptance = OMSimAcceptanceTable::GetInstance();
+    const G4long lHits = G4Poisson(lTotal);
+    for (G4long i = 0; i < lHits; i++)
+    {
+        const size_t lIndex = std::min(mContributions.size() - 1, (size_t)(std::upper_bound(lCumulative.begin(), lCumulative.end(), G4UniformRand() * lTotal) - lCumulative.begin()));
+        const Contribution& lHit = mContributions[lIndex];
+        const G4int lPMT = lAcceptance->SampleDetectingPMT(lHit.Bin, lHit.ImpactBin);
+        if (lPMT < 0) continue;
+        const G4double lEnergy = h_Planck * c_light / lHit.Lambda;
+        gAnalysisManager.AddHit(lPMT, lHit.Module, 1, OMSimModuleBounds::GetModule(lHit.Module).Center + lHit.Position, lHit.Direction, pTime + lHit.Time, lHit.Time,
+                                   lHit.Time * c_light / mRefractiveIndex->Value(lEnergy), lEnergy, pPosition, pID);
+        if (lPMT < (G4int)mSampled.size()) mSampled[lPMT]++;
+        mHits++;
+    }
+}
+
+/**
+ * Print the expected and the sampled hits per PMT of the run and append the expected hits per PMT and their total
+ * (one line per run) to <hits file>.expected.
+ */
+void OMSimAnalyticHits::PrintSummary()
+{
+    if (!mActive || mPositrons == 0) return;
+    OMSimAcceptanceTable* lAcceptance = OMSimAcceptanceTable::GetInstance();
+    const G4int lNrImpact = lAcceptance->GetNumberOfImpactBins();
+    std::vector<G4double> lExpected(lAcceptance->GetNumberOfPMTs(), 0);
+    for (size_t lBin = 0; lBin < mExpectedBins.size(); lBin++)
+    {
+        if (mExpectedBins[lBin] <= 0) continue;
+        for (G4int k = 0; k < lAcceptance->GetNumberOfPMTs(); k++)
+        {
+            lExpected[k] += mExpectedBins[lBin] * lAcceptance->GetProbability(lBin / lNrImpact, lBin % lNrImpact, k);
+        }
+    }
+
+    G4cout << "::::::::::::Analytic hits (" << mPositrons << " positrons):::::::::::" << G4endl;
+    G4cout << std::setw(6) << "PMT" << std::setw(16) << "expected hits" << std::setw(14) << "sampled" << G4endl;
+    std::ofstream lFile((ghitsfilename + ".expected").c_str(), std::ios::out | std::ios::app);
+    for (size_t k = 0; k < lExpected.size(); k++)
+    {
+        G4cout << std::setw(6) << k << std::setw(16) << lExpected[k] << std::setw(14) << mSampled[k] << G4endl;
+        if (lFile.is_open()) lFile << lExpected[k] << "\t";
+    }
+    G4cout << "total: " << mExpected << " expected, " << mHits << " sampled" << G4endl;
+    if (lFile.is_open()) lFile << mExpected << std::endl;
+}
+
+void OMSimAnalyticHits::Reset()
+{
+    OMSimAcceptanceTable* lAcceptance = OMSimAcceptanceTable::GetInstance();
+    mExpectedBins.assign((size_t)lAcceptance->GetNumberOfBeamBins() * lAcceptance->GetNumberOfImpactBins(), 0);
+    mSampled.assign(lAcceptance->GetNumberOfPMTs(), 0);
+    mExpected = 0;
+    mHits = 0;
+    mPositrons = 0;
+}
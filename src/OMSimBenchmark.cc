@@ -0,0 +1,70 @@
+/** @file OMSimBenchmark.cc
+ *  @brief Timing of simulation setups, shared by the benchmark and tuning drivers of the main.
+ *
+ *  @date October 2026
+ *
+ *  @version Geant4 10.7
+ */
+
+#include "OMSimBenchmark.hh"
+#include "OMSimAnalysisManager.hh"
+#include "OMSimTimeline.hh"
+
+#include "G4RunManager.hh"
+
+#include <chrono>
+#include <memory>
+
+extern G4String ghitsfilename;
+extern G4long gcounter;
+extern G4long gBoundarySteps;
+extern G4long gPhotonTracks;
+extern OMSimAnalysisManager gAnalysisManager;
+
+/**
+ * @param pTableName Suffix of the table file, <hits file>.<pTableName>
+ */
+OMSimBenchmark::OMSimBenchmark(G4RunManager* pRunManager, G4String pTableName)
+    : mRunManager(pRunManager)
+{
+    Keep(ghitsfilename);
+    mTable.open((ghitsfilename + "." + pTableName).c_str());
+    ghitsfilename = ghitsfilename + ".benchmark_hits";
+}
+
+OMSimBenchmark::~OMSimBenchmark()
+{
+    for (auto lRestore = mRestore.rbegin(); lRestore != mRestore.rend(); ++lRestore) (*lRestore)();
+    mRunManager->ReinitializeGeometry(true);
+}
+
+/**
+ * Build the geometry of the current globals, close it by an empty run and simulate pEvents events.
+ * @param pName Name of the span on the timeline, "" for none
+ * @param pRebuild true: construct the geometry again, false: only reoptimise (voxelise) the current one
+ */
+OMSimBenchmark::Result OMSimBenchmark::TimeSetup(G4int pEvents, G4String pName, G4bool pRebuild)
+{
+    std::unique_ptr<OMSimScopedTimer> lTimer(pName != "" ? new OMSimScopedTimer(pName, "run") : nullptr);
+    if (pRebuild) mRunManager->ReinitializeGeometry(true);
+    else mRunManager->GeometryHasBeenModified();
+    const auto lStart = std::chrono::steady_clock::now();
+    mRunManager->BeamOn(0);
+    const auto lBuilt = std::chrono::steady_clock::now();
+
+    const G4long lStepsBefore = gcounter;
+    const G4long lBoundaryBefore = gBoundarySteps;
+    const G4long lPhotonsBefore = gPhotonTracks;
+    const G4double lHitsBefore = gAnalysisManager.total_hit_weight;
+    if (pEvents > 0) mRunManager->BeamOn(pEvents);
+    const auto lEnd = std::chrono::steady_clock::now();
+
+    Result lResult;
+    lResult.Setup = std::chrono::duration<G4double>(lBuilt - lStart).count();
+    lResult.Run = std::chrono::duration<G4double>(lEnd - lBuilt).count();
+    lResult.Steps = gcounter - lStepsBefore;
+    lResult.BoundarySteps = gBoundarySteps - lBoundaryBefore;
+    lResult.Photons = gPhotonTracks - lPhotonsBefore;
+    lResult.Hits = gAnalysisManager.total_hit_weight - lHitsBefore;
+    return lResult;
+}
@@ -0,0 +1,449 @@
+/** @file OMSimCADMesh.cc
+ *  @brief Import of CAD meshes (with a binary cache) and preprocessing of their tessellated solids: decimation, merging and checks.
+ *
+ *  @date October 2026
+ *
+ *  @version Geant4 10.7
+ */
+
+#include "OMSimCADMesh.hh"
+#include "OMSimSolidCheck.hh"
+#include "CADMesh.hh"
+
+#include "G4SystemOfUnits.hh"
+#include "G4TessellatedSolid.hh"
+#include "G4TriangularFacet.hh"
+#include "G4VFacet.hh"
+#include "G4Voxelizer.hh"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <tuple>
+#include <unistd.h>
+
+#include "OMSimLogger.hh"
+
+extern G4double gCADDecimation;
+extern G4bool gCADMergeParts;
+extern G4int gCADMeshCheck;
+extern G4bool gCADCache;
+extern G4String gCADCacheDirectory;
+
+G4long OMSimCADMesh::mFacets = 0;
+
+namespace
+{
+    const char gMeshCacheMagic[8] = {'O', 'M', 'S', 'I', 'M', 'C', 'M', '1'};
+
+    /**
+     * FNV-1a hash of a block of memory, continued from pHash.
+     */
+    uint64_t Hash(const char* pData, size_t pSize, uint64_t pHash = 14695981039346656037ULL)
+    {
+        for (size_t i = 0; i < pSize; i++)
+        {
+            pHash ^= (unsigned char)pData[i];
+            pHash *= 1099511628211ULL;
+        }
+        return pHash;
+    }
+
+    /**
+     * Read-only mapping of a whole file, unmapped on destruction.
+     */
+    struct MappedFile
+    {
+        const char* Data = nullptr;
+        size_t Size = 0;
+        MappedFile(const G4String& pFileName)
+        {
+            const int lDescriptor = open(pFileName.c_str(), O_RDONLY);
+            struct stat lStat;
+            if (lDescriptor < 0) return;
+            if (fstat(lDescriptor, &lStat) == 0 && lStat.st_size > 0)
+            {
+                void* lMap = mmap(nullptr, (size_t)lStat.st_size, PROT_READ, MAP_PRIVATE, lDescriptor, 0);
+                if (lMap != MAP_FAILED)
+                {
+                    Data = (const char*)lMap;
+                    Size = (size_t)lStat.st_size;
+                }
+            }
+            close(lDescriptor);
+        }
+        ~MappedFile()
+        {
+            if (Data) munmap((void*)Data, Size);
+        }
+    };
+}
+
+/**
+ * Parts of an OBJ file as G4TessellatedSolids, from the binary cache if there is one for this file, offset and scale
+ * (see the class description).
+ * @param pOffset Added to the vertices after scaling (CADMesh SetOffset)
+ * @param pScale Factor on the vertices (CADMesh SetScale)
+ */
+std::vector<G4VSolid*> OMSimCADMesh::Load(G4String pFileName, G4ThreeVector pOffset, G4double pScale)
+{
+    std::vector<G4VSolid*> lParts;
+    const G4String lCacheFile = gCADCache ? CacheFileName(pFileName, pOffset, pScale) : "";
+    if (lCacheFile != "" && ReadCache(lCacheFile, lParts))
+    {
+        info("CAD mesh %s loaded from the cache %s", pFileName.c_str(), lCacheFile.c_str());
+        return lParts;
+    }
+
+    auto lMesh = CADMesh::TessellatedMesh::FromOBJ(pFileName);
+    lMesh->SetOffset(pOffset);
+    lMesh->SetScale(pScale);
+    lParts = lMesh->GetSolids();
+    if (lCacheFile != "") WriteCache(lCacheFile, lParts);
+    return lParts;
+}
+
+/**
+ * @return Name of the cache file, empty if the OBJ file cannot be read
+ */
+G4String OMSimCADMesh::CacheFileName(G4String pFileName, G4ThreeVector pOffset, G4double pScale)
+{
+    MappedFile lFile(pFileName);
+    if (!lFile.Data) return "";
+    const G4double lTransform[4] = {pOffset.x(), pOffset.y(), pOffset.z(), pScale};
+    const uint64_t lKey = Hash((const char*)lTransform, sizeof(lTransform), Hash(lFile.Data, lFile.Size));
+
+    const size_t lSlash = pFileName.rfind('/');
+    const G4String lDirectory = gCADCacheDirectory != "" ? gCADCacheDirectory + "/" : (lSlash == std::string::npos ? "" : pFileName.substr(0, lSlash + 1));
+    const G4String lBaseName = lSlash == std::string::npos ? pFileName : pFileName.substr(lSlash + 1);
+    char lHex[17];
+    snprintf(lHex, sizeof(lHex), "%016" PRIx64, lKey);
+    return lDirectory + lBaseName + "." + lHex + ".meshcache";
+}
+
+/**
+ * @return false if there is no valid cache, pParts is left empty then
+ */
+G4bool OMSimCADMesh::ReadCache(G4String pCacheFile, std::vector<G4VSolid*>& pParts)
+{
+    MappedFile lFile(pCacheFile);
+    if (!lFile.Data || lFile.Size < 12 || std::memcmp(lFile.Data, gMeshCacheMagic, 8) != 0) return false;
+    const char* lEnd = lFile.Data + lFile.Size;
+    const char* lNext = lFile.Data + 8;
+    auto lRead = [&](void* pTarget, size_t pSize) {
+        if (lNext + pSize > lEnd) return false;
+        std::memcpy(pTarget, lNext, pSize);
+        lNext += pSize;
+        return true;
+    };
+
+    uint32_t lNrParts = 0;
+    G4bool lValid = lRead(&lNrParts, 4);
+    for (uint32_t p = 0; lValid && p < lNrParts; p++)
+    {
+        uint32_t lNameLength = 0, lNrVertices = 0, lNrTriangles = 0;
+        if (!lRead(&lNameLength, 4) || lNext + lNameLength > lEnd)
+        {
+            lValid = false;
+            break;
+        }
+        const G4String lName = std::string(lNext, lNameLength);
+        lNext += lNameLength;
+        if (!lRead(&lNrVertices, 4) || !lRead(&lNrTriangles, 4))
+        {
+            lValid = false;
+            break;
+        }
+        std::vector<G4double> lVertices(3 * (size_t)lNrVertices);
+        std::vector<uint32_t> lTriangles(3 * (size_t)lNrTriangles);
+        if (!lRead(lVertices.data(), lVertices.size() * sizeof(G4double)) || !lRead(lTriangles.data(), lTriangles.size() * sizeof(uint32_t)))
+        {
+            lValid = false;
+            break;
+        }
+
+        G4TessellatedSolid* lSolid = new G4TessellatedSolid(lName);
+        for (size_t t = 0; t < lNrTriangles; t++)
+        {
+            G4ThreeVector lCorners[3];
+            for (G4int j = 0; j < 3; j++)
+            {
+                const uint32_t lIndex = lTriangles[3 * t + j];
+                if (lIndex >= lNrVertices) lValid = false;
+                else lCorners[j] = G4ThreeVector(lVertices[3 * lIndex], lVertices[3 * lIndex + 1], lVertices[3 * lIndex + 2]);
+            }
+            if (lValid) lSolid->AddFacet(new G4TriangularFacet(lCorners[0], lCorners[1], lCorners[2], ABSOLUTE));
+        }
+        lSolid->SetSolidClosed(true);
+        pParts.push_back(lSolid);
+    }
+    if (!lValid)
+    {
+        warning("CAD mesh cache %s is damaged, the OBJ file is parsed again", pCacheFile.c_str());
+        for (G4VSolid* lPart : pParts) delete lPart;
+        pParts.clear();
+    }
+    return lValid;
+}
+
+/**
+ * The vertices are shared between the triangles of a part (identical coordinates), the cache is written to a
+ * temporary file first and renamed, so an interrupted startup does not leave a truncated cache. gCADCacheDirectory is
+ * created if it does not exist.
+ */
+void OMSimCADMesh::WriteCache(G4String pCacheFile, const std::vector<G4VSolid*>& pParts)
+{
+    if (gCADCacheDirectory != "") mkdir(gCADCacheDirectory.c_str(), 0755);
+    const G4String lTemporary = pCacheFile + ".tmp";
+    std::ofstream lOutput(lTemporary.c_str(), std::ios::binary);
+    if (!lOutput.is_open())
+    {
+        warning("Could not write the CAD mesh cache %s", pCacheFile.c_str());
+        return;
+    }
+    lOutput.write(gMeshCacheMagic, 8);
+    const uint32_t lNrParts = pParts.size();
+    lOutput.write((const char*)&lNrParts, 4);
+    for (G4VSolid* lPart : pParts)
+    {
+        const std::vector<Triangle> lTriangles = GetTriangles(static_cast<G4TessellatedSolid*>(lPart));
+        std::map<std::array<G4double, 3>, uint32_t> lVertexIndex;
+        std::vector<G4double> lVertices;
+        std::vector<uint32_t> lIndices;
+        for (const Triangle& lTriangle : lTriangles)
+            for (G4int j = 0; j < 3; j++)
+            {
+                const std::array<G4double, 3> lVertex = {lTriangle[j].x(), lTriangle[j].y(), lTriangle[j].z()};
+                auto lFound = lVertexIndex.emplace(lVertex, (uint32_t)lVertexIndex.size());
+                if (lFound.second) lVertices.insert(lVertices.end(), lVertex.begin(), lVertex.end());
+                lIndices.push_back(lFound.first->second);
+            }
+
+        const G4String lName = lPart->GetName();
+        const uint32_t lHeader[3] = {(uint32_t)lName.size(), (uint32_t)(lVertices.size() / 3), (uint32_t)lTriangles.size()};
+        lOutput.write((const char*)&lHeader[0], 4);
+        lOutput.write(lName.data(), lName.size());
+        lOutput.write((const char*)&lHeader[1], 8);
+        lOutput.write((const char*)lVertices.data(), lVertices.size() * sizeof(G4double));
+        lOutput.write((const char*)lIndices.data(), lIndices.size() * sizeof(uint32_t));
+    }
+    lOutput.close();
+    if (!lOutput || std::rename(lTemporary.c_str(), pCacheFile.c_str()) != 0)
+    {
+        warning("Could not write the CAD mesh cache %s", pCacheFile.c_str());
+        std::remove(lTemporary.c_str());
+        return;
+    }
+    info("CAD mesh cache %s written (%d parts)", pCacheFile.c_str(), (G4int)lNrParts);
+}
+
+/**
+ * Parts that are not tessellated are passed through unchanged. The replaced solids are deleted. A decimated part with
+ * open edges is replaced by the original part. The parts are only merged if all of them are closed, none overlaps
+ * another one and the merged solid is closed too, otherwise they are placed separately.
+ * @param pParts Solids of the parts of one CAD file
+ * @param pName Name of the merged solid and of the printout
+ * @return Solids to place, one per part or one for all
+ */
+std::vector<G4VSolid*> OMSimCADMesh::Process(const std::vector<G4VSolid*>& pParts, G4String pName)
+{
+    std::vector<G4VSolid*> lSolids;
+    std::vector<G4TessellatedSolid*> lTessellatedParts;
+    std::vector<std::vector<Triangle>> lPartTriangles;
+    G4bool lClosed = true;
+    G4long lFacetsIn = 0, lFacetsOut = 0;
+    for (G4VSolid* lPart : pParts)
+    {
+        G4TessellatedSolid* lTessellated = dynamic_cast<G4TessellatedSolid*>(lPart);
+        if (!lTessellated)
+        {
+            lSolids.push_back(lPart);
+            continue;
+        }
+        std::vector<Triangle> lTriangles = GetTriangles(lTessellated);
+        lFacetsIn += lTriangles.size();
+        if (gCADDecimation > 0)
+        {
+            std::vector<Triangle> lDecimated = Decimate(lTriangles, gCADDecimation);
+            if (CountOpenEdges(lDecimated) > 0)
+            {
+                warning("Decimated CAD part %s has open edges, the original part is placed", lTessellated->GetName().c_str());
+            }
+            else
+            {
+                G4TessellatedSolid* lSolid = Build(lDecimated, lTessellated->GetName());
+                if (gCADMeshCheck > 0)
+                    OMSimSolidCheck::CompareAndPrint(lTessellated, lSolid, gCADMeshCheck, "Decimated " + lTessellated->GetName(), std::sqrt(3.) * gCADDecimation);
+                delete lTessellated;
+                lTessellated = lSolid;
+                lTriangles.swap(lDecimated);
+            }
+        }
+        lClosed = Verify(lTessellated, lTriangles) && lClosed;
+        lTessellatedParts.push_back(lTessellated);
+        lPartTriangles.push_back(lTriangles);
+    }
+
+    if (gCADMergeParts && lTessellatedParts.size() > 1)
+    {
+        std::vector<Triangle> lMerged;
+        for (const std::vector<Triangle>& lTriangles : lPartTriangles) lMerged.insert(lMerged.end(), lTriangles.begin(), lTriangles.end());
+        if (!lClosed) warning("CAD mesh %s has parts with open edges, the parts are not merged", pName.c_str());
+        else if (Overlap(lTessellatedParts, lPartTriangles)) warning("CAD mesh %s has overlapping parts, the parts are not merged", pName.c_str());
+        else if (CountOpenEdges(lMerged) > 0) warning("CAD mesh %s has parts sharing edges, the parts are not merged", pName.c_str());
+        else
+        {
+            for (G4TessellatedSolid* lPart : lTessellatedParts) delete lPart;
+            G4TessellatedSolid* lSolid = Build(lMerged, pName);
+            Verify(lSolid, lMerged);
+            lTessellatedParts.assign(1, lSolid);
+            lPartTriangles.assign(1, std::vector<Triangle>());
+            lPartTriangles[0].swap(lMerged);
+        }
+    }
+    for (size_t i = 0; i < lTessellatedParts.size(); i++)
+    {
+        lSolids.push_back(lTessellatedParts[i]);
+        lFacetsOut += lPartTriangles[i].size();
+    }
+    mFacets += lFacetsOut;
+    info("CAD mesh %s: %d parts with %ld facets placed as %d solids with %ld facets", pName.c_str(), (G4int)pParts.size(), lFacetsIn,
+         (G4int)lSolids.size(), lFacetsOut);
+    return lSolids;
+}
+
+std::vector<OMSimCADMesh::Triangle> OMSimCADMesh::GetTriangles(const G4TessellatedSolid* pSolid)
+{
+    std::vector<Triangle> lTriangles;
+    lTriangles.reserve(pSolid->GetNumberOfFacets());
+    for (G4int i = 0; i < pSolid->GetNumberOfFacets(); i++)
+    {
+        const G4VFacet* lFacet = pSolid->GetFacet(i);
+        // CADMesh only makes triangles, quadrangles are split anyway
+        for (G4int j = 1; j + 1 < lFacet->GetNumberOfVertices(); j++)
+            lTriangles.push_back({lFacet->GetVertex(0), lFacet->GetVertex(j), lFacet->GetVertex(j + 1)});
+    }
+    return lTriangles;
+}
+
+/**
+ * Vertex clustering on a grid of pTolerance. The orientation of the remaining facets is kept.
+ */
+std::vector<OMSimCADMesh::Triangle> OMSimCADMesh::Decimate(const std::vector<Triangle>& pTriangles, G4double pTolerance)
+{
+    typedef std::tuple<long, long, long> Cell;
+    std::map<Cell, G4int> lCellIndex;
+    std::vector<G4ThreeVector> lSums;
+    std::vector<G4int> lCounts;
+    std::vector<std::array<G4int, 3>> lCorners(pTriangles.size());
+    for (size_t i = 0; i < pTriangles.size(); i++)
+    {
+        for (G4int j = 0; j < 3; j++)
+        {
+            const G4ThreeVector& lVertex = pTriangles[i][j];
+            const Cell lCell(std::lround(std::floor(lVertex.x() / pTolerance)), std::lround(std::floor(lVertex.y() / pTolerance)),
+                             std::lround(std::floor(lVertex.z() / pTolerance)));
+            auto lFound = lCellIndex.emplace(lCell, (G4int)lSums.size());
+            if (lFound.second)
+            {
+                lSums.push_back(G4ThreeVector());
+                lCounts.push_back(0);
+            }
+            // a vertex shared by several facets is counted once per facet, which weights the mean towards busy corners
+            lSums[lFound.first->second] += lVertex;
+            lCounts[lFound.first->second]++;
+            lCorners[i][j] = lFound.first->second;
+        }
+    }
+
+    std::vector<Triangle> lDecimated;
+    std::set<std::array<G4int, 3>> lKept;
+    for (size_t i = 0; i < pTriangles.size(); i++)
+    {
+        const std::array<G4int, 3>& c = lCorners[i];
+        if (c[0] == c[1] || c[1] == c[2] || c[2] == c[0]) continue;
+        std::array<G4int, 3> lSorted = c;
+        std::sort(lSorted.begin(), lSorted.end());
+        if (!lKept.insert(lSorted).second) continue;
+        const Triangle lTriangle = {lSums[c[0]] / lCounts[c[0]], lSums[c[1]] / lCounts[c[1]], lSums[c[2]] / lCounts[c[2]]};
+        if ((lTriangle[1] - lTriangle[0]).cross(lTriangle[2] - lTriangle[0]).mag2() <= 0) continue;
+        lDecimated.push_back(lTriangle);
+    }
+    return lDecimated;
+}
+
+G4TessellatedSolid* OMSimCADMesh::Build(const std::vector<Triangle>& pTriangles, G4String pName)
+{
+    G4TessellatedSolid* lSolid = new G4TessellatedSolid(pName);
+    for (const Triangle& lTriangle : pTriangles) lSolid->AddFacet(new G4TriangularFacet(lTriangle[0], lTriangle[1], lTriangle[2], ABSOLUTE));
+    lSolid->SetSolidClosed(true);
+    return lSolid;
+}
+
+/**
+ * @return Number of edges not shared by exactly two triangles (vertices are matched by their coordinates)
+ */
+G4int OMSimCADMesh::CountOpenEdges(const std::vector<Triangle>& pTriangles)
+{
+    std::map<std::array<G4double, 3>, G4int> lVertexIndex;
+    std::map<std::pair<G4int, G4int>, G4int> lEdgeUses;
+    for (const Triangle& lTriangle : pTriangles)
+    {
+        G4int lIndex[3];
+        for (G4int j = 0; j < 3; j++)
+            lIndex[j] = lVertexIndex.emplace(std::array<G4double, 3>{lTriangle[j].x(), lTriangle[j].y(), lTriangle[j].z()}, (G4int)lVertexIndex.size()).first->second;
+        for (G4int j = 0; j < 3; j++) lEdgeUses[std::minmax(lIndex[j], lIndex[(j + 1) % 3])]++;
+    }
+    G4int lOpenEdges = 0;
+    for (const auto& lEdge : lEdgeUses)
+        if (lEdge.second != 2) lOpenEdges++;
+    return lOpenEdges;
+}
+
+/**
+ * Two parts overlap if a vertex of one is inside the other (only pairs with overlapping bounding boxes are tested).
+ * Parts that only touch are not overlapping.
+ */
+G4bool OMSimCADMesh::Overlap(const std::vector<G4TessellatedSolid*>& pSolids, const std::vector<std::vector<Triangle>>& pTriangles)
+{
+    std::vector<G4ThreeVector> lMin(pSolids.size()), lMax(pSolids.size());
+    for (size_t i = 0; i < pSolids.size(); i++) pSolids[i]->BoundingLimits(lMin[i], lMax[i]);
+    for (size_t i = 0; i < pSolids.size(); i++)
+        for (size_t j = 0; j < pSolids.size(); j++)
+        {
+            if (i == j || lMin[i].x() > lMax[j].x() || lMin[j].x() > lMax[i].x() || lMin[i].y() > lMax[j].y() || lMin[j].y() > lMax[i].y()
+                || lMin[i].z() > lMax[j].z() || lMin[j].z() > lMax[i].z())
+                continue;
+            for (const Triangle& lTriangle : pTriangles[i])
+                for (const G4ThreeVector& lVertex : lTriangle)
+                    if (pSolids[j]->Inside(lVertex) == kInside)
+                    {
+                        debug("CAD parts %s and %s overlap", pSolids[i]->GetName().c_str(), pSolids[j]->GetName().c_str());
+                        return true;
+                    }
+        }
+    return false;
+}
+
+/**
+ * Warns about open edges and about solids that were not voxelised by SetSolidClosed.
+ * @return false if the solid has open edges
+ */
+G4bool OMSimCADMesh::Verify(G4TessellatedSolid* pSolid, const std::vector<Triangle>& pTriangles)
+{
+    const G4int lOpenEdges = CountOpenEdges(pTriangles);
+    if (lOpenEdges > 0) warning("CAD solid %s has %d edges not shared by exactly two facets, Inside() may be wrong near them", pSolid->GetName().c_str(), lOpenEdges);
+
+    const long long lVoxels = pSolid->GetVoxels().GetCountOfVoxels();
+    if (lVoxels <= 1 && pSolid->GetNumberOfFacets() > 100) warning("CAD solid %s with %d facets is not voxelised", pSolid->GetName().c_str(), pSolid->GetNumberOfFacets());
+    else debug("CAD solid %s: %d facets, %lld voxels", pSolid->GetName().c_str(), pSolid->GetNumberOfFacets(), lVoxels);
+    return lOpenEdges == 0;
+}
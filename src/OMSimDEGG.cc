@@ -12,9 +12,13 @@
 #include "OMSimDEGG.hh"
 #include "OMSimDEGGHarness.hh" 
 #include "abcDetectorComponent.hh"
+#include "OMSimTimeline.hh"
+#include "OMSimCADMesh.hh"
 #include <dirent.h>
 #include <stdexcept>
 #include <cstdlib>
+#include <algorithm>
+#include <cmath>
 
 #include "G4Cons.hh"
 #include "G4Ellipsoid.hh"
@@ -37,17 +41,30 @@
 #include "G4Torus.hh"
 #include "CADMesh.hh" 
 
+#include "OMSimLogger.hh"
+
 
 extern G4bool gCADImport;
+extern G4double gDEGGSegmentScale;
+extern G4double gDEGGSegmentDeviation;
+
+/**
+ * Segment count of a torus part of the vessel, the one of the data file scaled by gDEGGSegmentScale.
+ */
+static G4int ScaledSegments(G4double pSegments)
+{
+   return std::max(2, G4int(std::lround(pSegments * gDEGGSegmentScale)));
+}
 
 dEGG::dEGG(OMSimInputData* pData, G4bool pPlaceHarness){
+    OMSimScopedTimer lTimer("dEGG construction");
    mData = pData;
    mPMTManager = new OMSimPMTConstruction(mData);
    mPMTManager->SelectPMT("pmt_dEGG");
 
    if (pPlaceHarness){
       mHarness = new dEGGHarness(this,mData);
-      IntegrateDetectorComponent(mHarness, G4ThreeVector(0,0,0), G4RotationMatrix(), "");
+      IntegrateHarness(mHarness);
    }
 
    GetSharedData();
@@ -61,13 +78,13 @@ dEGG::dEGG(OMSimInputData* pData, G4bool pPlaceHarness){
  */
 void dEGG::GetSharedData(){
    // Outer shape of the vessel
-   mOutSegments1 = mData->GetValue(mDataKey, "jOutSegments1");
+   mOutSegments1 = ScaledSegments(mData->GetValue(mDataKey, "jOutSegments1"));
    mOutSphereRadiusMax = mData->GetValue(mDataKey, "jOutSphereRadiusMax");
    mOutSphereDtheta = mData->GetValue(mDataKey, "jOutSphereDtheta");
    mOutTransformZ = mData->GetValue(mDataKey, "jOutTransformZ");
    mOutTorusRadius1 = mData->GetValue(mDataKey, "jOutTorusRadius1"); // radius of small spindle torus sphere
    mOutCenterOfTorusRadius1 = mData->GetValue(mDataKey, "jOutCenterOfTorusRadius1"); // distance from center of torus to z-axis
-   mOutSegments2 = mData->GetValue(mDataKey, "jOutSegments2");
+   mOutSegments2 = ScaledSegments(mData->GetValue(mDataKey, "jOutSegments2"));
    mOutTorusRadius2 = mData->GetValue(mDataKey, "jOutTorusRadius2"); // radius of large spindle torus sphere
    mOutCenterOfTorusRadius2 = mData->GetValue(mDataKey, "jOutCenterOfTorusRadius2"); // distance from center of torus to z-axis
    mOutCenterOfTorusZ2 = mData->GetValue(mDataKey, "jOutCenterOfTorusZ2");
@@ -77,13 +94,13 @@ void dEGG::GetSharedData(){
    mOutTorusTransformZ = mData->GetValue(mDataKey, "jOutTorusTransformZ");
 
    // Inner shape of the vessel
-   mInnSegments1 = mData->GetValue(mDataKey, "jInnSegments1");
+   mInnSegments1 = ScaledSegments(mData->GetValue(mDataKey, "jInnSegments1"));
    mInnSphereRmax = mData->GetValue(mDataKey, "jInnSphereRmax");
    mInnSphereDtheta = mData->GetValue(mDataKey, "jInnSphereDtheta");
    mInnTransformZ = mData->GetValue(mDataKey, "jInnTransformZ");
    mInnTorusRadius1 = mData->GetValue(mDataKey, "jInnTorusRadius1"); // radius of small spindle torus sphere
    mInnCenterOfTorusRadius1 = mData->GetValue(mDataKey, "jInnCenterOfTorusRadius1"); // distance from center of torus to z-axis
-   mInnSegments2 = mData->GetValue(mDataKey, "jInnSegments2");
+   mInnSegments2 = ScaledSegments(mData->GetValue(mDataKey, "jInnSegments2"));
    mInnTorusRadius2 = mData->GetValue(mDataKey, "jInnTorusRadius2"); // radius of large spindle torus sphere
    mInnCenterOfTorusRadius2 = mData->GetValue(mDataKey, "jInnCenterOfTorusRadius2"); // distance from center of torus to z-axis
    mInnCenterOfTorusZ2 = mData->GetValue(mDataKey, "jInnCenterOfTorusZ2");
@@ -116,6 +133,9 @@ void dEGG::Construction(){
    //Create pressure vessel and inner volume
    G4VSolid *lOuterGlass = CreateEggSolid(mOutSegments1,mOutSphereRadiusMax,mOutSphereDtheta,mOutTransformZ,mOutTorusRadius1,mOutCenterOfTorusRadius1,mOutSegments2,mOutTorusRadius2,mOutCenterOfTorusRadius2,mOutCenterOfTorusZ2,mOutTorusZmin2,mOutTorusZmax2,mOutTorusZ0,mOutTorusTransformZ);
    G4VSolid *lInnerGlass = CreateEggSolid(mInnSegments1,mInnSphereRmax,mInnSphereDtheta,mInnTransformZ,mInnTorusRadius1,mInnCenterOfTorusRadius1,mInnSegments2,mInnTorusRadius2,mInnCenterOfTorusRadius2,mInnCenterOfTorusZ2,mInnTorusZmin2,mInnTorusZmax2,mInnTorusZ0,mInnTorusTransformZ);
+   gDEGGSegmentDeviation = mSegmentDeviation;
+   info("dEGG vessel with %d/%d (outer) and %d/%d (inner) segments, largest deviation from the torus surfaces %.4f mm",
+        mOutSegments1, mOutSegments2, mInnSegments1, mInnSegments2, mSegmentDeviation / mm);
    
    //Logicals
    G4LogicalVolume* PDOM_Glass_logical = new G4LogicalVolume (lOuterGlass, mData->GetMaterial("argVesselGlass"), "Glass_phys");
@@ -190,12 +210,12 @@ void dEGG::PlaceCADSupportStructure(G4LogicalVolume* lInnerVolumeLogical)
    G4cout <<  "using the following CAD file for support structure: "  << CADfile.str()  << G4endl;
 
    //load mesh
-   auto mesh = CADMesh::TessellatedMesh::FromOBJ("../data/CADmeshes/DEGG/" + CADfile.str() );
+   OMSimScopedTimer lCADTimer("CAD mesh " + CADfile.str());
+   const G4String lCADPath = "../data/CADmeshes/DEGG/" + CADfile.str();
    G4ThreeVector CADoffset = G4ThreeVector(-427.6845*mm, 318.6396*mm, 152.89*mm); //measured from CAD file since origin =!= Module origin
-   mesh->SetOffset(CADoffset);
 
-   // Place all of the meshes it can find in the file as solids individually.
-   for (auto solid : mesh->GetSolids())
+   // Place the meshes of the file, one solid per part or one for all of them (see OMSimCADMesh)
+   for (auto solid : OMSimCADMesh::Process(OMSimCADMesh::Load(lCADPath, CADoffset), CADfile.str()))
    { 
       G4LogicalVolume* mSupportStructureLogical  = new G4LogicalVolume( solid , mData->GetMaterial("NoOptic_Absorber") , "logical" , 0, 0, 0);
       mSupportStructureLogical->SetVisAttributes(mAluVis);
@@ -203,6 +223,26 @@ void dEGG::PlaceCADSupportStructure(G4LogicalVolume* lInnerVolumeLogical)
    }
 }
 
+/**
+ * Largest distance between the arc of a circle and the chords of the polycone approximating it. The chord ends are on
+ * the circle at the heights pZMax - j * pStep (relative to its center), j = 0..pChords.
+ * @param pRadius G4double radius of the circle
+ * @return G4double largest sagitta of the chords
+ */
+G4double dEGG::ChordDeviation(G4double pRadius, G4double pZMax, G4double pStep, G4int pChords)
+{
+   G4double lDeviation = 0;
+   for (G4int j = 0; j < pChords; ++j) {
+      const G4double lZ1 = pZMax - j * pStep;
+      const G4double lZ2 = lZ1 - pStep;
+      const G4double lR1 = std::sqrt(std::max(0., pRadius * pRadius - lZ1 * lZ1));
+      const G4double lR2 = std::sqrt(std::max(0., pRadius * pRadius - lZ2 * lZ2));
+      const G4double lHalfChord2 = 0.25 * (pStep * pStep + (lR1 - lR2) * (lR1 - lR2));
+      lDeviation = std::max(lDeviation, pRadius - std::sqrt(std::max(0., pRadius * pRadius - lHalfChord2)));
+   }
+   return lDeviation;
+}
+
 /**
  * Placement of the CreateEggSolid. 
  * @param segments_1 G4int 
@@ -300,6 +340,8 @@ G4VSolid* dEGG::CreateEggSolid(G4int segments_1,
 
    G4Polycone * torus21 = new G4Polycone("polycone2", 0, 2*M_PI, segments_2+1, zPlane2, rInner2, rOuter2);
    G4VSolid * torus2 = torus21;
+   mSegmentDeviation = std::max({mSegmentDeviation, ChordDeviation(torus1_r, torus1_zmax, step, segments_1),
+                                 ChordDeviation(torus2_r, torus_relative_zmax2, step2, segments_2 - 1)});
 
    //Create Vessel
 
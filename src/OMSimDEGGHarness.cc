@@ -11,6 +11,8 @@
 #include "OMSimDEGGHarness.hh"
 #include "OMSimDEGG.hh"
 #include "abcDetectorComponent.hh"
+#include "OMSimTimeline.hh"
+#include "OMSimCADMesh.hh"
 #include <dirent.h>
 #include <stdexcept>
 #include <cstdlib>
@@ -107,7 +109,8 @@ void dEGGHarness::PlaceCADHarness()
     G4cout <<  "using the following CAD file for Harness: "  << CADfile.str()  << G4endl;
 
     //load mesh
-    auto mesh = CADMesh::TessellatedMesh::FromOBJ("../data/CADmeshes/DEGG/" + CADfile.str() );
+    OMSimScopedTimer lCADTimer("CAD mesh " + CADfile.str());
+    const G4String lCADPath = "../data/CADmeshes/DEGG/" + CADfile.str();
     //G4ThreeVector CADoffset = G4ThreeVector(-427.6845*mm, 318.6396*mm, 152.89*mm); //measured from CAD file since origin =!= Module origin ... for no rotation
     G4ThreeVector CADoffset = G4ThreeVector( 318.6396*mm, 427.6845*mm, 152.89*mm); //measured from CAD file since origin =!= Module origin ... for -90° z rotation
     
@@ -115,7 +118,7 @@ void dEGGHarness::PlaceCADHarness()
     lPenetratorRotation.rotateZ(-90*deg);
 
     // Place all of the meshes it can find in the file as solids individually.
-    for (auto solid : mesh->GetSolids())
+    for (auto solid : OMSimCADMesh::Load(lCADPath))
     { 
         G4LogicalVolume* lCADHarness  = new G4LogicalVolume( solid , mData->GetMaterial("NoOptic_Absorber") , "logical" , 0, 0, 0);
         lCADHarness->SetVisAttributes(mAluVis);
@@ -133,7 +136,8 @@ void dEGGHarness::PlaceCADPenetrator()
     G4cout <<  "using the following CAD file for Penetrator: "  << CADfile.str()  << G4endl;
 
     //load mesh
-    auto mesh = CADMesh::TessellatedMesh::FromOBJ("../data/CADmeshes/DEGG/" + CADfile.str() );
+    OMSimScopedTimer lCADTimer("CAD mesh " + CADfile.str());
+    const G4String lCADPath = "../data/CADmeshes/DEGG/" + CADfile.str();
     G4double xoffset = 110.211*mm;
     //G4double zoffset = 34.39*mm;
     G4double zoffset = 77.817*mm;
@@ -149,12 +153,12 @@ void dEGGHarness::PlaceCADPenetrator()
 
 
 
-    mesh->SetScale(25.4); //did a mistake...this ONE file needs inch -> mm -> *2.54 * 10
+    const G4double lCADScale = 25.4; //did a mistake...this ONE file needs inch -> mm -> *2.54 * 10
 
     //mesh->SetOffset(CADoffset); Don't set the offset here, it is done in AppendComponent
 
     // Place all of the meshes it can find in the file as solids individually.
-    for (auto solid : mesh->GetSolids())
+    for (auto solid : OMSimCADMesh::Load(lCADPath, G4ThreeVector(), lCADScale))
     { 
         G4LogicalVolume* lCADPenetrator  = new G4LogicalVolume( solid , mData->GetMaterial("NoOptic_Absorber") , "logical" , 0, 0, 0);
         lCADPenetrator->SetVisAttributes(mAluVis);
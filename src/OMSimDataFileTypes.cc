@@ -112,7 +112,7 @@ void abcMaterialData::CreateMaterial()
         mMaterial->AddMaterial(mMatDatBase->FindOrBuildMaterial(componentName), componentFraction);
     }
     G4String mssg = "New Material defined: " + mMaterial->GetName();
-    info(mssg);
+    info("%s", mssg.c_str());
 
     //std::cerr <<"abcMaterialData::CreateMaterial end" << std::endl;
 }
@@ -244,7 +244,7 @@ void IceCubeIce::ExtractInformation()
     lMPT_spice->AddConstProperty("MIEHG_FORWARD_RATIO", mMIE_spice_const[2]);
     lIceMie->SetMaterialPropertiesTable(lMPT_spice);
     G4String mssg = "Ice properties at depth " + std::to_string(mSpice_Depth[mSpiceDepth_pos] / m) + " m.";
-    notice(mssg);
+    notice("%s", mssg.c_str());
     //now give the properties to the bubble column, which are basically the same ones but with the chosen scattering lenght
     G4MaterialPropertiesTable* lMPT_holeice = new G4MaterialPropertiesTable();
     lMPT_holeice->AddProperty("RINDEX", &lRefractionIndexEnergy2[0], &lRefractionIndex2[0], static_cast<int>(lRefractionIndex.size()));
@@ -359,7 +359,7 @@ void ReflectiveSurface::ExtractInformation()
 
     mOpticalSurface->SetMaterialPropertiesTable(lMPT);
     G4String mssg = "New Optical Surface: " + mObjectName;
-    info(mssg);
+    info("%s", mssg.c_str());
 }
 
 /**
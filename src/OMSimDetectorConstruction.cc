@@ -14,11 +14,23 @@
 #include "OMSimDetectorConstruction.hh"
 
 #include "G4PVPlacement.hh"
+#include "G4Orb.hh"
+#include "G4Region.hh"
+#include "G4Sphere.hh"
 #include "G4SystemOfUnits.hh"
 #include "G4Transform3D.hh"
+#include "G4Tubs.hh"
+#include "G4VisAttributes.hh"
 
 #include "OMSimInputData.hh"
 #include "OMSimPMTConstruction.hh"
+#include "OMSimTimeline.hh"
+#include "OMSimModuleBounds.hh"
+#include "OMSimIceFastModel.hh"
+#include "OMSimPropagationTable.hh"
+#include "OMSimAcceptanceTable.hh"
+#include "OMSimAnalysisManager.hh"
+#include "OMSimVoxelTuning.hh"
 
 #include "OMSimMDOM.hh"
 #include "OMSimPDOM.hh"
@@ -26,12 +38,39 @@
 #include "OMSimLOM18.hh"
 #include "OMSimDEGG.hh"
 
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <set>
+#include <sstream>
 
+#include "OMSimLogger.hh"
 
 extern G4double gworldsize;
 extern G4int gDOM;
 extern G4bool gCADImport;
 extern G4bool gPlaceHarness;
+extern G4bool gFastSimulation;
+extern G4String gGeneratorMode;
+extern G4double gPropagationInnerRadius;
+extern G4String gPropagationTableFile;
+extern G4int gGlass;
+extern G4int gGel;
+extern G4double gRefCone_angle;
+extern G4int gConeMat;
+extern G4int gHolderColor;
+extern G4int gHarness;
+extern G4int gEnvironment;
+extern G4String gQEFile;
+extern G4int gArrayStrings;
+extern G4int gArrayModulesPerString;
+extern G4double gArrayStringSpacing;
+extern G4double gArrayModuleSpacing;
+extern G4bool gArrayEnvelopes;
+extern G4int gModuleDetail;
+extern G4String gDetailedModules;
+extern G4bool gVoxelTuning;
+extern OMSimAnalysisManager gAnalysisManager;
 
 OMSimDetectorConstruction::OMSimDetectorConstruction()
     : mWorldSolid(0), mWorldLogical(0), mWorldPhysical(0)
@@ -144,8 +183,12 @@ void OMSimDetectorConstruction::ConstructWorld()
 G4VPhysicalVolume *OMSimDetectorConstruction::Construct()
 {
 
+    OMSimScopedTimer lTimer("OMSimDetectorConstruction::Construct");
     mData = new OMSimInputData();
-    mData->SearchFolders("/home/waly/bulkice_doumeki/mdom/build");
+    {
+        OMSimScopedTimer lTimer("Data folder scan (materials, PMTs, OMs)");
+        mData->SearchFolders("/home/waly/bulkice_doumeki/mdom/build");
+    }
 
     ConstructWorld();
 
@@ -160,6 +203,10 @@ G4VPhysicalVolume *OMSimDetectorConstruction::Construct()
 
 
 
+    OMSimModuleBounds::Clear();
+    OMSimVoxelTuning::SetModule(mData, nullptr);
+    abcDetectorComponent* lOpticalModule = nullptr;
+
     if (gDOM == 0){ //Single PMT
         G4cout << "Constructing single PMT" << G4endl;
         mPMTManager = new OMSimPMTConstruction(mData);
@@ -168,40 +215,229 @@ G4VPhysicalVolume *OMSimDetectorConstruction::Construct()
         G4RotationMatrix* lRot = new G4RotationMatrix();
         G4Transform3D lTransformers = G4Transform3D(*lRot, G4ThreeVector(0,0,0));
         mPMTManager->PlaceIt(lTransformers, mWorldLogical, "PMT");
+
+        G4ThreeVector lMin, lMax;
+        mPMTManager->GetPMTSolid()->BoundingLimits(lMin, lMax);
+        G4ThreeVector lFarCorner(std::max(-lMin.x(), lMax.x()), std::max(-lMin.y(), lMax.y()), std::max(-lMin.z(), lMax.z()));
+        OMSimModuleBounds::AddModule(G4ThreeVector(0, 0, 0), lFarCorner.mag());
+        if (gArrayStrings * gArrayModulesPerString > 1) warning("Module arrays are not available for single PMTs, only one PMT is placed");
     }
     else if (gDOM == 1){ //mDOM
         G4cout << "Constructing mDOM" << G4endl;
-        mDOM *lOpticalModule = new mDOM(mData,gPlaceHarness);
-        lOpticalModule->PlaceIt(G4ThreeVector(0, 0, 0), G4RotationMatrix(), mWorldLogical, "");
+        lOpticalModule = new mDOM(mData,gPlaceHarness);
     }
     else if (gDOM == 2){ //PDOM
         G4cout << "Constructing PDOM" << G4endl;
-        pDOM *lOpticalModule = new pDOM(mData,gPlaceHarness);
-        lOpticalModule->PlaceIt(G4ThreeVector(0, 0, 0), G4RotationMatrix(), mWorldLogical, "");
+        lOpticalModule = new pDOM(mData,gPlaceHarness);
     }
     else if (gDOM == 3){ //LOM16
         G4cout << "Constructing LOM16" << G4endl;
-        LOM16 *lOpticalModule = new LOM16(mData,gPlaceHarness);
-        lOpticalModule->PlaceIt(G4ThreeVector(0, 0, 0), G4RotationMatrix(), mWorldLogical, "");
+        lOpticalModule = new LOM16(mData,gPlaceHarness);
     }
     else if (gDOM == 4){ //LOM18
         G4cout << "Constructing LOM18" << G4endl;
-        LOM18 *lOpticalModule = new LOM18(mData,gPlaceHarness);
-        lOpticalModule->PlaceIt(G4ThreeVector(0, 0, 0), G4RotationMatrix(), mWorldLogical, "");
-        G4cout << "::::::::::::::LOM18 successfully constructed::::::::::::" << G4endl;
+        lOpticalModule = new LOM18(mData,gPlaceHarness);
     }
      else if (gDOM == 5){ //DEGG
         G4cout << "Constructing DEGG" << G4endl;
-        dEGG *lOpticalModule = new dEGG(mData,gPlaceHarness);
-        lOpticalModule->PlaceIt(G4ThreeVector(0, 0, 0), G4RotationMatrix(), mWorldLogical, "");
+        lOpticalModule = new dEGG(mData,gPlaceHarness);
      }
     else{ //Add your costume detector contruction here and call it with -m 6 (or greater)
         G4cout << "Constructing custome detector construction" << G4endl;
     }
 
+    if (lOpticalModule){
+        OMSimVoxelTuning::SetModule(mData, lOpticalModule);
+        if (gVoxelTuning) OMSimVoxelTuning::Apply();
+        PlaceModuleArray(lOpticalModule);
+        G4cout << "::::::::::::::Optical module successfully constructed::::::::::::" << G4endl;
+    }
+    gAnalysisManager.modules = std::max(1, OMSimModuleBounds::GetNumberOfModules());
 
+    OMSimAcceptanceTable::GetInstance()->SetGeometryHash(OMSimAcceptanceTable::Hash(GetGeometryFingerprint()));
 
-
+    if (gFastSimulation || gGeneratorMode == "proptable") ConstructBulkIceEnvelope();
 
     return mWorldPhysical;
 }
+
+/**
+ * Place the optical module on gArrayStrings strings of gArrayModulesPerString modules each, a single module at the
+ * origin by default. The strings stand on a square grid in the x-y plane, gArrayStringSpacing apart, the modules of
+ * a string are gArrayModuleSpacing apart along z, and the array is centred at the origin. Module i (string *
+ * gArrayModulesPerString + position on the string) is also module i of OMSimModuleBounds and the module ID of its hits.
+ * The solids and logical volumes of the module are built once and shared by all placements.
+ *
+ * With gArrayEnvelopes (arrays only), the components are placed once in a spherical ice envelope around the module,
+ * the module envelope is placed along a cylindrical ice envelope per string and the string envelope on the grid. The
+ * world then only holds the strings and every mother volume has few daughters, which keeps the voxelisation small
+ * and the navigation fast; the number of physical volumes grows with strings + modules per string, not with their
+ * product. The module ID is recovered from the copy numbers of the envelopes (OMSimModuleBounds::GetModuleID).
+ * Without envelopes the components of every module are placed directly in the world, with the module ID as copy
+ * number. Overlaps are checked for the first placement only: the others are copies and cannot overlap each other
+ * if their bounding volumes do not.
+ *
+ * Every module is placed at the level of detail gModuleDetail (abcDetectorComponent::DetailLevel), except the modules
+ * listed in gDetailedModules, which get full detail (e.g. the modules next to the source). With envelopes, there is one
+ * module envelope per level used and one string envelope per sequence of levels along a string, still shared by all
+ * strings with the same sequence.
+ * @param pModule Constructed optical module
+ */
+void OMSimDetectorConstruction::PlaceModuleArray(abcDetectorComponent* pModule)
+{
+    G4int lStrings = std::max(1, gArrayStrings);
+    G4int lPerString = std::max(1, gArrayModulesPerString);
+    const G4bool lEnvelopes = gArrayEnvelopes && lStrings * lPerString > 1;
+    const G4double lRadius = pModule->GetBoundingRadius();
+    const G4double lModuleRadius = lEnvelopes ? lRadius + 1 * mm : lRadius;  // module envelope
+    const G4double lStringRadius = lEnvelopes ? lModuleRadius + 1 * mm : lRadius; // string envelope
+    G4int lColumns = (G4int)std::ceil(std::sqrt((G4double)lStrings));
+    G4int lRows = (lStrings + lColumns - 1) / lColumns;
+
+    const G4double lHalfWidth = 0.5 * (lColumns - 1) * gArrayStringSpacing + lStringRadius;
+    const G4double lHalfHeight = 0.5 * (lPerString - 1) * gArrayModuleSpacing + lStringRadius;
+    if ((lStrings > 1 && gArrayStringSpacing < 2 * lStringRadius) || (lPerString > 1 && gArrayModuleSpacing < 2 * lModuleRadius))
+    {
+        error("Module spacing of the array is smaller than the module diameter (%.1f cm), only one module is placed", 2 * lStringRadius / cm);
+        lStrings = lPerString = lColumns = lRows = 1;
+    }
+    else if (std::max(lHalfWidth, lHalfHeight) > mWorldSolid->GetXHalfLength())
+    {
+        error("Module array does not fit into the world, only one module is placed");
+        lStrings = lPerString = lColumns = lRows = 1;
+    }
+
+    std::vector<G4ThreeVector> lStringPositions;
+    for (G4int lString = 0; lString < lStrings; lString++)
+    {
+        lStringPositions.push_back(G4ThreeVector((lString % lColumns - 0.5 * (lColumns - 1)) * gArrayStringSpacing,
+                                                 (lString / lColumns - 0.5 * (lRows - 1)) * gArrayStringSpacing, 0));
+        for (G4int k = 0; k < lPerString; k++)
+        {
+            OMSimModuleBounds::AddModule(lStringPositions.back() + G4ThreeVector(0, 0, (k - 0.5 * (lPerString - 1)) * gArrayModuleSpacing), lRadius);
+        }
+    }
+
+    std::vector<G4int> lDetail(OMSimModuleBounds::GetNumberOfModules(), std::min(std::max(gModuleDetail, (G4int)abcDetectorComponent::kMinimalDetail), (G4int)abcDetectorComponent::kFullDetail));
+    std::string lList = gDetailedModules;
+    std::replace(lList.begin(), lList.end(), ',', ' ');
+    std::istringstream lListStream(lList);
+    for (G4int lID; lListStream >> lID;)
+    {
+        if (lID >= 0 && lID < (G4int)lDetail.size()) lDetail[lID] = abcDetectorComponent::kFullDetail;
+        else warning("Module %d of gDetailedModules is not placed", lID);
+    }
+
+    // one span for all placements, a span per module would flood the timeline of large arrays
+    OMSimScopedTimer lTimer("Placement and overlap checks (" + std::to_string(OMSimModuleBounds::GetNumberOfModules()) + " modules)");
+    if (lStrings * lPerString > 1 && lEnvelopes)
+    {
+        G4Material* lIce = mWorldLogical->GetMaterial();
+        std::map<G4int, G4LogicalVolume*> lModuleLogicals;                // module envelope per level of detail
+        std::map<std::vector<G4int>, G4LogicalVolume*> lStringLogicals;   // string envelope per sequence of levels
+        for (G4int lString = 0; lString < lStrings; lString++)
+        {
+            const std::vector<G4int> lLevels(lDetail.begin() + lString * lPerString, lDetail.begin() + (lString + 1) * lPerString);
+            G4LogicalVolume*& lStringLogical = lStringLogicals[lLevels];
+            if (!lStringLogical)
+            {
+                lStringLogical = new G4LogicalVolume(new G4Tubs("StringEnvelope", 0, lStringRadius, lHalfHeight, 0, 360 * deg), lIce, "StringEnvelope_log");
+                lStringLogical->SetVisAttributes(G4VisAttributes::GetInvisible());
+                OMSimModuleBounds::AddEnvelope(lStringLogical, lPerString);
+                for (G4int k = 0; k < lPerString; k++)
+                {
+                    G4LogicalVolume*& lModuleLogical = lModuleLogicals[lLevels[k]];
+                    if (!lModuleLogical)
+                    {
+                        lModuleLogical = new G4LogicalVolume(new G4Orb("ModuleEnvelope", lModuleRadius), lIce, "ModuleEnvelope_log");
+                        lModuleLogical->SetVisAttributes(G4VisAttributes::GetInvisible());
+                        OMSimModuleBounds::AddEnvelope(lModuleLogical, 1);
+                        pModule->PlaceIt(G4ThreeVector(0, 0, 0), G4RotationMatrix(), lModuleLogical, "", 0, lLevels[k]);
+                    }
+                    new G4PVPlacement(0, G4ThreeVector(0, 0, (k - 0.5 * (lPerString - 1)) * gArrayModuleSpacing), lModuleLogical, "ModuleEnvelope_phys", lStringLogical, false, k, k == 0);
+                }
+            }
+            new G4PVPlacement(0, lStringPositions[lString], lStringLogical, "StringEnvelope_phys", mWorldLogical, false, lString, lString == 0);
+        }
+    }
+    else
+    {
+        std::set<G4int> lChecked; // levels of detail whose first placement was checked for overlaps
+        for (G4int lID = 0; lID < OMSimModuleBounds::GetNumberOfModules(); lID++)
+        {
+            pModule->mCheckOverlaps = lChecked.insert(lDetail[lID]).second;
+            pModule->PlaceIt(OMSimModuleBounds::GetModule(lID).Center, G4RotationMatrix(), mWorldLogical, lID == 0 ? "" : "_" + std::to_string(lID), lID, lDetail[lID]);
+        }
+        pModule->mCheckOverlaps = false;
+    }
+    const G4int lFull = std::count(lDetail.begin(), lDetail.end(), (G4int)abcDetectorComponent::kFullDetail);
+    if (lFull < (G4int)lDetail.size())
+    {
+        info("Levels of detail: %d modules full, %d simplified, %d minimal", lFull,
+             (G4int)std::count(lDetail.begin(), lDetail.end(), (G4int)abcDetectorComponent::kSimplifiedDetail),
+             (G4int)std::count(lDetail.begin(), lDetail.end(), (G4int)abcDetectorComponent::kMinimalDetail));
+    }
+    if (lStrings * lPerString > 1) info("Module array: %d strings with %d modules each%s", lStrings, lPerString, lEnvelopes ? " in ice envelopes" : "");
+}
+
+/**
+ * Text describing everything the response of the module depends on: the selected module, the material and
+ * component globals, the QE file, the bounding radius and all json parameter tables that were read. Acceptance
+ * tables store its hash and are refused for another geometry. The parameter tables of all modules are included,
+ * so editing any of them invalidates the tables of every module (conservative, but never stale). The voxel tuning
+ * (jVoxelTuning, see OMSimVoxelTuning) is left out, it changes the speed of the navigation but not the response.
+ */
+G4String OMSimDetectorConstruction::GetGeometryFingerprint()
+{
+    std::ostringstream lText;
+    lText << "DOM " << gDOM << " harness " << gPlaceHarness << " " << gHarness << " detail " << gModuleDetail << " " << gDetailedModules << " glass " << gGlass << " gel " << gGel
+          << " cone " << gRefCone_angle << " " << gConeMat << " holder " << gHolderColor << " environment " << gEnvironment
+          << " QE " << gQEFile << "\n";
+    if (OMSimModuleBounds::GetNumberOfModules() > 0) lText << "radius " << OMSimModuleBounds::GetModule(0).Radius / mm << "\n";
+    for (auto& lEntry : mData->mTable)
+    {
+        pt::ptree lTree = lEntry.second;
+        lTree.erase("jVoxelTuning");
+        lText << lEntry.first << "\n";
+        pt::write_json(lText, lTree, false);
+    }
+    return lText.str();
+}
+
+/**
+ * Spherical ice shell around the module for the fast simulation of the photon transport (OMSimIceFastModel).
+ * Everything inside the inner radius (module and the ice around it) is tracked in detail. The shell is also needed
+ * when building the propagation tables, as its inner surface is the sphere on which arrivals are recorded.
+ */
+void OMSimDetectorConstruction::ConstructBulkIceEnvelope()
+{
+    if (OMSimModuleBounds::GetNumberOfModules() > 1)
+    {
+        warning("The bulk ice envelope is only available for a single module, envelope not constructed");
+        return;
+    }
+    const G4ThreeVector lCenter = OMSimModuleBounds::GetNumberOfModules() > 0 ? OMSimModuleBounds::GetModule(0).Center : G4ThreeVector();
+    G4double lInnerRadius = gPropagationInnerRadius;
+    OMSimPropagationTable* lTable = OMSimPropagationTable::GetInstance();
+    if (gFastSimulation && !lTable->IsLoaded()) lTable->Load(gPropagationTableFile);
+    if (lTable->IsLoaded()) lInnerRadius = lTable->GetInnerRadius(); // the table is only valid for its own sphere
+    if (OMSimModuleBounds::GetNumberOfModules() > 0 && lInnerRadius <= OMSimModuleBounds::GetModule(0).Radius)
+    {
+        warning("Inner radius of the ice envelope is smaller than the module, envelope not constructed");
+        return;
+    }
+
+    G4Sphere* lEnvelopeSolid = new G4Sphere("BulkIceEnvelope", lInnerRadius, mWorldSolid->GetXHalfLength() - 1 * cm, 0, 360 * deg, 0, 180 * deg);
+    G4LogicalVolume* lEnvelopeLogical = new G4LogicalVolume(lEnvelopeSolid, mWorldLogical->GetMaterial(), "BulkIceEnvelope_log");
+    new G4PVPlacement(0, lCenter, lEnvelopeLogical, "BulkIceEnvelope_phys", mWorldLogical, false, 0);
+    lEnvelopeLogical->SetVisAttributes(G4VisAttributes::GetInvisible());
+    OMSimModuleBounds::AddBulkIce(lEnvelopeLogical);
+
+    if (gFastSimulation)
+    {
+        G4Region* lRegion = new G4Region("BulkIce");
+        lRegion->AddRootLogicalVolume(lEnvelopeLogical);
+        new OMSimIceFastModel("IceFastModel", lRegion, lCenter);
+    }
+    G4cout << "::::::::::::::Bulk ice envelope constructed (inner radius " << lInnerRadius / m << " m)::::::::::::" << G4endl;
+}
@@ -3,6 +3,11 @@
 #include "OMSimTrackingAction.hh"
 
 #include "OMSimAnalysisManager.hh"
+#include "OMSimProbes.hh"
+#include "OMSimPhotonCulling.hh"
+#include "OMSimNextEventEstimator.hh"
+#include "OMSimPhotonCache.hh"
+#include "OMSimShowerLibrary.hh"
 
 #include "G4Event.hh"
 #include "G4EventManager.hh"
@@ -13,6 +18,7 @@
 //#include "TH1.h"
 
 extern OMSimAnalysisManager gAnalysisManager;
+extern G4String gGeneratorMode;
 
 OMSimEventAction::OMSimEventAction()
 {}
@@ -23,9 +29,15 @@ OMSimEventAction::~OMSimEventAction()
 void OMSimEventAction::BeginOfEventAction(const G4Event* evt)
 {
 	gAnalysisManager.current_event_id = evt->GetEventID();
+	OMSimPhotonCulling::GetInstance()->BeginOfEvent();
+	if (OMSimNextEventEstimator::GetInstance()->IsActive()) OMSimNextEventEstimator::GetInstance()->BeginOfEvent();
+	if (OMSimPhotonCache::GetInstance()->IsRecording()) OMSimPhotonCache::GetInstance()->BeginOfEvent();
+	OMSIM_PROBE1(event_begin, evt->GetEventID());
 }
 
 void OMSimEventAction::EndOfEventAction(const G4Event* evt)
 {
-
+	OMSIM_PROBE2(event_end, evt->GetEventID(), gAnalysisManager.stats_PMT_hit.size());
+	if (OMSimNextEventEstimator::GetInstance()->IsActive()) OMSimNextEventEstimator::GetInstance()->EndOfEvent();
+	if (gGeneratorMode == "showerbuild") OMSimShowerLibrary::GetInstance()->EndShower();
 }
@@ -0,0 +1,192 @@
+/** @file OMSimIceFastModel.cc
+ *  @brief Fast simulation of the photon transport through the bulk ice with propagation tables.
+ *
+ *  @date October 2026
+ *
+ *  @version Geant4 10.7
+ */
+
+#include "OMSimIceFastModel.hh"
+#include "OMSimPropagationTable.hh"
+#include "OMSimPhotonInfo.hh"
+
+#include "G4FastStep.hh"
+#include "G4FastTrack.hh"
+#include "G4OpticalPhoton.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4Step.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4Track.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+
+#include "OMSimLogger.hh"
+
+extern G4String gPropagationTableFile;
+extern G4bool gFastSimValidation;
+extern G4String ghitsfilename;
+
+OMSimIceFastModel* OMSimIceFastModel::mInstance = nullptr;
+
+namespace
+{
+    const G4int gValidationBins = 100;
+    const G4double gSkin = 1 * um; // re-injected photons start this far inside the envelope
+}
+
+OMSimIceFastModel::OMSimIceFastModel(G4String pName, G4Region* pEnvelope, G4ThreeVector pCenter)
+    : G4VFastSimulationModel(pName, pEnvelope), mCenter(pCenter)
+{
+    mInstance = this;
+    mValidation = gFastSimValidation;
+    mTable = OMSimPropagationTable::GetInstance();
+    if (!mTable->IsLoaded() && !mTable->Load(gPropagationTableFile))
+    {
+        error("Fast simulation needs a propagation table (gPropagationTableFile), photons in the ice are tracked in detail");
+    }
+    mInnerRadius = mTable->GetInnerRadius();
+    Reset();
+}
+
+G4bool OMSimIceFastModel::IsApplicable(const G4ParticleDefinition& pParticle)
+{
+    return &pParticle == G4OpticalPhoton::Definition();
+}
+
+/**
+ * Triggered for every photon in the envelope, except photons that were just put on the inner sphere by DoIt and
+ * move inwards.
+ */
+G4bool OMSimIceFastModel::ModelTrigger(const G4FastTrack& pFastTrack)
+{
+    if (!mTable->IsLoaded()) return false;
+    const G4Track* lTrack = pFastTrack.GetPrimaryTrack();
+    const G4ThreeVector lFromCenter = lTrack->GetPosition() - mCenter;
+    if (lFromCenter.mag() < mInnerRadius + 1 * mm && lTrack->GetMomentumDirection().dot(lFromCenter) < 0) return false;
+    if (!mValidation) return true;
+
+    // validation: histogram the prediction once per photon and keep tracking it
+    OMSimPhotonInfo* lInfo = (OMSimPhotonInfo*)lTrack->GetUserInformation();
+    if (lInfo && lInfo->FastSimStartTime != -1) return false;
+    if (!lInfo)
+    {
+        lInfo = new OMSimPhotonInfo(lTrack->GetVertexPosition());
+        const_cast<G4Track*>(lTrack)->SetUserInformation(lInfo);
+    }
+    lInfo->FastSimStartTime = lTrack->GetGlobalTime();
+    mPhotons++;
+
+    const G4double lR = lFromCenter.mag();
+    const G4int lBin = mTable->FindBin(lR, -lTrack->GetMomentumDirection().dot(lFromCenter) / lR, h_Planck * c_light / lTrack->GetKineticEnergy());
+    const G4double lProbability = mTable->GetArrivalProbability(lBin);
+    const OMSimPropagationTable::Arrival* lArrival = mTable->SampleArrival(lBin);
+    mPredictedArrivals += lProbability;
+    if (lArrival)
+    {
+        const G4ThreeVector lPosition(lArrival->Position[0], lArrival->Position[1], lArrival->Position[2]);
+        const G4ThreeVector lDirection(lArrival->Direction[0], lArrival->Direction[1], lArrival->Direction[2]);
+        FillValidation(mDelay, lArrival->Delay * ns, 0, 2000 * ns, lProbability, true);
+        FillValidation(mArrivalCos, -lDirection.dot(lPosition), -1, 1, lProbability, true);
+    }
+    return false;
+}
+
+void OMSimIceFastModel::DoIt(const G4FastTrack& pFastTrack, G4FastStep& pFastStep)
+{
+    const G4Track* lTrack = pFastTrack.GetPrimaryTrack();
+    const G4ThreeVector lFromCenter = lTrack->GetPosition() - mCenter;
+    const G4ThreeVector lDirection = lTrack->GetMomentumDirection();
+    const G4double lR = lFromCenter.mag();
+    const G4int lBin = mTable->FindBin(lR, -lDirection.dot(lFromCenter) / lR, h_Planck * c_light / lTrack->GetKineticEnergy());
+
+    const OMSimPropagationTable::Arrival* lArrival = nullptr;
+    if (G4UniformRand() < mTable->GetArrivalProbability(lBin)) lArrival = mTable->SampleArrival(lBin);
+    if (!lArrival)
+    {
+        pFastStep.KillPrimaryTrack();
+        return;
+    }
+
+    G4ThreeVector lX, lY, lZ;
+    OMSimPropagationTable::LocalFrame(lFromCenter, lDirection, lX, lY, lZ);
+    if (G4UniformRand() < 0.5) lY = -lY; // mirror symmetry of the local frame
+
+    const G4ThreeVector lPosition = lArrival->Position[0] * lX + lArrival->Position[1] * lY + lArrival->Position[2] * lZ;
+    const G4ThreeVector lNewDirection = (lArrival->Direction[0] * lX + lArrival->Direction[1] * lY + lArrival->Direction[2] * lZ).unit();
+    const G4ThreeVector lE1 = lNewDirection.orthogonal().unit();
+    const G4double lPolarisation = twopi * G4UniformRand(); // scattered light is depolarised
+
+    pFastStep.ProposePrimaryTrackFinalPosition(mCenter + (mInnerRadius + gSkin) * lPosition.unit(), false);
+    pFastStep.ProposePrimaryTrackFinalTime(lTrack->GetGlobalTime() + lArrival->Delay * ns);
+    pFastStep.ProposePrimaryTrackFinalMomentumDirection(lNewDirection, false);
+    pFastStep.ProposePrimaryTrackFinalPolarization(std::cos(lPolarisation) * lE1 + std::sin(lPolarisation) * lNewDirection.cross(lE1), false);
+}
+
+/**
+ * @return true if the step goes from the envelope through its inner sphere
+ */
+G4bool OMSimIceFastModel::IsInnerSphereArrival(const G4Step* pStep)
+{
+    if (pStep->GetPostStepPoint()->GetStepStatus() != fGeomBoundary) return false;
+    const G4VPhysicalVolume* lPre = pStep->GetPreStepPoint()->GetPhysicalVolume();
+    return lPre && lPre->GetName() == "BulkIceEnvelope_phys" && pStep->GetPostStepPoint()->GetPhysicalVolume() != lPre;
+}
+
+/**
+ * Validation: histogram the first real arrival of a photon whose prediction was recorded.
+ */
+void OMSimIceFastModel::RecordValidationArrival(const G4Step* pStep)
+{
+    G4Track* lTrack = pStep->GetTrack();
+    OMSimPhotonInfo* lInfo = (OMSimPhotonInfo*)lTrack->GetUserInformation();
+    if (!lInfo || lInfo->FastSimStartTime < 0) return;
+    const G4ThreeVector lPosition = (pStep->GetPostStepPoint()->GetPosition() - mCenter).unit();
+    if (lPosition.dot(pStep->GetPostStepPoint()->GetMomentumDirection()) >= 0) return; // leaving through the outer sphere
+
+    mTrackedArrivals += 1;
+    FillValidation(mDelay, pStep->GetPostStepPoint()->GetGlobalTime() - lInfo->FastSimStartTime, 0, 2000 * ns, 1, false);
+    FillValidation(mArrivalCos, -pStep->GetPostStepPoint()->GetMomentumDirection().dot(lPosition), -1, 1, 1, false);
+    lInfo->FastSimStartTime = -2; // only the first arrival counts
+}
+
+void OMSimIceFastModel::FillValidation(Histogram& pHistogram, G4double pValue, G4double pMin, G4double pMax, G4double pWeight, G4bool pPredicted)
+{
+    G4int lBin = (G4int)((pValue - pMin) / (pMax - pMin) * gValidationBins);
+    lBin = std::max(0, std::min(gValidationBins, lBin)); // last bin is overflow
+    (pPredicted ? pHistogram.Predicted : pHistogram.Tracked)[lBin] += pWeight;
+}
+
+/**
+ * Print the arrival fractions and write the histograms of table prediction and full tracking, one line per bin:
+ * lower edge, predicted, tracked (delay histogram first, then the arrival angle histogram).
+ */
+void OMSimIceFastModel::PrintValidation()
+{
+    if (!mValidation || mPhotons == 0) return;
+    G4cout << "::::::::::::Fast simulation validation (" << mPhotons << " photons entering the ice envelope):::::::::::" << G4endl;
+    G4cout << "Arrivals on the inner sphere predicted by the table: " << mPredictedArrivals
+           << ", tracked: " << mTrackedArrivals << " +- " << std::sqrt(mTrackedArrivals) << G4endl;
+
+    std::ofstream lFile((ghitsfilename + ".fastsim_validation").c_str());
+    if (!lFile.is_open()) return;
+    lFile << "# delay[ns] predicted tracked" << std::endl;
+    for (G4int i = 0; i <= gValidationBins; i++) lFile << i * 2000. / gValidationBins << "\t" << mDelay.Predicted[i] << "\t" << mDelay.Tracked[i] << std::endl;
+    lFile << std::endl << "# cos(arrival angle) predicted tracked" << std::endl;
+    for (G4int i = 0; i <= gValidationBins; i++) lFile << -1 + 2. * i / gValidationBins << "\t" << mArrivalCos.Predicted[i] << "\t" << mArrivalCos.Tracked[i] << std::endl;
+}
+
+void OMSimIceFastModel::Reset()
+{
+    for (Histogram* lHistogram : {&mDelay, &mArrivalCos})
+    {
+        lHistogram->Predicted.assign(gValidationBins + 1, 0);
+        lHistogram->Tracked.assign(gValidationBins + 1, 0);
+    }
+    mPredictedArrivals = 0;
+    mTrackedArrivals = 0;
+    mPhotons = 0;
+}
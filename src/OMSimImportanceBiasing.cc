@@ -0,0 +1,122 @@
+/** @file OMSimImportanceBiasing.cc
+ *  @brief Splitting and Russian roulette of optical photons on concentric importance shells around the modules.
+ *
+ *  @date October 2026
+ *
+ *  @version Geant4 10.7
+ */
+
+#include "OMSimImportanceBiasing.hh"
+#include "OMSimModuleBounds.hh"
+#include "OMSimPhotonInfo.hh"
+#include "OMSimAnalysisManager.hh"
+
+#include "G4DynamicParticle.hh"
+#include "G4OpticalPhoton.hh"
+#include "G4Step.hh"
+#include "G4Track.hh"
+#include "G4VPhysicalVolume.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <cmath>
+
+extern G4int gImportanceShells;
+extern G4double gImportanceRadiusRatio;
+extern G4int gImportanceSplit;
+extern OMSimAnalysisManager gAnalysisManager;
+
+OMSimImportanceBiasing* OMSimImportanceBiasing::GetInstance()
+{
+    static G4ThreadLocal OMSimImportanceBiasing* lInstance = nullptr;
+    if (!lInstance) lInstance = new OMSimImportanceBiasing();
+    return lInstance;
+}
+
+OMSimImportanceBiasing::OMSimImportanceBiasing()
+{
+    mNrShells = gImportanceShells;
+    mLogRadiusRatio = std::log(gImportanceRadiusRatio);
+    mSplit = gImportanceSplit;
+    if (IsActive()) gAnalysisManager.weighted = true;
+}
+
+/**
+ * @return Number of shells between the closest module and pPosition (0 next to the module, mNrShells far away)
+ */
+G4int OMSimImportanceBiasing::GetCell(const G4ThreeVector& pPosition)
+{
+    const G4int lModule = OMSimModuleBounds::NearestModule(pPosition);
+    if (lModule < 0) return 0;
+    const OMSimModuleBounds::Sphere& lSphere = OMSimModuleBounds::GetModule(lModule);
+    const G4double lRatio = (pPosition - lSphere.Center).mag() / lSphere.Radius;
+    if (lRatio <= 1) return 0;
+    return std::min(mNrShells, (G4int)std::floor(std::log(lRatio) / mLogRadiusRatio));
+}
+
+/**
+ * Split or roulette the photon of this step. Copies start at the post-step point with the post-step state of the
+ * photon and are added to the secondaries of the step.
+ * @param pStep Current step of an optical photon
+ * @param pSecondaries Secondary vector of the stepping manager
+ */
+void OMSimImportanceBiasing::Apply(const G4Step* pStep, G4TrackVector* pSecondaries)
+{
+    G4VPhysicalVolume* lVolume = pStep->GetPostStepPoint()->GetPhysicalVolume();
+    if (!OMSimModuleBounds::IsBulkIce(lVolume)) return; // only in the ice around the modules
+
+    const G4int lCellDifference = GetCell(pStep->GetPreStepPoint()->GetPosition()) - GetCell(pStep->GetPostStepPoint()->GetPosition());
+    if (lCellDifference == 0) return;
+
+    G4Track* lTrack = pStep->GetTrack();
+    const G4double lImportanceRatio = std::pow(mSplit, lCellDifference);
+
+    if (lCellDifference < 0) // moving outwards: Russian roulette
+    {
+        if (G4UniformRand() < lImportanceRatio)
+        {
+            lTrack->SetWeight(lTrack->GetWeight() / lImportanceRatio);
+            mRouletteSurvived++;
+        }
+        else
+        {
+            lTrack->SetTrackStatus(fStopAndKill);
+            mRouletteKilled++;
+        }
+        return;
+    }
+
+    // moving inwards: split in lImportanceRatio photons with equal weight
+    const G4int lCopies = (G4int)std::lround(lImportanceRatio);
+    const G4double lWeight = lTrack->GetWeight() / lCopies;
+    lTrack->SetWeight(lWeight);
+    const G4ThreeVector lVertex = OMSimPhotonInfo::GetOriginalVertex(lTrack);
+    OMSimPhotonInfo* lInfo = (OMSimPhotonInfo*)lTrack->GetUserInformation();
+    const G4ThreeVector lPolarization = lTrack->GetPolarization();
+    for (G4int i = 1; i < lCopies; i++)
+    {
+        G4DynamicParticle* lParticle = new G4DynamicParticle(G4OpticalPhoton::Definition(), lTrack->GetMomentumDirection(), lTrack->GetKineticEnergy());
+        lParticle->SetPolarization(lPolarization.x(), lPolarization.y(), lPolarization.z());
+        G4Track* lCopy = new G4Track(lParticle, lTrack->GetGlobalTime(), lTrack->GetPosition());
+        lCopy->SetWeight(lWeight);
+        lCopy->SetParentID(lTrack->GetParentID()); // keeps the ancestry (positron id) of the hit record
+        lCopy->SetCreatorProcess(lTrack->GetCreatorProcess());
+        lCopy->SetUserInformation(lInfo ? new OMSimPhotonInfo(*lInfo) : new OMSimPhotonInfo(lVertex));
+        pSecondaries->push_back(lCopy);
+    }
+    mSplitCopies += lCopies - 1;
+}
+
+void OMSimImportanceBiasing::PrintSummary()
+{
+    if (!IsActive()) return;
+    G4cout << "::::::::::::Importance biasing (" << mNrShells << " shells, split factor " << mSplit << "):::::::::::" << G4endl;
+    G4cout << "Copies from splitting: " << mSplitCopies << ", roulette survived: " << mRouletteSurvived << ", killed: " << mRouletteKilled << G4endl;
+}
+
+void OMSimImportanceBiasing::Reset()
+{
+    mSplitCopies = 0;
+    mRouletteKilled = 0;
+    mRouletteSurvived = 0;
+}
@@ -54,8 +54,9 @@ void ParameterTable::AppendParameterTable(G4String pFileName)
     pt::read_json(pFileName, lJsonTree);
     const G4String lName = lJsonTree.get<G4String>("jName");
     mTable[lName] = lJsonTree;
+    mFileNames[lName] = pFileName;
     G4String mssg = lName + " added to dictionary...";
-    info(mssg);
+    info("%s", mssg.c_str());
 }
 
 /**
@@ -226,7 +227,7 @@ G4OpticalSurface* OMSimInputData::GetOpticalSurface(G4String pName)
         }
         else
         {   G4String mssg = "Requested Optical Surface " + pName + " not found. This will cause a segmentation fault. Please check the name!!";
-            critical(mssg);
+            critical("%s", mssg.c_str());
         }
     }
 }
@@ -9,6 +9,8 @@
 
 #include "OMSimLOM16.hh"
 #include "abcDetectorComponent.hh"
+#include "OMSimTimeline.hh"
+#include "OMSimCADMesh.hh"
 #include <dirent.h>
 #include <stdexcept>
 #include <cstdlib>
@@ -50,6 +52,7 @@ extern G4bool gCADImport;
 //Implement Harness
 //Redo these imports: mTotalLenght = mData->GetValue("pmt_Hamamatsu_4inch", "jOuterShape.jTotalLenght");
 LOM16::LOM16(OMSimInputData* pData, G4bool pPlaceHarness) {
+    OMSimScopedTimer lTimer("LOM16 construction");
     mData = pData;
     mPMTManager = new OMSimPMTConstruction(mData);
     mPMTManager->SelectPMT("argPMT");
@@ -198,13 +201,13 @@ void LOM16::PlaceCADSupportStructure(G4LogicalVolume* lInnerVolumeLogical)
     G4cout <<  "using the following CAD file for support structure: "  << CADfile.str()  << G4endl;
 
     //load mesh
-    auto mesh = CADMesh::TessellatedMesh::FromOBJ("../data/CADmeshes/LOM16/" + CADfile.str() );
+    OMSimScopedTimer lCADTimer("CAD mesh " + CADfile.str());
+    const G4String lCADPath = "../data/CADmeshes/LOM16/" + CADfile.str();
     G4ThreeVector CADoffset = G4ThreeVector(68.248*mm, 0, -124.218*mm); //measured from CAD file since origin =!= Module origin
-    mesh->SetOffset(CADoffset);
    // mesh->SetScale(10); //did a mistake...this LOM_Internal file needs cm -> mm -> x10
 
-    // Place all of the meshes it can find in the file as solids individually.
-    for (auto solid : mesh->GetSolids())
+    // Place the meshes of the file, one solid per part or one for all of them (see OMSimCADMesh)
+    for (auto solid : OMSimCADMesh::Process(OMSimCADMesh::Load(lCADPath, CADoffset), CADfile.str()))
     { 
         mSupportStructureLogical  = new G4LogicalVolume( solid , mData->GetMaterial("NoOptic_Absorber") , "logical" , 0, 0, 0);
         mSupportStructureLogical->SetVisAttributes(mAluVis);
@@ -9,6 +9,10 @@
 
 #include "OMSimLOM18.hh"
 #include "abcDetectorComponent.hh"
+#include "OMSimTimeline.hh"
+#include "OMSimCADMesh.hh"
+#include "OMSimRevolvedSolid.hh"
+#include "OMSimSolidCheck.hh"
 #include <dirent.h>
 #include <stdexcept>
 #include <cstdlib>
@@ -36,6 +40,8 @@
 
 #include "CADMesh.hh" //CAD import from .obj files (tesselated -> not for optical stuff)
 
+#include "OMSimLogger.hh"
+
 
 
 extern G4int gDOM;
@@ -44,10 +50,13 @@ extern G4bool gVisual;
 extern G4double gmdomseparation;
 extern G4int gn_mDOMs;
 extern G4bool gCADImport;
+extern G4bool gAnalyticVessels;
+extern G4int gVesselCheck;
 
 
 
 LOM18::LOM18(OMSimInputData* pData, G4bool pPlaceHarness) {
+    OMSimScopedTimer lTimer("LOM18 construction");
     mData = pData;
     mPMTManager = new OMSimPMTConstruction(mData);
     mPMTManager->SelectPMT("argPMT");
@@ -120,8 +129,9 @@ void LOM18::GetSharedData() {
 void LOM18::Construction()
 {
     //Create pressure vessel and inner volume
-    G4Polycone* lGlassSolid = CreateLOM18OuterSolid();
-    G4Polycone* lInnerVolumeSolid = CreateLOM18InnerSolid();
+    G4Polycone* lInnerVolumePolycone = CreateLOM18InnerSolid();
+    G4VSolid* lGlassSolid = AnalyticVessel(CreateLOM18OuterSolid(), "LOM18 glass");
+    G4VSolid* lInnerVolumeSolid = AnalyticVessel(lInnerVolumePolycone, "LOM18 inner volume");
 
     //Set positions and rotations of PMTs and gelpads
     SetPMTPositions();
@@ -129,7 +139,7 @@ void LOM18::Construction()
     //Logicals
     G4LogicalVolume* lInnerVolumeLogical = new G4LogicalVolume(lInnerVolumeSolid, mData->GetMaterial("Ri_Air"), "Inner volume logical"); //Inner volume of vessel (mothervolume of all internal components)
     G4LogicalVolume* lGlassLogical = new G4LogicalVolume(lGlassSolid, mData->GetMaterial("argVesselGlass")," Glass_log"); //Vessel
-    CreateGelpadLogicalVolumes(lInnerVolumeSolid);
+    CreateGelpadLogicalVolumes(lInnerVolumePolycone);
     G4LogicalVolume* lEquatorbandLogical = CreateEquatorBand();
 
     //Placements
@@ -310,6 +320,25 @@ G4Polycone* LOM18::CreateLOM18InnerSolid()
 	return solid;
 }
 
+/**
+ * With gAnalyticVessels, the polycone is replaced by an OMSimRevolvedSolid of the same shape (one convex piece), whose
+ * intersections are computed in closed form. gVesselCheck > 0 compares both solids.
+ * @return Solid to use for the logical volume
+ */
+G4VSolid* LOM18::AnalyticVessel(G4Polycone* pPolycone, G4String pName)
+{
+    if (!gAnalyticVessels) return pPolycone;
+    OMSimRevolvedSolid* lVessel = new OMSimRevolvedSolid(pName + " analytic", pPolycone);
+    if (!lVessel->AddConvexPolycone(pPolycone))
+    {
+        warning("%s is not a convex polycone, it is kept as G4Polycone", pName.c_str());
+        delete lVessel;
+        return pPolycone;
+    }
+    if (gVesselCheck > 0) OMSimSolidCheck::CompareAndPrint(pPolycone, lVessel, gVesselCheck, "Analytic " + pName);
+    return lVessel;
+}
+
 /**
  * Creation of LogicalVolume of equator band
  * @return LogicalVolume of equator band
@@ -353,20 +382,20 @@ void LOM18::PlaceCADSupportStructure(G4LogicalVolume* lInnerVolumeLogical)
     G4cout <<  "using the following CAD file for support structure: "  << CADfile.str()  << G4endl;
 
     //load mesh
-    auto mesh = CADMesh::TessellatedMesh::FromOBJ("../data/CADmeshes/LOM18/" + CADfile.str() );
+    OMSimScopedTimer lCADTimer("CAD mesh " + CADfile.str());
+    const G4String lCADPath = "../data/CADmeshes/LOM18/" + CADfile.str();
     //auto mesh = CADMesh::TessellatedMesh::FromOBJ("../data/CADmeshes/PMT/PMTInternalsNoSpiderUpTo3rdDynode.obj");
 
 
     //Offset
     G4ThreeVector CADoffset = G4ThreeVector(0, 0, 0); //measured from CAD file since origin =!= Module origin
-    mesh->SetOffset(CADoffset);
 
     //rotate
     lRot = new G4RotationMatrix();
     lRot->rotateZ(45*deg);
 
-    // Place all of the meshes it can find in the file as solids individually.
-    for (auto solid : mesh->GetSolids())
+    // Place the meshes of the file, one solid per part or one for all of them (see OMSimCADMesh)
+    for (auto solid : OMSimCADMesh::Process(OMSimCADMesh::Load(lCADPath, CADoffset), CADfile.str()))
     {
         mSupportStructureLogical  = new G4LogicalVolume( solid , mData->GetMaterial("NoOptic_Absorber") , "logical" , 0, 0, 0); //should be Refl_AluminiumGround
         mSupportStructureLogical->SetVisAttributes(mAluVis);
@@ -388,19 +417,19 @@ void LOM18::PlaceCADPenetrator(G4LogicalVolume* lInnerVolumeLogical)
     G4cout <<  "using the following CAD file for penetrator: "  << CADfile.str()  << G4endl;
 
     //load mesh
-    auto mesh = CADMesh::TessellatedMesh::FromOBJ("../data/CADmeshes/LOM18/" + CADfile.str() );
+    OMSimScopedTimer lCADTimer("CAD mesh " + CADfile.str());
+    const G4String lCADPath = "../data/CADmeshes/LOM18/" + CADfile.str();
 
     //Offset
     G4ThreeVector CADoffset = G4ThreeVector(0, 0, 0); //measured from CAD file since origin =!= Module origin
-    mesh->SetOffset(CADoffset);
 
     //rotate
     lRot = new G4RotationMatrix();
     //lRot->rotateY(mPMT_theta[k]);
     lRot->rotateZ(45*deg);
 
-    // Place all of the meshes it can find in the file as solids individually.
-    for (auto solid : mesh->GetSolids())
+    // Place the meshes of the file, one solid per part or one for all of them (see OMSimCADMesh)
+    for (auto solid : OMSimCADMesh::Process(OMSimCADMesh::Load(lCADPath, CADoffset), CADfile.str()))
     {
         mSupportStructureLogical  = new G4LogicalVolume( solid , mData->GetMaterial("NoOptic_Absorber") , "logical" , 0, 0, 0);
         mSupportStructureLogical->SetVisAttributes(mAluVis);
@@ -10,6 +10,9 @@
 #include "OMSimMDOM.hh"
 #include "OMSimMDOMHarness.hh"
 #include "abcDetectorComponent.hh"
+#include "OMSimTimeline.hh"
+#include "OMSimSolidCheck.hh"
+#include "OMSimRevolvedSolid.hh"
 #include <dirent.h>
 #include <stdexcept>
 #include <cstdlib>
@@ -22,6 +25,7 @@
 #include "G4LogicalBorderSurface.hh"
 #include "G4LogicalSkinSurface.hh"
 #include "G4LogicalVolume.hh"
+#include "G4MultiUnion.hh"
 #include "G4Orb.hh"
 #include "G4Polycone.hh"
 #include "G4PVPlacement.hh"
@@ -34,15 +38,22 @@
 #include "G4VisAttributes.hh"
 #include "G4Torus.hh"
 
+#include "OMSimLogger.hh"
+
 
 extern G4int gDOM;
 extern G4bool gharness_ropes;
 extern G4bool gVisual;
 extern G4double gmdomseparation;
 extern G4int gn_mDOMs;
+extern G4bool gFlatSupportStructure;
+extern G4int gSupportStructureCheck;
+extern G4bool gAnalyticVessels;
+extern G4int gVesselCheck;
 
 
 mDOM::mDOM(OMSimInputData* pData, G4bool pPlaceHarness) {
+    OMSimScopedTimer lTimer("mDOM construction");
     mPlaceHarness = pPlaceHarness;
     mData = pData;
     mPMTManager = new OMSimPMTConstruction(mData);
@@ -51,7 +62,7 @@ mDOM::mDOM(OMSimInputData* pData, G4bool pPlaceHarness) {
     GetSharedData();
     if (mPlaceHarness){
          mHarness = new mDOMHarness(this, mData);
-         IntegrateDetectorComponent(mHarness, G4ThreeVector(0,0,0), G4RotationMatrix(), "");
+         IntegrateHarness(mHarness, {"Plug"}); // the plug fills its hole in glass, gel and holder at every level of detail
     }
     Construction();
 }
@@ -87,8 +98,8 @@ void mDOM::GenerateLogicals()
     SetLEDPositions();
     std::cerr << "OMSimMDOM::set position succeed " << std::endl;
 
-    G4UnionSolid* lGlassSolid = PressureVessel(mGlassOutRad, "Glass");
-    G4UnionSolid* lGelSolid = PressureVessel(mGlassInRad, "Gel");
+    G4VSolid* lGlassSolid = PressureVessel(mGlassOutRad, "Glass");
+    G4VSolid* lGelSolid = PressureVessel(mGlassInRad, "Gel");
     std::cerr << "OMSimMDOM::glass solid and gel solid generated" << std::endl;
 
     G4SubtractionSolid* lSupStructureSolid;
@@ -125,11 +136,16 @@ void mDOM::GenerateLogicals()
 
     std::cerr << "OMSimMDOM::led flashers generated" << std::endl;
 
+    //Holder: chain of subtractions or flat solid (see FlatSupportStructure)
+    G4VSolid* lHolderSolid = lSupStructureSolid;
+    if (mPlaceHarness && lHolderSolid) lHolderSolid = SubstractHarnessPlug(lHolderSolid);
+    if (gFlatSupportStructure) lHolderSolid = FlatSupportStructure(lSupStructureFirstSolid, lHolderSolid);
+
     //Logicals
     lGelLogical = new G4LogicalVolume(lGelSolid,
         mData->GetMaterial("argGel"),
         "Gelcorpus logical");
-    lSupStructureLogical = new G4LogicalVolume(lSupStructureSolid,
+    lSupStructureLogical = new G4LogicalVolume(lHolderSolid,
         mData->GetMaterial("NoOptic_Absorber"),
         "TubeHolder logical");
     lGlassLogical = new G4LogicalVolume(lGlassSolid,
@@ -140,7 +156,7 @@ void mDOM::GenerateLogicals()
         lGelLogical = new G4LogicalVolume(SubstractHarnessPlug(lGelSolid),
             mData->GetMaterial("argGel"),
             "Gelcorpus logical");
-        lSupStructureLogical = new G4LogicalVolume(SubstractHarnessPlug(lSupStructureSolid),
+        lSupStructureLogical = new G4LogicalVolume(lHolderSolid,
             mData->GetMaterial("NoOptic_Absorber"),
             "TubeHolder logical");
         lGlassLogical = new G4LogicalVolume(SubstractHarnessPlug(lGlassSolid),
@@ -250,7 +266,11 @@ void mDOM::Construction()
 }
 
 
-G4UnionSolid* mDOM::PressureVessel(const G4double pOutRad, G4String pSuffix)
+/**
+ * Polycone + two hemispheres. With gAnalyticVessels the same shape is returned as an OMSimRevolvedSolid (the polycone,
+ * convex, as one piece and the two cut spheres), with the boolean union kept as reference for the visualisation.
+ */
+G4VSolid* mDOM::PressureVessel(const G4double pOutRad, G4String pSuffix)
 {
     G4Ellipsoid* lTopSolid = new G4Ellipsoid("SphereTop solid" + pSuffix, pOutRad, pOutRad, pOutRad, -5 * mm, pOutRad + 5 * mm);
     G4Ellipsoid* lBottomSolid = new G4Ellipsoid("SphereBottom solid" + pSuffix, pOutRad, pOutRad, pOutRad, -(pOutRad + 5 * mm), 5 * mm);
@@ -261,7 +281,19 @@ G4UnionSolid* mDOM::PressureVessel(const G4double pOutRad, G4String pSuffix)
 
     G4UnionSolid* lTempUnion = new G4UnionSolid("temp" + pSuffix, lCylinderSolid, lTopSolid, 0, G4ThreeVector(0, 0, mCylHigh));
     G4UnionSolid* lUnionSolid = new G4UnionSolid("OM body" + pSuffix, lTempUnion, lBottomSolid, 0, G4ThreeVector(0, 0, -mCylHigh));
-    return lUnionSolid;
+    if (!gAnalyticVessels) return lUnionSolid;
+
+    OMSimRevolvedSolid* lVessel = new OMSimRevolvedSolid("OM body analytic" + pSuffix, lUnionSolid);
+    lVessel->AddEllipsoid(pOutRad, pOutRad, mCylHigh, mCylHigh - 5 * mm);
+    lVessel->AddEllipsoid(pOutRad, pOutRad, -mCylHigh, -kInfinity, -mCylHigh + 5 * mm);
+    if (!lVessel->AddConvexPolycone(lCylinderSolid))
+    {
+        warning("The polycone of the mDOM vessel %s is not convex, the boolean solid is used", pSuffix.c_str());
+        delete lVessel;
+        return lUnionSolid;
+    }
+    if (gVesselCheck > 0) OMSimSolidCheck::CompareAndPrint(lUnionSolid, lVessel, gVesselCheck, "Analytic mDOM vessel " + pSuffix);
+    return lVessel;
 }
 
 std::tuple<G4SubtractionSolid*, G4UnionSolid*> mDOM::SupportStructure()
@@ -287,12 +319,16 @@ std::tuple<G4SubtractionSolid*, G4UnionSolid*> mDOM::SupportStructure()
     G4UnionSolid* lRefConeNestSolid = new G4UnionSolid("RefConeNest", lPMTsolid, lRefConeNestConeSolid, 0, G4ThreeVector(0, 0, 1.5 * mRefConeHalfZ));
 
 
-    //Support structure substraction
-    G4SubtractionSolid* lSupStructureSolid;
+    //Support structure substraction, the chain is not built for the flat holder unless it is checked against it
+    const G4bool lChain = !gFlatSupportStructure || gSupportStructureCheck > 0;
+    G4SubtractionSolid* lSupStructureSolid = nullptr;
     G4Transform3D lTransformers;
+    mHolderCutouts.clear();
     for (int k = 0; k <= mTotalNrPMTs - 1; k++)
     {
         lTransformers = G4Transform3D(mPMTRotations[k], mPMTPositions[k]);
+        mHolderCutouts.push_back(std::make_pair(lRefConeNestSolid, lTransformers));
+        if (!lChain) continue;
         if (k == 0) lSupStructureSolid = new G4SubtractionSolid("TubeHolder solid", lSupStructureFirstSolid, lRefConeNestSolid, lTransformers);
         else lSupStructureSolid = new G4SubtractionSolid("TubeHolder solid", lSupStructureSolid, lRefConeNestSolid, lTransformers);
     }
@@ -351,9 +387,36 @@ G4SubtractionSolid* mDOM::SubstractHarnessPlug(G4VSolid* pSolid) {
     return lSolidSubstracted;
 }
 
+/**
+ * Holder as the foam minus a single voxelised G4MultiUnion of the PMT nests, the LED cuts and the harness plug. It is
+ * the same shape as the chain of subtractions, but a point is only tested against the cut-outs of its voxel instead of
+ * walking the whole tree. With gSupportStructureCheck > 0 both solids are compared and the speed-up is printed; only
+ * then is the chain of subtractions built at all.
+ * @param pFoam Holder before the cut-outs
+ * @param pChain Holder built as a chain of subtractions (reference of the check), nullptr if it was not built
+ */
+G4VSolid* mDOM::FlatSupportStructure(G4VSolid* pFoam, G4VSolid* pChain)
+{
+    OMSimScopedTimer lTimer("mDOM flat support structure");
+    G4MultiUnion* lCutouts = new G4MultiUnion("TubeHolder cutouts");
+    for (std::pair<G4VSolid*, G4Transform3D>& lCutout : mHolderCutouts) lCutouts->AddNode(*lCutout.first, lCutout.second);
+    if (mPlaceHarness)
+    {
+        Component Plug = mHarness->GetComponent("Plug");
+        G4Transform3D lPlugTransform = G4Transform3D(Plug.Rotation, Plug.Position);
+        lCutouts->AddNode(*Plug.VSolid, lPlugTransform);
+    }
+    lCutouts->Voxelize();
+    G4SubtractionSolid* lFlatSolid = new G4SubtractionSolid("TubeHolder flat solid", pFoam, lCutouts);
+    info("mDOM holder built from %d cut-outs in one voxelised multi-union", lCutouts->GetNumberOfSolids());
+
+    if (gSupportStructureCheck > 0 && pChain) OMSimSolidCheck::CompareAndPrint(pChain, lFlatSolid, gSupportStructureCheck, "Flat mDOM holder");
+    return lFlatSolid;
+}
+
 std::tuple<G4SubtractionSolid*, G4UnionSolid*, G4UnionSolid*, G4Tubs*> mDOM::LedFlashers(G4VSolid* lSupStructureSolid){
 
-    G4SubtractionSolid* lSupStructureSolidSub;
+    G4SubtractionSolid* lSupStructureSolidSub = nullptr;
 
 	// cut in holding structure to place afterwards LEDs inside 
     //NOTE: This should not be necessary (substraction with lAirSolid should be enough), but somehow a visual glitch is visible otherwise
@@ -376,6 +439,8 @@ std::tuple<G4SubtractionSolid*, G4UnionSolid*, G4UnionSolid*, G4Tubs*> mDOM::Led
 	
 	// subtraction holding structure
     for (int k = 0; k <= mNrTotalLED-1; k++) {    
+        mHolderCutouts.push_back(std::make_pair(lCutTubeHolderSolid, mLEDTransformers[k]));
+        if (!lSupStructureSolid) continue;
 		if (k==0){
             lSupStructureSolidSub = new G4SubtractionSolid("TubeHolderSub solid", lSupStructureSolid, lCutTubeHolderSolid, mLEDTransformers[k]);
 			} 		
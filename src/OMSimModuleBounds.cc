@@ -0,0 +1,172 @@
+/** @file OMSimModuleBounds.cc
+ *  @brief Bounding spheres of the placed optical modules.
+ *
+ *  @date October 2026
+ *
+ *  @version Geant4 10.7
+ */
+
+#include "OMSimModuleBounds.hh"
+
+#include "G4Step.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4VTouchable.hh"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+std::vector<OMSimModuleBounds::Sphere> OMSimModuleBounds::mModules;
+std::vector<const G4LogicalVolume*> OMSimModuleBounds::mBulkIce;
+std::vector<std::pair<const G4LogicalVolume*, G4int>> OMSimModuleBounds::mEnvelopes;
+
+/**
+ * Forget all modules, called at the beginning of every (re)construction of the geometry.
+ */
+void OMSimModuleBounds::Clear()
+{
+    mModules.clear();
+    mBulkIce.clear();
+    mEnvelopes.clear();
+}
+
+/**
+ * @param pCenter Position of the module in the world
+ * @param pRadius Radius of a sphere around pCenter containing the full module (harness included)
+ * @return Index of the module
+ */
+G4int OMSimModuleBounds::AddModule(G4ThreeVector pCenter, G4double pRadius)
+{
+    mModules.push_back({pCenter, pRadius});
+    return (G4int)mModules.size() - 1;
+}
+
+/**
+ * @return Index of the module whose bounding sphere surface is closest to pPosition, -1 if there is no module
+ */
+G4int OMSimModuleBounds::NearestModule(const G4ThreeVector& pPosition)
+{
+    G4int lNearest = -1;
+    G4double lMinDistance = DBL_MAX;
+    for (G4int i = 0; i < (G4int)mModules.size(); i++)
+    {
+        const G4double lDistance = (pPosition - mModules[i].Center).mag() - mModules[i].Radius;
+        if (lDistance < lMinDistance)
+        {
+            lMinDistance = lDistance;
+            lNearest = i;
+        }
+    }
+    return lNearest;
+}
+
+/**
+ * @return Distance from pPosition to the closest bounding sphere surface (negative inside a sphere, DBL_MAX without modules)
+ */
+G4double OMSimModuleBounds::DistanceToNearest(const G4ThreeVector& pPosition)
+{
+    const G4int lNearest = NearestModule(pPosition);
+    if (lNearest < 0) return DBL_MAX;
+    return (pPosition - mModules[lNearest].Center).mag() - mModules[lNearest].Radius;
+}
+
+/**
+ * Module of a volume inside a module. Without envelopes the components of module i are placed with copy number i (the
+ * index returned by AddModule). Inside the ice envelopes of an array, the module ID is the sum of the copy numbers of
+ * the envelopes times their strides (see AddEnvelope) and of the copy number of the outermost component.
+ * @return Module ID, -1 for a volume outside of all modules
+ */
+G4int OMSimModuleBounds::GetModuleID(const G4VTouchable* pTouchable)
+{
+    G4int lID = 0;
+    for (G4int lDepth = pTouchable->GetHistoryDepth() - 1; lDepth >= 0; lDepth--)
+    {
+        const G4VPhysicalVolume* lVolume = pTouchable->GetVolume(lDepth);
+        G4int lStride = 0;
+        for (const auto& lEnvelope : mEnvelopes)
+        {
+            if (lEnvelope.first == lVolume->GetLogicalVolume()) lStride = lEnvelope.second;
+        }
+        if (lStride > 0) lID += lStride * pTouchable->GetCopyNumber(lDepth);
+        else if (!IsBulkIce(lVolume)) return lID + pTouchable->GetCopyNumber(lDepth);
+    }
+    return -1;
+}
+
+/**
+ * Check if a straight step crosses into a sphere: the pre-step point is outside and the segment of the step meets the
+ * sphere. The post-step point may lie inside or outside (photons passing through the sphere without stopping on the
+ * module geometry count as well, as in the acceptance tables).
+ * @param pCrossing Returns the first intersection of the step with the sphere (global coordinates)
+ * @param pFraction Returns the fraction of the step length at which the intersection lies
+ * @return true if the step enters the sphere
+ */
+G4bool OMSimModuleBounds::StepEntersSphere(const G4Step* pStep, const G4ThreeVector& pCenter, G4double pRadius, G4ThreeVector& pCrossing, G4double& pFraction)
+{
+    const G4ThreeVector lStart = pStep->GetPreStepPoint()->GetPosition() - pCenter;
+    const G4double lC = lStart.mag2() - pRadius * pRadius;
+    if (lC <= 0) return false;
+
+    // |start + t * direction| = R with 0 <= t <= step length
+    const G4ThreeVector lDirection = pStep->GetPreStepPoint()->GetMomentumDirection();
+    const G4double lB = lStart.dot(lDirection);
+    const G4double lDiscriminant = lB * lB - lC;
+    if (lB >= 0 || lDiscriminant < 0) return false;
+    const G4double lT = -lB - std::sqrt(lDiscriminant);
+    const G4double lLength = pStep->GetStepLength();
+    if (lT > lLength) return false;
+    pCrossing = pCenter + lStart + lT * lDirection;
+    pFraction = lLength > 0 ? lT / lLength : 0;
+    return true;
+}
+
+/**
+ * Module whose bounding sphere a step enters first (see StepEntersSphere), for steps that may pass several modules.
+ * @param pCrossing Returns the intersection of the step with that sphere (global coordinates)
+ * @param pFraction Returns the fraction of the step length at which the intersection lies
+ * @return Module index, -1 if the step enters no sphere
+ */
+G4int OMSimModuleBounds::FirstEnteredModule(const G4Step* pStep, G4ThreeVector& pCrossing, G4double& pFraction)
+{
+    G4int lFirst = -1;
+    G4ThreeVector lCrossing;
+    G4double lFraction;
+    for (G4int i = 0; i < (G4int)mModules.size(); i++)
+    {
+        if (!StepEntersSphere(pStep, mModules[i].Center, mModules[i].Radius, lCrossing, lFraction)) continue;
+        if (lFirst >= 0 && lFraction >= pFraction) continue;
+        lFirst = i;
+        pCrossing = lCrossing;
+        pFraction = lFraction;
+    }
+    return lFirst;
+}
+
+/**
+ * @param pVolume Logical volume made of the world ice, placed outside of all modules
+ */
+void OMSimModuleBounds::AddBulkIce(const G4LogicalVolume* pVolume)
+{
+    mBulkIce.push_back(pVolume);
+}
+
+/**
+ * Ice envelope of the module array, also treated as bulk ice.
+ * @param pVolume Envelope logical volume, placed with a copy number per placement
+ * @param pStride Module ID difference between consecutive copies (e.g. modules per string for string envelopes)
+ */
+void OMSimModuleBounds::AddEnvelope(const G4LogicalVolume* pVolume, G4int pStride)
+{
+    mBulkIce.push_back(pVolume);
+    mEnvelopes.push_back({pVolume, pStride});
+}
+
+/**
+ * @return true for the world volume and the volumes registered with AddBulkIce
+ */
+G4bool OMSimModuleBounds::IsBulkIce(const G4VPhysicalVolume* pVolume)
+{
+    if (!pVolume) return false;
+    if (pVolume->GetMotherLogical() == nullptr) return true;
+    return std::find(mBulkIce.begin(), mBulkIce.end(), pVolume->GetLogicalVolume()) != mBulkIce.end();
+}
@@ -0,0 +1,217 @@
+/** @file OMSimNextEventEstimator.cc
+ *  @brief Next-event estimator of the expected hits per PMT from photons scattered in the bulk ice.
+ *
+ *  @date October 2026
+ *
+ *  @version Geant4 10.7
+ */
+
+#include "OMSimNextEventEstimator.hh"
+#include "OMSimAcceptanceTable.hh"
+#include "OMSimModuleBounds.hh"
+#include "OMSimPhotonInfo.hh"
+
+#include "G4LogicalVolume.hh"
+#include "G4Material.hh"
+#include "G4Navigator.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4Step.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4Track.hh"
+#include "G4TransportationManager.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4VProcess.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+
+#include "OMSimLogger.hh"
+
+extern G4bool gNextEventEstimator;
+extern G4String gAcceptanceTableFile;
+extern G4String ghitsfilename;
+
+OMSimNextEventEstimator* OMSimNextEventEstimator::GetInstance()
+{
+    static G4ThreadLocal OMSimNextEventEstimator* lInstance = nullptr;
+    if (!lInstance) lInstance = new OMSimNextEventEstimator();
+    return lInstance;
+}
+
+OMSimNextEventEstimator::OMSimNextEventEstimator()
+{
+    if (!gNextEventEstimator) return;
+    OMSimAcceptanceTable* lTable = OMSimAcceptanceTable::GetInstance();
+    if (!lTable->IsLoaded() && !lTable->Load(gAcceptanceTableFile))
+    {
+        error("Next-event estimator needs an acceptance table (gAcceptanceTableFile), estimator disabled");
+        return;
+    }
+    mActive = true;
+    Reset();
+}
+
+/**
+ * Absorption and scattering lengths and the Henyey-Greenstein constants of the world material, read once.
+ */
+G4bool OMSimNextEventEstimator::LoadMaterial()
+{
+    mMaterialChecked = true;
+    G4VPhysicalVolume* lWorld = G4TransportationManager::GetTransportationManager()->GetNavigatorForTracking()->GetWorldVolume();
+    G4MaterialPropertiesTable* lMPT = lWorld->GetLogicalVolume()->GetMaterial()->GetMaterialPropertiesTable();
+    if (lMPT)
+    {
+        mAbsorptionLength = lMPT->GetProperty("ABSLENGTH");
+        mScatteringLength = lMPT->GetProperty("MIEHG");
+        if (lMPT->ConstPropertyExists("MIEHG_FORWARD")) mForwardG = lMPT->GetConstProperty("MIEHG_FORWARD");
+        if (lMPT->ConstPropertyExists("MIEHG_BACKWARD")) mBackwardG = lMPT->GetConstProperty("MIEHG_BACKWARD");
+        if (lMPT->ConstPropertyExists("MIEHG_FORWARD_RATIO")) mForwardRatio = lMPT->GetConstProperty("MIEHG_FORWARD_RATIO");
+    }
+    if (!mAbsorptionLength || !mScatteringLength)
+    {
+        error("World material has no ABSLENGTH or MIEHG, next-event estimator disabled");
+        mActive = false;
+    }
+    return mActive;
+}
+
+/**
+ * Scattering probability per unit solid angle of G4OpMieHG. The backward lobe is sampled around the old direction
+ * and then inverted, hence the -cos(theta).
+ */
+G4double OMSimNextEventEstimator::PhaseFunction(G4double pCosTheta)
+{
+    auto lHG = [](G4double g, G4double c) {
+        return (1 - g * g) / (4 * pi * std::pow(1 + g * g - 2 * g * c, 1.5));
+    };
+    return mForwardRatio * lHG(mForwardG, pCosTheta) + (1 - mForwardRatio) * lHG(mBackwardG, -pCosTheta);
+}
+
+/**
+ * Score the step of an optical photon if it ended in a Mie scattering in the bulk ice.
+ */
+void OMSimNextEventEstimator::ScoreStep(const G4Step* pStep)
+{
+    const G4StepPoint* lPost = pStep->GetPostStepPoint();
+    const G4VProcess* lProcess = lPost->GetProcessDefinedStep();
+    if (!lProcess) return;
+    if (!mMieProcess)
+    {
+        if (lProcess->GetProcessName() != "OpMieHG") return;
+        mMieProcess = lProcess;
+    }
+    if (lProcess != mMieProcess) return;
+    if (!OMSimModuleBounds::IsBulkIce(lPost->GetPhysicalVolume())) return;
+    if (!mMaterialChecked && !LoadMaterial()) return;
+    if (!OMSimAcceptanceTable::GetInstance()->IsLoaded()) return; // dropped for another geometry
+
+    G4Track* lTrack = pStep->GetTrack();
+    OMSimPhotonInfo* lInfo = (OMSimPhotonInfo*)lTrack->GetUserInformation();
+    if (!lInfo)
+    {
+        lInfo = new OMSimPhotonInfo(lTrack->GetVertexPosition());
+        lTrack->SetUserInformation(lInfo);
+    }
+    lInfo->Scattered = true;
+
+    OMSimAcceptanceTable* lTable = OMSimAcceptanceTable::GetInstance();
+    const G4double lEnergy = lTrack->GetKineticEnergy();
+    const G4double lLambda = h_Planck * c_light / lEnergy;
+    const G4double lAttenuation = 1. / mAbsorptionLength->Value(lEnergy) + 1. / mScatteringLength->Value(lEnergy);
+    const G4ThreeVector lPosition = lPost->GetPosition();
+    const G4ThreeVector lIncoming = pStep->GetPreStepPoint()->GetMomentumDirection();
+    mVertices++;
+
+    for (G4int m = 0; m < OMSimModuleBounds::GetNumberOfModules(); m++)
+    {
+        const OMSimModuleBounds::Sphere& lSphere = OMSimModuleBounds::GetModule(m);
+        const G4ThreeVector lToModule = lSphere.Center - lPosition;
+        const G4double lDistance = lToModule.mag();
+        if (lDistance <= lSphere.Radius) continue;
+        const G4ThreeVector lDirection = lToModule / lDistance;
+        const G4int lBin = lTable->FindBin(lDirection, lLambda);
+        if (lBin < 0) continue;
+
+        const G4double lSinAlpha = lSphere.Radius / lDistance;
+        const G4double lSolidAngle = twopi * (1 - std::sqrt(1 - lSinAlpha * lSinAlpha));
+        const G4double lReach = std::min(1., PhaseFunction(lIncoming.dot(lDirection)) * lSolidAngle)
+                                * std::exp(-(lDistance - lSphere.Radius) * lAttenuation) * lTrack->GetWeight();
+        for (G4int k = 0; k < lTable->GetNumberOfPMTs(); k++) mEventScore[k] += lReach * lTable->GetProbability(lBin, k);
+    }
+}
+
+/**
+ * Analog contribution of a detected photon that was never scattered in the ice.
+ */
+void OMSimNextEventEstimator::CountHit(const G4Track* pTrack, G4int pPMT)
+{
+    OMSimPhotonInfo* lInfo = (OMSimPhotonInfo*)pTrack->GetUserInformation();
+    if (lInfo && lInfo->Scattered) return;
+    if (pPMT < 0 || pPMT >= (G4int)mEventScore.size()) return;
+    mEventScore[pPMT] += pTrack->GetWeight();
+    mEventDirect[pPMT] += pTrack->GetWeight();
+}
+
+void OMSimNextEventEstimator::BeginOfEvent()
+{
+    std::fill(mEventScore.begin(), mEventScore.end(), 0);
+    std::fill(mEventDirect.begin(), mEventDirect.end(), 0);
+}
+
+void OMSimNextEventEstimator::EndOfEvent()
+{
+    G4double lEventTotal = 0;
+    for (size_t k = 0; k < mEventScore.size(); k++)
+    {
+        lEventTotal += mEventScore[k];
+        mSum[k] += mEventScore[k];
+        mSumSquares[k] += mEventScore[k] * mEventScore[k];
+        mDirect[k] += mEventDirect[k];
+    }
+    mTotalSum += lEventTotal;
+    mTotalSumSquares += lEventTotal * lEventTotal;
+    mEvents++;
+}
+
+/**
+ * Print the expected hits per PMT of the run with their statistical error and append them as one line
+ * (per PMT: expected hits, error; then total and its error) to <hits file>.nee.
+ */
+void OMSimNextEventEstimator::PrintSummary()
+{
+    if (!mActive || mEvents == 0) return;
+    G4cout << "::::::::::::Next-event estimator (" << mEvents << " events, " << mVertices << " scattering vertices):::::::::::" << G4endl;
+    G4cout << std::setw(6) << "PMT" << std::setw(16) << "expected hits" << std::setw(14) << "error" << std::setw(14) << "direct" << G4endl;
+
+    // error of the sum over all events, from the event-by-event spread
+    auto lError = [&](G4double pSum, G4double pSumSquares) {
+        if (mEvents < 2) return 0.;
+        const G4double lMean = pSum / mEvents;
+        return std::sqrt(std::max(0., (pSumSquares / mEvents - lMean * lMean) / (mEvents - 1))) * mEvents;
+    };
+
+    std::ofstream lFile((ghitsfilename + ".nee").c_str(), std::ios::out | std::ios::app);
+    for (size_t k = 0; k < mSum.size(); k++)
+    {
+        G4cout << std::setw(6) << k << std::setw(16) << mSum[k] << std::setw(14) << lError(mSum[k], mSumSquares[k]) << std::setw(14) << mDirect[k] << G4endl;
+        if (lFile.is_open()) lFile << mSum[k] << "\t" << lError(mSum[k], mSumSquares[k]) << "\t";
+    }
+    G4cout << "total: " << mTotalSum << " +- " << lError(mTotalSum, mTotalSumSquares) << G4endl;
+    if (lFile.is_open()) lFile << mTotalSum << "\t" << lError(mTotalSum, mTotalSumSquares) << std::endl;
+}
+
+void OMSimNextEventEstimator::Reset()
+{
+    const G4int lNrPMTs = OMSimAcceptanceTable::GetInstance()->GetNumberOfPMTs();
+    mEventScore.assign(lNrPMTs, 0);
+    mEventDirect.assign(lNrPMTs, 0);
+    mSum.assign(lNrPMTs, 0);
+    mSumSquares.assign(lNrPMTs, 0);
+    mDirect.assign(lNrPMTs, 0);
+    mTotalSum = 0;
+    mTotalSumSquares = 0;
+    mEvents = 0;
+    mVertices = 0;
+}
@@ -1,4 +1,5 @@
 #include "OMSimPDOM.hh"
+#include "OMSimTimeline.hh"
 
 #include "G4Ellipsoid.hh"
 #include "G4LogicalSkinSurface.hh"
@@ -11,6 +12,7 @@
 #include "G4Tubs.hh"
 
 pDOM::pDOM(OMSimInputData* pData, G4bool pPlaceHarness) {
+    OMSimScopedTimer lTimer("pDOM construction");
     mPlaceHarness = pPlaceHarness;
     mData = pData;
     mPMTManager = new OMSimPMTConstruction(mData);
@@ -80,7 +82,10 @@ void pDOM::Construction()
 
     G4PVPlacement* lGelPhysical = new G4PVPlacement(0, G4ThreeVector(0, 0, 0), lGelLogical, "pDOMGelPhys", lGlassSphereLogical, false, 0);
 
-    if (mPlaceHarness) AppendComponent(lHarnessSolid, lHarnessLogical, G4ThreeVector(0, 0, 0), G4RotationMatrix(), "pDOM_Harness");
+    if (mPlaceHarness) {
+        AppendComponent(lHarnessSolid, lHarnessLogical, G4ThreeVector(0, 0, 0), G4RotationMatrix(), "pDOM_Harness");
+        Components.back()->Levels = (1 << kFullDetail) | (1 << kSimplifiedDetail); // a single simple solid, its own proxy
+    }
     
     AppendComponent(lGlassSphereSolid, lGlassSphereLogical, G4ThreeVector(0, 0, 0), G4RotationMatrix(), "pDOM");
 
@@ -12,6 +12,7 @@
  *
  */
 
+#include <algorithm>
 #include <dirent.h>
 
 #include <G4Box.hh>
@@ -19,6 +20,8 @@
 #include <G4Ellipsoid.hh>
 #include "G4LogicalVolume.hh"
 #include "G4LogicalBorderSurface.hh"
+#include "G4LogicalSkinSurface.hh"
+#include "G4OpticalSurface.hh"
 #include <G4PVPlacement.hh>
 #include <G4Sphere.hh>
 #include <G4SubtractionSolid.hh>
@@ -30,10 +33,16 @@
 #include "G4VisAttributes.hh"
 
 #include "OMSimPMTConstruction.hh"
+#include "OMSimRevolvedSolid.hh"
+#include "OMSimSolidCheck.hh"
 #include "OMSimLogger.hh"
+#include "OMSimTimeline.hh"
 
 extern G4bool gVisual;
 extern G4int gPMT;
+extern G4bool gPMTBorderSurfaces;
+extern G4bool gAnalyticPMTBulbs;
+extern G4int gPMTBulbCheck;
 
 /**
  * Constructor of the class. The InputData instance has to be passed here in order to avoid loading the input data twice and redifining the same materials.
@@ -67,20 +76,27 @@ void OMSimPMTConstruction::PMT::ConstructIt()
     std::cerr<< "******************************************" << std::endl;
     std::cerr<< " OMSimPMTConstruction::PMT::ConstructIt is called " << std::endl;
     BasicShape();
-    mPMTlogical = new G4LogicalVolume(mPMTSolid, mData->GetMaterial("RiAbs_Glass_Tube"), "PMT tube logical");
+    mMirrorSurface = nullptr;
+    G4VSolid *lPMTSolid = mAnalyticPMTSolid ? mAnalyticPMTSolid : mPMTSolid;
+    G4VSolid *lGlassInside = mAnalyticGlassInside ? mAnalyticGlassInside : mGlassInside;
+    G4VSolid *lPhotocathodeSolid = mAnalyticPhotocathodeSolid ? mAnalyticPhotocathodeSolid : mVacuumPhotocathodeSolid;
+    mPMTlogical = new G4LogicalVolume(lPMTSolid, mData->GetMaterial("RiAbs_Glass_Tube"), "PMT tube logical");
     mPMTlogical->SetVisAttributes(mGlassVis);
 
     if (mInternalReflections)
     {
         //G4cout << "++++++++++++++Internal Reflection Activated +++++++++++++++" << G4endl;
-        G4SubtractionSolid *lVacuumTubeSolid = new G4SubtractionSolid("Vacuum Tube solid", mGlassInside, mVacuumPhotocathodeSolid, 0, G4ThreeVector(0, 0, 0));
+        G4SubtractionSolid *lVacuumTubeSolid = new G4SubtractionSolid("Vacuum Tube solid", lGlassInside, lPhotocathodeSolid, 0, G4ThreeVector(0, 0, 0));
 
-        G4LogicalVolume *lVacuumPhotocathodeLogical = new G4LogicalVolume(mVacuumPhotocathodeSolid, mData->GetMaterial("Ri_Vacuum"), "Photocathode area vacuum");
+        G4LogicalVolume *lVacuumPhotocathodeLogical = new G4LogicalVolume(lPhotocathodeSolid, mData->GetMaterial("Ri_Vacuum"), "Photocathode area vacuum");
         G4LogicalVolume *lVacuumTubeLogical = new G4LogicalVolume(lVacuumTubeSolid, mData->GetMaterial("Ri_Vacuum"), "Tube vacuum");
 
         mVacuumPhotocathodePlacement = new G4PVPlacement(0, G4ThreeVector(0, 0, 0), lVacuumPhotocathodeLogical, "Vacuum_1", mPMTlogical, false, 0, mCheckOverlaps);
         mVacuumTubePlacement = new G4PVPlacement(0, G4ThreeVector(0, 0, 0), lVacuumTubeLogical, "Vacuum_3", mPMTlogical, false, 0, mCheckOverlaps);
 
+        // the mirror and the photocathode are skins of these two siblings (see AssignSurfaces), their common boundary stays bare
+        if (!gPMTBorderSurfaces) NeutralBorder(mVacuumTubePlacement, mVacuumPhotocathodePlacement);
+
         if (mDynodeSystem)
         {
             DynodeSystemConstruction(lVacuumTubeLogical);
@@ -100,22 +116,30 @@ void OMSimPMTConstruction::PMT::ConstructIt()
         new G4PVPlacement(0, G4ThreeVector(0, 0, 0), lPhotocathode, "VacuumPhoto", lTubeVacuum, false, 0, mCheckOverlaps);
         */
         //G4cout << "++++++++++++++No Internal Reflection Activated +++++++++++++++" << G4endl;
-        G4SubtractionSolid *lVacuumTubeSolid_BackBulb = new G4SubtractionSolid("Vacuum Tube solid", mGlassInside, mVacuumPhotocathodeSolid, 0, G4ThreeVector(0, 0, 0));
-        G4SubtractionSolid *lVacuumTubeSolid = new G4SubtractionSolid("Vacuum Tube solid", mBulkSolid, mVacuumPhotocathodeSolid, 0, G4ThreeVector(0, 0, mMissingTubeLength));
+        G4SubtractionSolid *lVacuumTubeSolid_BackBulb = new G4SubtractionSolid("Vacuum Tube solid", lGlassInside, lPhotocathodeSolid, 0, G4ThreeVector(0, 0, 0));
+        G4SubtractionSolid *lVacuumTubeSolid = new G4SubtractionSolid("Vacuum Tube solid", mBulkSolid, lPhotocathodeSolid, 0, G4ThreeVector(0, 0, mMissingTubeLength));
         G4SubtractionSolid *lBackBulbSolid = new G4SubtractionSolid("Vacuum Tube solid", lVacuumTubeSolid_BackBulb, lVacuumTubeSolid, 0, G4ThreeVector(0, 0, -mMissingTubeLength));
 
-        G4LogicalVolume *lVacuumPhotocathodeLogical = new G4LogicalVolume(mVacuumPhotocathodeSolid, mData->GetMaterial("RiAbs_Photocathode"), "Photocathode area vacuum");
+        G4LogicalVolume *lVacuumPhotocathodeLogical = new G4LogicalVolume(lPhotocathodeSolid, mData->GetMaterial("RiAbs_Photocathode"), "Photocathode area vacuum");
 
         //G4cout << "++++++++++++++Sensitive Guy++++++++++ " << lVacuumPhotocathodeLogical -> GetMaterial() -> GetName() << " " << G4endl;
         G4LogicalVolume *lVacuumTubeLogical = new G4LogicalVolume(lVacuumTubeSolid, mData->GetMaterial("NoOptic_Absorber"), "Fully absorber"); //I guess this is not trully fully absorber though...
         G4LogicalVolume *lBackBulbLogical = new G4LogicalVolume(lBackBulbSolid, mData->GetMaterial("RiAbs_Glass_Tube"), "Reflective mirror");
 
         mVacuumPhotocathodePlacement = new G4PVPlacement(0, G4ThreeVector(0, 0, 0), lVacuumPhotocathodeLogical, "Photocathode_pv_OMSIM", mPMTlogical, false, 0, mCheckOverlaps);
-        mVacuumTubePlacement = new G4PVPlacement(0, G4ThreeVector(0, 0, -mMissingTubeLength), lVacuumTubeLogical, "BackTube", mPMTlogical, false, 0, mCheckOverlaps);
+        G4PVPlacement *lBackTubePlacement = new G4PVPlacement(0, G4ThreeVector(0, 0, -mMissingTubeLength), lVacuumTubeLogical, "BackTube", mPMTlogical, false, 0, mCheckOverlaps);
 
         mVacuumTubePlacement = new G4PVPlacement(0, G4ThreeVector(0, 0, 0), lBackBulbLogical, "BackBulb", mPMTlogical, false, 0, mCheckOverlaps);
 
-        CathodeBackShield(lBackBulbLogical);
+        G4PVPlacement *lShieldPlacement = CathodeBackShield(lBackBulbLogical);
+
+        // the mirror is a skin of the back bulb (see AssignSurfaces), its other boundaries keep the bare interface
+        if (!gPMTBorderSurfaces)
+        {
+            NeutralBorder(mVacuumTubePlacement, mVacuumPhotocathodePlacement);
+            NeutralBorder(mVacuumTubePlacement, lBackTubePlacement);
+            NeutralBorder(mVacuumTubePlacement, lShieldPlacement);
+        }
 
         //lVacuumPhotocathodeLogical->SetVisAttributes(mPhotocathodeVis);
         //lVacuumPhotocathodeLogical->SetVisAttributes(mInvisibleVis);
@@ -130,7 +154,8 @@ void OMSimPMTConstruction::PMT::ConstructIt()
 }
 
 /**
- * Placement of the PMT and definition of LogicalBorderSurfaces in case internal reflections are needed.
+ * Placement of the PMT and assignment of its optical surfaces.
+ * @see AssignSurfaces
  * @param pPosition G4ThreeVector with position of the module (as in G4PVPlacement())
  * @param pRotation G4RotationMatrix with rotation of the module (as in G4PVPlacement())
  * @param pMother G4LogicalVolume where the module is going to be placed (as in G4PVPlacement())
@@ -139,17 +164,7 @@ void OMSimPMTConstruction::PMT::ConstructIt()
 void OMSimPMTConstruction::PMT::PlaceIt(G4ThreeVector pPosition, G4RotationMatrix *pRotation, G4LogicalVolume *&pMother, G4String pNameExtension)
 {
     G4PVPlacement *lPMTPhysical = new G4PVPlacement(pRotation, pPosition, mPMTlogical, "PMT_" + pNameExtension, pMother, false, 0, mCheckOverlaps);
-    if (mInternalReflections)
-    {
-        G4OpticalSurface *Photocathode_opsurf = new G4OpticalSurface("Photocathode_opsurf");
-        new G4LogicalBorderSurface("Photocathode_out", mVacuumPhotocathodePlacement, lPMTPhysical, Photocathode_opsurf);
-        new G4LogicalBorderSurface("Photocathode_in", lPMTPhysical, mVacuumPhotocathodePlacement, Photocathode_opsurf);                  //*/
-        new G4LogicalBorderSurface("PMT_mirrorglass", mVacuumTubePlacement, lPMTPhysical, mData->GetOpticalSurface("Refl_100polished")); //*/
-        new G4LogicalBorderSurface("PMT_mirrorglass", lPMTPhysical, mVacuumTubePlacement, mData->GetOpticalSurface("Refl_100polished")); //*/
-    } else {
-        new G4LogicalBorderSurface("PMT_mirrorglass", mVacuumTubePlacement, lPMTPhysical, mData->GetOpticalSurface("Refl_100polished")); //*/
-        new G4LogicalBorderSurface("PMT_mirrorglass", lPMTPhysical, mVacuumTubePlacement, mData->GetOpticalSurface("Refl_100polished")); //*/
-    }
+    AssignSurfaces(lPMTPhysical, "Refl_100polished");
 }
 /**
  * @see PMT::PlaceIt
@@ -158,20 +173,62 @@ void OMSimPMTConstruction::PMT::PlaceIt(G4ThreeVector pPosition, G4RotationMatri
 void OMSimPMTConstruction::PMT::PlaceIt(G4Transform3D pTransform, G4LogicalVolume *&pMother, G4String pNameExtension)
 {
     G4PVPlacement *lPMTPhysical = new G4PVPlacement(pTransform, mPMTlogical, "PMT_" + pNameExtension, pMother, false, 0, mCheckOverlaps);
+    AssignSurfaces(lPMTPhysical, mInternalReflections ? "Refl_100polished" : "Refl_PMTSideMirror");
+}
 
-    if (mInternalReflections)
+/**
+ * Optical surfaces between a placed PMT and its inner volumes (mirrored back of the bulb, photocathode with internal
+ * reflections). The inner volumes are shared by all placements of the PMT, so the surfaces are skin surfaces of their
+ * logical volumes, created at the first placement: the number of surfaces does not grow with the number of PMTs and
+ * modules. Boundaries of the skinned volumes that had no border surface get a bare dielectric surface (NeutralBorder),
+ * which behaves as no surface at all, so the optics are the same as with border surfaces. A placement asking for
+ * another mirror than the first one gets its own border surfaces, which take precedence over the skin.
+ * With gPMTBorderSurfaces, border surfaces are created for every placement (former behaviour, for comparisons).
+ * @param pPMTPhysical Placement of the PMT glass
+ * @param pMirror Name of the optical surface of the mirrored back of the bulb
+ */
+void OMSimPMTConstruction::PMT::AssignSurfaces(G4PVPlacement *pPMTPhysical, G4String pMirror)
+{
+    G4OpticalSurface *lMirror = mData->GetOpticalSurface(pMirror);
+    if (gPMTBorderSurfaces)
     {
-        G4OpticalSurface *Photocathode_opsurf = new G4OpticalSurface("Photocathode_opsurf");
-        new G4LogicalBorderSurface("Photocathode_out", mVacuumPhotocathodePlacement, lPMTPhysical, Photocathode_opsurf);
-        new G4LogicalBorderSurface("Photocathode_in", lPMTPhysical, mVacuumPhotocathodePlacement, Photocathode_opsurf);                  //*/
-        new G4LogicalBorderSurface("PMT_mirrorglass", mVacuumTubePlacement, lPMTPhysical, mData->GetOpticalSurface("Refl_100polished")); //*/
-        new G4LogicalBorderSurface("PMT_mirrorglass", lPMTPhysical, mVacuumTubePlacement, mData->GetOpticalSurface("Refl_100polished")); //*/
-    } else {
-        new G4LogicalBorderSurface("PMT_mirrorglass", mVacuumTubePlacement, lPMTPhysical, mData->GetOpticalSurface("Refl_PMTSideMirror")); //*/
-        new G4LogicalBorderSurface("PMT_mirrorglass", lPMTPhysical, mVacuumTubePlacement, mData->GetOpticalSurface("Refl_PMTSideMirror")); //*/
+        if (mInternalReflections)
+        {
+            G4OpticalSurface *Photocathode_opsurf = new G4OpticalSurface("Photocathode_opsurf");
+            new G4LogicalBorderSurface("Photocathode_out", mVacuumPhotocathodePlacement, pPMTPhysical, Photocathode_opsurf);
+            new G4LogicalBorderSurface("Photocathode_in", pPMTPhysical, mVacuumPhotocathodePlacement, Photocathode_opsurf);
+        }
+        new G4LogicalBorderSurface("PMT_mirrorglass", mVacuumTubePlacement, pPMTPhysical, lMirror);
+        new G4LogicalBorderSurface("PMT_mirrorglass", pPMTPhysical, mVacuumTubePlacement, lMirror);
+        return;
+    }
+    if (!mMirrorSurface)
+    {
+        mMirrorSurface = lMirror;
+        new G4LogicalSkinSurface("PMT_mirrorglass", mVacuumTubePlacement->GetLogicalVolume(), lMirror);
+        if (mInternalReflections)
+        {
+            new G4LogicalSkinSurface("Photocathode_skin", mVacuumPhotocathodePlacement->GetLogicalVolume(), new G4OpticalSurface("Photocathode_opsurf"));
+        }
+    }
+    else if (lMirror != mMirrorSurface)
+    {
+        new G4LogicalBorderSurface("PMT_mirrorglass", mVacuumTubePlacement, pPMTPhysical, lMirror);
+        new G4LogicalBorderSurface("PMT_mirrorglass", pPMTPhysical, mVacuumTubePlacement, lMirror);
     }
 }
 
+/**
+ * Bare dielectric border surface in both directions between two volumes, so that the skin surface of one of them is
+ * not applied to their common boundary.
+ */
+void OMSimPMTConstruction::PMT::NeutralBorder(G4VPhysicalVolume *pVolume1, G4VPhysicalVolume *pVolume2)
+{
+    if (!mNeutralSurface) mNeutralSurface = new G4OpticalSurface("PMT_bare", glisur, polished, dielectric_dielectric);
+    new G4LogicalBorderSurface("PMT_bare", pVolume1, pVolume2, mNeutralSurface);
+    new G4LogicalBorderSurface("PMT_bare", pVolume2, pVolume1, mNeutralSurface);
+}
+
 /**
  * The basic shape of the PMT is constructed twice, once for the external solid and once for the internal. A subtraction of these two shapes would yield the glass envelope of the PMT. The function calls either BulbConstructionSimple or BulbConstructionFull, depending on the data provided and simulation type. In case only the frontal curvate of the photocathode has to be well constructed, it calls BulbConstructionSimple. BulbConstructionFull constructs the neck of the PMT precisely, but it needs to have the fit data of the PMT type and is only needed if internal reflections are simulated.
  * @see BulbConstructionSimple
@@ -181,6 +238,7 @@ void OMSimPMTConstruction::PMT::BasicShape()
 {
     std::cerr << "OMSimPMTConstruction::PMT::BasicShape is called" << std::endl;
     G4SubtractionSolid *lVacuumPhotocathodeSolid;
+    mAnalyticPMTSolid = mAnalyticGlassInside = mAnalyticPhotocathodeSolid = nullptr;
 
     G4String lBulbBackShape = mData->GetString(mSelectedPMT,"jBulbBackShape");
     if (lBulbBackShape == "Simple")
@@ -191,6 +249,26 @@ void OMSimPMTConstruction::PMT::BasicShape()
         std::cerr << "simple bulb or not internal reflection " << std::endl;
         std::tie(mPMTSolid, lVacuumPhotocathodeSolid) = BulbConstructionSimple("jOuterShape");
         std::tie(mGlassInside, mVacuumPhotocathodeSolid) = BulbConstructionSimple("jInnerShape");
+        if (gAnalyticPMTBulbs)
+        {
+            OMSimRevolvedSolid *lAnalyticPMTSolid, *lAnalyticGlassInside, *lAnalyticPhotocathodeSolid;
+            std::tie(lAnalyticPMTSolid, std::ignore) = AnalyticBulbConstruction("jOuterShape", mPMTSolid, nullptr);
+            std::tie(lAnalyticGlassInside, lAnalyticPhotocathodeSolid) = AnalyticBulbConstruction("jInnerShape", mGlassInside, mVacuumPhotocathodeSolid);
+            if (lAnalyticPMTSolid && lAnalyticGlassInside)
+            {
+                mAnalyticPMTSolid = lAnalyticPMTSolid;
+                mAnalyticGlassInside = lAnalyticGlassInside;
+                mAnalyticPhotocathodeSolid = lAnalyticPhotocathodeSolid;
+                if (gPMTBulbCheck > 0)
+                {
+                    OMSimSolidCheck::CompareAndPrint(mPMTSolid, mAnalyticPMTSolid, gPMTBulbCheck, "Analytic bulb of " + mSelectedPMT);
+                    OMSimSolidCheck::CompareAndPrint(mGlassInside, mAnalyticGlassInside, gPMTBulbCheck, "Analytic inner bulb of " + mSelectedPMT);
+                    OMSimSolidCheck::CompareAndPrint(mVacuumPhotocathodeSolid, mAnalyticPhotocathodeSolid, gPMTBulbCheck, "Analytic photocathode volume of " + mSelectedPMT);
+                }
+            }
+            else
+                warning("The bulb of %s cannot be described by OMSimRevolvedSolid, the boolean solids are used", mSelectedPMT.c_str());
+        }
     }
     else
     {
@@ -229,6 +307,36 @@ std::tuple<G4UnionSolid *, G4SubtractionSolid *> OMSimPMTConstruction::PMT::Bulb
     return std::make_tuple(lBulbSolid, lPhotocathodeSide);
 }
 
+/**
+ * Analytic counterpart of BulbConstructionSimple, from the same parameters (see OMSimRevolvedSolid).
+ * The photocathode volume part is the frontal bulb above z = 0, which is what the subtraction of the large tube leaves
+ * as long as the sphere ends within the radius of the ellipse.
+ * @param pBulb Boolean solid of the bulb, used by the analytic solid for the visualisation
+ * @param pPhotocathode Boolean solid of the photocathode volume part, nullptr if it is not needed
+ * @return tuple of the outer shape and the photocathode volume part, nullptr if the bulb cannot be described analytically
+ */
+std::tuple<OMSimRevolvedSolid *, OMSimRevolvedSolid *> OMSimPMTConstruction::PMT::AnalyticBulbConstruction(G4String pSide, G4VSolid *pBulb, G4VSolid *pPhotocathode)
+{
+    ReadParameters(pSide);
+    OMSimRevolvedSolid *lBulbSolid = new OMSimRevolvedSolid("Analytic bulb solid", pBulb);
+    OMSimRevolvedSolid *lPhotocathodeSide = pPhotocathode ? new OMSimRevolvedSolid("Analytic photocathode side", pPhotocathode) : nullptr;
+    G4bool lValid = FrontalBulbPieces(lBulbSolid, -kInfinity) && mSphereEllipseTransition_r <= mEllipseXYaxis;
+    if (lPhotocathodeSide)
+        lValid = lValid && FrontalBulbPieces(lPhotocathodeSide, 0);
+    if (!lValid)
+    {
+        delete lBulbSolid;
+        delete lPhotocathodeSide;
+        return std::make_tuple(nullptr, nullptr);
+    }
+
+    // Rest of tube
+    G4double lFrontToEllipse_y = mOutRad + mSpherePos_y - mEllipsePos_y;
+    G4double lMissingTubeLength = (mTotalLenght - lFrontToEllipse_y) * 0.5 * mm;
+    lBulbSolid->AddCylinder(0.5 * mTubeWidth, -2 * lMissingTubeLength, 0);
+    return std::make_tuple(lBulbSolid, lPhotocathodeSide);
+}
+
 /**
  * Construction of the basic shape of the PMT for a full paramterised PMT. This is needed if internal reflections are simulated.
  * @return tuple of G4UnionSolid (the outer shape) and G4SubtractionSolid (the photocathode volume part)
@@ -292,8 +400,9 @@ std::tuple<G4UnionSolid *, G4SubtractionSolid *> OMSimPMTConstruction::PMT::Bulb
 
 /**
  * Creates and positions a thin disk behind the photocathode volume in order to shield photons coming from behind the PMT. Only used when internal reflections are turned off.
+ * @return Placement of the disk
  */
-void OMSimPMTConstruction::PMT::CathodeBackShield(G4LogicalVolume *pPMTinner)
+G4PVPlacement *OMSimPMTConstruction::PMT::CathodeBackShield(G4LogicalVolume *pPMTinner)
 {
     ReadParameters("jInnerShape");
     G4double lPCDiameter = 2 * mEllipseXYaxis;
@@ -301,8 +410,9 @@ void OMSimPMTConstruction::PMT::CathodeBackShield(G4LogicalVolume *pPMTinner)
     G4double lShieldRad = -0.01 * mm + mEllipseXYaxis / mEllipseZaxis * std::sqrt(std::pow(mEllipseZaxis, 2.) - std::pow(0.5 * lShieldBottomcut, 2.));
     G4Tubs *lShieldSolid = new G4Tubs("Shield solid", 0, lShieldRad, 0.1 * mm, 0, 2 * CLHEP::pi);
     G4LogicalVolume *lShieldLogical = new G4LogicalVolume(lShieldSolid, mData->GetMaterial("NoOptic_Absorber"), "Shield logical");
-    new G4PVPlacement(0, G4ThreeVector(0, 0, -0.1 * mm), lShieldLogical, "Shield physical", pPMTinner, false, 0, mCheckOverlaps);
+    G4PVPlacement *lShieldPhysical = new G4PVPlacement(0, G4ThreeVector(0, 0, -0.1 * mm), lShieldLogical, "Shield physical", pPMTinner, false, 0, mCheckOverlaps);
     lShieldLogical->SetVisAttributes(mSteelVis);
+    return lShieldPhysical;
 }
 
 /**
@@ -369,6 +479,11 @@ void OMSimPMTConstruction::PMT::DynodeSystemConstruction(G4LogicalVolume *pMothe
     new G4LogicalBorderSurface("PMT_platemirror", lDynodePlatePhysical, mVacuumTubePlacement, mData->GetOpticalSurface("Refl_100polished"));
     new G4LogicalBorderSurface("PMT_1dynmirror", mVacuumTubePlacement, lDynodeSystemPhysical, mData->GetOpticalSurface("Refl_100polished"));
     new G4LogicalBorderSurface("PMT_1dynmirror", lDynodeSystemPhysical, mVacuumTubePlacement, mData->GetOpticalSurface("Refl_100polished"));
+    if (!gPMTBorderSurfaces)
+    {
+        NeutralBorder(mVacuumTubePlacement, lAbsorberPhys);
+        NeutralBorder(mVacuumTubePlacement, lBackGlassPhys);
+    }
 }
 
 /**
@@ -431,6 +546,19 @@ G4UnionSolid *OMSimPMTConstruction::SphereEllipsePhotocathode::FrontalBulbConstr
     return lBulbSolid;
 }
 
+/**
+ * Pieces of the frontal part for OMSimRevolvedSolid, same shape as FrontalBulbConstruction.
+ * @param pZMin Pieces are cut below this height
+ * @return true (the shape can always be described)
+ */
+G4bool OMSimPMTConstruction::SphereEllipsePhotocathode::FrontalBulbPieces(OMSimRevolvedSolid *pSolid, G4double pZMin)
+{
+    G4double lSphereAngle = asin(mSphereEllipseTransition_r / mOutRad);
+    pSolid->AddEllipsoid(mEllipseXYaxis, mEllipseZaxis, 0, pZMin);
+    pSolid->AddSphereSector(mOutRad, mSpherePos_y - mEllipsePos_y, lSphereAngle, pZMin);
+    return true;
+}
+
 /**
  * Construction of the frontal part of the PMT following the fits of the technical drawings. PMTs constructed with SphereDoubleEllipsePhotocathode were fitted with a sphere and two ellipses.
  * @return G4UnionSolid lBulbSolid the frontal solid of the PMT
@@ -450,6 +578,24 @@ G4UnionSolid *OMSimPMTConstruction::SphereDoubleEllipsePhotocathode::FrontalBulb
     return lBulbSolid;
 }
 
+/**
+ * Pieces of the frontal part for OMSimRevolvedSolid, same shape as FrontalBulbConstruction. The large ellipsoid keeps
+ * only its part above the centre of the first one, as after the subtraction of the tube.
+ * @param pZMin Pieces are cut below this height
+ * @return false if the large ellipsoid reaches below the subtraction tube (not described)
+ */
+G4bool OMSimPMTConstruction::SphereDoubleEllipsePhotocathode::FrontalBulbPieces(OMSimRevolvedSolid *pSolid, G4double pZMin)
+{
+    G4double lSphereAngle = asin(mSphereEllipseTransition_r / mOutRad);
+    G4double lLargeEllipsoidPos = mEllipsePos_y_2 - mEllipsePos_y;
+    if (lLargeEllipsoidPos - mEllipseZaxis_2 < -mTotalLenght)
+        return false;
+    pSolid->AddEllipsoid(mEllipseXYaxis, mEllipseZaxis, 0, pZMin);
+    pSolid->AddSphereSector(mOutRad, mSpherePos_y - mEllipsePos_y, lSphereAngle, pZMin);
+    pSolid->AddEllipsoid(mEllipseXYaxis_2, mEllipseZaxis_2, lLargeEllipsoidPos, std::max(pZMin, 0.));
+    return true;
+}
+
 /*
  * %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
  *                                Main class methods
@@ -511,12 +657,13 @@ void OMSimPMTConstruction::SelectPMT(G4String pPMTtoSelect)
         pPMTtoSelect = lPMTTypes[gPMT];
     }
     mSelectedPMT = pPMTtoSelect;
+    OMSimScopedTimer lTimer("PMT construction " + mSelectedPMT);
 
     //Check if requested PMT is in the table of PMTs
     if (mData->CheckIfKeyInTable(pPMTtoSelect))
     {//if found
         G4String mssg = pPMTtoSelect + " selected.";
-        notice(mssg);
+        notice("%s", mssg.c_str());
 
         const G4String lFrontalShape = mData->GetString(mSelectedPMT, "jFrontalShape");
 
@@ -539,6 +686,7 @@ void OMSimPMTConstruction::SelectPMT(G4String pPMTtoSelect)
  */
 void OMSimPMTConstruction::SimulateInternalReflections()
 {
+    OMSimScopedTimer lTimer("PMT construction with internal reflections " + mSelectedPMT);
     mPMT->mInternalReflections = true;
     if (mSelectedPMT == "pmt_Hamamatsu_R15458")
         mPMT->mDynodeSystem = true;
@@ -0,0 +1,218 @@
+/** @file OMSimPhotonCache.cc
+ *  @brief Binary cache of the photons crossing a sphere around the module, for two-stage simulations.
+ *
+ *  @date October 2026
+ *
+ *  @version Geant4 10.7
+ */
+
+#include "OMSimPhotonCache.hh"
+#include "OMSimPhotonInfo.hh"
+#include "OMSimModuleBounds.hh"
+
+#include "G4PhysicalConstants.hh"
+#include "G4Step.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4Track.hh"
+
+#include <cmath>
+#include <cstring>
+
+#include "OMSimLogger.hh"
+
+static_assert(sizeof(OMSimPhotonCache::Record) == 72, "photon cache records must not contain padding");
+
+namespace
+{
+    const char gCacheMagic[8] = {'O', 'M', 'S', 'I', 'M', 'P', 'C', '2'};
+    const char gLegacyCacheMagic[8] = {'O', 'M', 'S', 'I', 'M', 'P', 'C', '1'};
+    const std::streamoff gHeaderSize = 8 + 4 * sizeof(G4double);
+}
+
+/**
+ * @return true for the magic of a cache of the first version (integer weight, always 1)
+ */
+G4bool OMSimPhotonCache::IsLegacy(const char* pMagic)
+{
+    return std::memcmp(pMagic, gLegacyCacheMagic, 8) == 0;
+}
+
+OMSimPhotonCache* OMSimPhotonCache::GetInstance()
+{
+    static G4ThreadLocal OMSimPhotonCache* lInstance = nullptr;
+    if (!lInstance) lInstance = new OMSimPhotonCache();
+    return lInstance;
+}
+
+/**
+ * Open the cache for appending. A new file gets a header, an existing one continues its event numbering.
+ * @param pRadius Radius of the cache sphere
+ * @param pCenter Center of the cache sphere (module position)
+ */
+void OMSimPhotonCache::OpenForWriting(G4String pFileName, G4double pRadius, G4ThreeVector pCenter)
+{
+    if (mOutput.is_open()) return;
+    mRadius = pRadius;
+    mCenter = pCenter;
+
+    std::ifstream lExisting(pFileName.c_str(), std::ios::binary | std::ios::ate);
+    const std::streamoff lSize = lExisting.is_open() ? (std::streamoff)lExisting.tellg() : 0;
+    if (lSize >= gHeaderSize)
+    {
+        char lMagic[8];
+        lExisting.read(lMagic, 8);
+        if (IsLegacy(lMagic))
+        {
+            error("Photon cache %s has the format of the first version, photons are not appended to it", pFileName.c_str());
+            return;
+        }
+        G4double lHeader[4];
+        lExisting.seekg(8);
+        lExisting.read((char*)lHeader, sizeof(lHeader));
+        if (std::fabs(lHeader[0] * mm - pRadius) > 1 * um) warning("Appending to photon cache %s with a different radius", pFileName.c_str());
+        if (lSize >= gHeaderSize + (std::streamoff)sizeof(Record))
+        {
+            Record lLast;
+            lExisting.seekg(gHeaderSize + ((lSize - gHeaderSize) / sizeof(Record) - 1) * sizeof(Record));
+            lExisting.read((char*)&lLast, sizeof(Record));
+            mEventID = lLast.EventID;
+        }
+    }
+    lExisting.close();
+
+    mOutput.open(pFileName.c_str(), std::ios::binary | std::ios::app);
+    if (!mOutput.is_open())
+    {
+        error("Could not open photon cache %s", pFileName.c_str());
+        return;
+    }
+    if (lSize < gHeaderSize)
+    {
+        const G4double lHeader[4] = {pRadius / mm, pCenter.x() / mm, pCenter.y() / mm, pCenter.z() / mm};
+        mOutput.write(gCacheMagic, 8);
+        mOutput.write((const char*)lHeader, sizeof(lHeader));
+    }
+    info("Recording photons entering a sphere of %f m to %s", pRadius / m, pFileName.c_str());
+}
+
+/**
+ * Write the photon of this step if the step enters the cache sphere. Every crossing is recorded, also of photons that
+ * pass the sphere without stopping on the stage-one module (a larger or another module may catch them in the replay),
+ * but only the first one of each photon: the replay tracks the photon on from there, including later crossings.
+ * Photons created inside the sphere never enter it, they are written at their creation point on their first step.
+ * @return true if the step ends inside the sphere (the photon has to be killed, the replay continues it)
+ */
+G4bool OMSimPhotonCache::RecordCrossing(const G4Step* pStep)
+{
+    G4Track* lTrack = pStep->GetTrack();
+    const G4StepPoint* lPre = pStep->GetPreStepPoint();
+    OMSimPhotonInfo* lInfo = (OMSimPhotonInfo*)lTrack->GetUserInformation();
+    const G4bool lCached = lInfo && lInfo->Cached;
+    if (lTrack->GetCurrentStepNumber() == 1 && (lPre->GetPosition() - mCenter).mag2() <= mRadius * mRadius)
+    {
+        if (!lCached) Write(lTrack, lPre, lPre->GetPosition() - mCenter, lPre->GetGlobalTime());
+        return true;
+    }
+
+    G4ThreeVector lCrossing;
+    G4double lFraction;
+    if (!OMSimModuleBounds::StepEntersSphere(pStep, mCenter, mRadius, lCrossing, lFraction)) return false;
+    const G4bool lEndsInside = (pStep->GetPostStepPoint()->GetPosition() - mCenter).mag2() <= mRadius * mRadius;
+    if (lCached) return lEndsInside;
+    Write(lTrack, lPre, lCrossing - mCenter, lPre->GetGlobalTime() + lFraction * (pStep->GetPostStepPoint()->GetGlobalTime() - lPre->GetGlobalTime()));
+    return lEndsInside;
+}
+
+/**
+ * Write one record and mark the photon as cached.
+ * @param pPoint Step point with the direction, polarisation and energy of the photon
+ * @param pPosition Position relative to the center of the sphere
+ * @param pTime Global time at pPosition
+ */
+void OMSimPhotonCache::Write(G4Track* pTrack, const G4StepPoint* pPoint, G4ThreeVector pPosition, G4double pTime)
+{
+    const G4ThreeVector lDirection = pPoint->GetMomentumDirection();
+    const G4ThreeVector lPolarization = pPoint->GetPolarization();
+    const G4ThreeVector lVertex = OMSimPhotonInfo::GetOriginalVertex(pTrack) - mCenter;
+
+    const Record lRecord = {pTime / ns,
+                            {(G4float)(pPosition.x() / mm), (G4float)(pPosition.y() / mm), (G4float)(pPosition.z() / mm)},
+                            {(G4float)lDirection.x(), (G4float)lDirection.y(), (G4float)lDirection.z()},
+                            {(G4float)lPolarization.x(), (G4float)lPolarization.y(), (G4float)lPolarization.z()},
+                            {(G4float)(lVertex.x() / mm), (G4float)(lVertex.y() / mm), (G4float)(lVertex.z() / mm)},
+                            (G4float)(h_Planck * c_light / pPoint->GetKineticEnergy() / nm),
+                            mEventID,
+                            OMSimPhotonInfo::GetAncestorID(pTrack),
+                            (G4float)pTrack->GetWeight()};
+    mOutput.write((const char*)&lRecord, sizeof(Record));
+    mRecorded++;
+
+    OMSimPhotonInfo* lInfo = (OMSimPhotonInfo*)pTrack->GetUserInformation();
+    if (!lInfo)
+    {
+        lInfo = new OMSimPhotonInfo(pTrack->GetVertexPosition());
+        pTrack->SetUserInformation(lInfo);
+    }
+    lInfo->Cached = true;
+}
+
+void OMSimPhotonCache::Close()
+{
+    if (mOutput.is_open())
+    {
+        mOutput.close();
+        info("%ld photons written to the photon cache", mRecorded);
+        mRecorded = 0;
+    }
+    if (mInput.is_open()) mInput.close();
+}
+
+/**
+ * Open a cache for replay and read its header.
+ */
+G4bool OMSimPhotonCache::OpenForReading(G4String pFileName)
+{
+    mInput.open(pFileName.c_str(), std::ios::binary);
+    char lMagic[8];
+    G4double lHeader[4];
+    if (!mInput.is_open() || !mInput.read(lMagic, 8) || (std::memcmp(lMagic, gCacheMagic, 8) != 0 && !IsLegacy(lMagic))
+        || !mInput.read((char*)lHeader, sizeof(lHeader)))
+    {
+        error("Could not read photon cache %s", pFileName.c_str());
+        mInput.close();
+        return false;
+    }
+    mRadius = lHeader[0] * mm;
+    mCenter = G4ThreeVector(lHeader[1], lHeader[2], lHeader[3]) * mm;
+    mHavePending = false;
+    mLegacy = IsLegacy(lMagic);
+    info("Replaying photon cache %s (sphere of %f m)", pFileName.c_str(), mRadius / m);
+    return true;
+}
+
+/**
+ * Read the photons of the next recorded event.
+ * @return false at the end of the file
+ */
+G4bool OMSimPhotonCache::ReadEvent(std::vector<Record>& pRecords)
+{
+    pRecords.clear();
+    if (!mInput.is_open()) return false;
+    if (!mHavePending && !mInput.read((char*)&mPending, sizeof(Record))) return false;
+    mHavePending = false;
+    pRecords.push_back(mPending);
+    Record lRecord;
+    while (mInput.read((char*)&lRecord, sizeof(Record)))
+    {
+        if (lRecord.EventID != pRecords.front().EventID)
+        {
+            mPending = lRecord;
+            mHavePending = true;
+            break;
+        }
+        pRecords.push_back(lRecord);
+    }
+    if (mLegacy)
+        for (Record& lRecord : pRecords) lRecord.Weight = 1;
+    return true;
+}
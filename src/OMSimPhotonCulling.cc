@@ -0,0 +1,137 @@
+/** @file OMSimPhotonCulling.cc
+ *  @brief Kills optical photons that are too far from every module to be detected.
+ *
+ *  @date October 2026
+ *
+ *  @version Geant4 10.7
+ */
+
+#include "OMSimPhotonCulling.hh"
+#include "OMSimModuleBounds.hh"
+
+#include "G4LogicalVolume.hh"
+#include "G4Material.hh"
+#include "G4Navigator.hh"
+#include "G4OpticalPhoton.hh"
+#include "G4Step.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4Track.hh"
+#include "G4TransportationManager.hh"
+#include "G4VPhysicalVolume.hh"
+
+#include <cmath>
+
+#include "OMSimLogger.hh"
+
+extern G4double gCullingK;
+extern G4bool gCullingValidation;
+
+OMSimPhotonCulling* OMSimPhotonCulling::GetInstance()
+{
+    static G4ThreadLocal OMSimPhotonCulling* lInstance = nullptr;
+    if (!lInstance) lInstance = new OMSimPhotonCulling();
+    return lInstance;
+}
+
+OMSimPhotonCulling::OMSimPhotonCulling()
+{
+    mK = gCullingK;
+    mValidation = gCullingValidation;
+}
+
+/**
+ * @param pPosition Position of the photon
+ * @param pEnergy Energy of the photon
+ * @return true if the photon is more than k absorption lengths away from every module bounding sphere
+ */
+G4bool OMSimPhotonCulling::BeyondHorizon(const G4ThreeVector& pPosition, G4double pEnergy)
+{
+    if (!mMaterialChecked)
+    {
+        mMaterialChecked = true;
+        G4VPhysicalVolume* lWorld = G4TransportationManager::GetTransportationManager()->GetNavigatorForTracking()->GetWorldVolume();
+        G4MaterialPropertiesTable* lMPT = lWorld->GetLogicalVolume()->GetMaterial()->GetMaterialPropertiesTable();
+        if (lMPT) mAbsorptionLength = lMPT->GetProperty("ABSLENGTH");
+        if (!mAbsorptionLength) warning("World material has no ABSLENGTH, photon culling is disabled");
+    }
+    if (!mAbsorptionLength) return false;
+
+    const G4double lDistance = OMSimModuleBounds::DistanceToNearest(pPosition);
+    if (lDistance <= 0) return false;
+    return lDistance > mK * mAbsorptionLength->Value(pEnergy);
+}
+
+/**
+ * Kill (or in validation mode flag) a photon beyond the horizon.
+ * @return true if the track has to be killed
+ */
+G4bool OMSimPhotonCulling::Cull(const G4Track* pTrack, G4long& pCounter)
+{
+    if (!BeyondHorizon(pTrack->GetPosition(), pTrack->GetKineticEnergy())) return false;
+    if (mValidation)
+    {
+        if (mFlagged.insert(pTrack->GetTrackID()).second) pCounter++;
+        return false;
+    }
+    pCounter++;
+    return true;
+}
+
+/**
+ * Called by the stacking action for every new track.
+ * @return true if the photon should not be tracked at all
+ */
+G4bool OMSimPhotonCulling::CullAtCreation(const G4Track* pTrack)
+{
+    if (pTrack->GetDefinition() != G4OpticalPhoton::Definition()) return false;
+    mStacked++;
+    return Cull(pTrack, mCulledAtCreation);
+}
+
+/**
+ * Called by the stepping action. Only steps ending in the bulk ice (world volume or registered ice volumes) are checked, inside the bounding spheres
+ * the distance is negative anyway.
+ * @return true if the photon should be killed
+ */
+G4bool OMSimPhotonCulling::CullAfterStep(const G4Step* pStep)
+{
+    G4VPhysicalVolume* lVolume = pStep->GetPostStepPoint()->GetPhysicalVolume();
+    if (!OMSimModuleBounds::IsBulkIce(lVolume)) return false;
+    return Cull(pStep->GetTrack(), mCulledInFlight);
+}
+
+/**
+ * Register a detected photon. In validation mode hits of flagged photons are counted separately.
+ */
+void OMSimPhotonCulling::CountHit(const G4Track* pTrack)
+{
+    mHits++;
+    if (mValidation && mFlagged.count(pTrack->GetTrackID())) mHitsOfCulled++;
+}
+
+void OMSimPhotonCulling::PrintSummary()
+{
+    if (!IsActive()) return;
+    G4cout << "::::::::::::Photon culling (k = " << mK << " absorption lengths, detection probability of a culled photon < exp(-k) = " << std::exp(-mK) << "):::::::::::" << G4endl;
+    G4cout << "Photons stacked: " << mStacked << ", culled at creation: " << mCulledAtCreation << ", culled in flight: " << mCulledInFlight;
+    if (mStacked > 0) G4cout << " (" << 100. * (mCulledAtCreation + mCulledInFlight) / mStacked << " %)";
+    G4cout << G4endl;
+    if (mValidation)
+    {
+        const G4long lWithCulling = mHits - mHitsOfCulled;
+        G4cout << "Validation: hits of kept photons " << lWithCulling << ", of culled photons " << mHitsOfCulled;
+        if (lWithCulling > 0) G4cout << " (culled / kept " << (G4double)mHitsOfCulled / lWithCulling << " +- " << std::sqrt((G4double)mHitsOfCulled) / lWithCulling << ")";
+        if (mHits > 0) G4cout << ", measured relative loss of hits " << (G4double)mHitsOfCulled / mHits;
+        G4cout << G4endl;
+    }
+}
+
+void OMSimPhotonCulling::Reset()
+{
+    mStacked = 0;
+    mCulledAtCreation = 0;
+    mCulledInFlight = 0;
+    mHits = 0;
+    mHitsOfCulled = 0;
+    mFlagged.clear();
+}
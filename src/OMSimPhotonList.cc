@@ -0,0 +1,165 @@
+/** @file OMSimPhotonList.cc
+ *  @brief Memory-mapped list of optical photons injected as primaries.
+ *
+ *  @date October 2026
+ *
+ *  @version Geant4 10.7
+ */
+
+#include "OMSimPhotonList.hh"
+#include "OMSimPhotonCache.hh"
+#include "OMSimPhotonInfo.hh"
+#include "OMSimModuleBounds.hh"
+#include "OMSimAnalysisManager.hh"
+
+#include "G4Event.hh"
+#include "G4OpticalPhoton.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4PrimaryParticle.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "OMSimLogger.hh"
+
+extern OMSimAnalysisManager gAnalysisManager;
+
+static_assert(sizeof(OMSimPhotonList::Photon) == 56, "photon list records must not contain padding");
+
+namespace
+{
+    const char gListMagic[8] = {'O', 'M', 'S', 'I', 'M', 'P', 'L', '1'};
+    const char gCacheMagic[8] = {'O', 'M', 'S', 'I', 'M', 'P', 'C', '2'};
+    const size_t gCacheHeaderSize = 8 + 4 * sizeof(G4double);
+}
+
+OMSimPhotonList* OMSimPhotonList::GetInstance()
+{
+    static G4ThreadLocal OMSimPhotonList* lInstance = nullptr;
+    if (!lInstance) lInstance = new OMSimPhotonList();
+    return lInstance;
+}
+
+/**
+ * Map a photon list or photon cache into memory.
+ */
+G4bool OMSimPhotonList::Open(G4String pFileName)
+{
+    Close();
+    const int lDescriptor = open(pFileName.c_str(), O_RDONLY);
+    struct stat lStat;
+    if (lDescriptor < 0 || fstat(lDescriptor, &lStat) != 0 || lStat.st_size < 8)
+    {
+        error("Could not open photon list %s", pFileName.c_str());
+        if (lDescriptor >= 0) close(lDescriptor);
+        return false;
+    }
+    mSize = (size_t)lStat.st_size;
+    void* lMap = mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, lDescriptor, 0);
+    close(lDescriptor);
+    if (lMap == MAP_FAILED)
+    {
+        error("Could not map photon list %s", pFileName.c_str());
+        return false;
+    }
+    mData = (const char*)lMap;
+    madvise(lMap, mSize, MADV_SEQUENTIAL);
+
+    if (std::memcmp(mData, gListMagic, 8) == 0)
+    {
+        mCache = false;
+        mRecords = mData + 8;
+        mRecordSize = sizeof(Photon);
+    }
+    else if ((std::memcmp(mData, gCacheMagic, 8) == 0 || OMSimPhotonCache::IsLegacy(mData)) && mSize >= gCacheHeaderSize)
+    {
+        mCache = true;
+        mLegacyCache = OMSimPhotonCache::IsLegacy(mData);
+        mRecords = mData + gCacheHeaderSize;
+        mRecordSize = sizeof(OMSimPhotonCache::Record);
+        mOffset = OMSimModuleBounds::GetNumberOfModules() > 0 ? OMSimModuleBounds::GetModule(0).Center : G4ThreeVector();
+    }
+    else
+    {
+        error("%s is neither a photon list nor a photon cache", pFileName.c_str());
+        Close();
+        return false;
+    }
+    mNrPhotons = (mSize - (mRecords - mData)) / mRecordSize;
+    mNext = 0;
+    info("Photon list %s mapped (%zu photons)", pFileName.c_str(), mNrPhotons);
+    return true;
+}
+
+void OMSimPhotonList::Close()
+{
+    if (mData) munmap((void*)mData, mSize);
+    mData = nullptr;
+    mRecords = nullptr;
+    mSize = 0;
+    mNrPhotons = 0;
+    mNext = 0;
+}
+
+/**
+ * Add the next pBatch photons of the list to the event as primaries.
+ * @return Number of photons added, 0 when the list is exhausted
+ */
+size_t OMSimPhotonList::AddBatch(G4Event* pEvent, size_t pBatch)
+{
+    if (!mData) return 0;
+    const size_t lEnd = std::min(mNrPhotons, mNext + pBatch);
+    const size_t lFirst = mNext;
+    for (; mNext < lEnd; mNext++)
+    {
+        const char* lRecord = mRecords + mNext * mRecordSize;
+        G4ThreeVector lPosition, lDirection, lPolarization, lVertex;
+        G4double lTime, lWavelength;
+        G4double lWeight = 1;
+        G4int lAncestorID;
+        if (mCache)
+        {
+            OMSimPhotonCache::Record lPhoton;
+            std::memcpy(&lPhoton, lRecord, sizeof(lPhoton));
+            lTime = lPhoton.Time * ns;
+            lPosition = mOffset + G4ThreeVector(lPhoton.Position[0], lPhoton.Position[1], lPhoton.Position[2]) * mm;
+            lDirection = G4ThreeVector(lPhoton.Direction[0], lPhoton.Direction[1], lPhoton.Direction[2]);
+            lPolarization = G4ThreeVector(lPhoton.Polarization[0], lPhoton.Polarization[1], lPhoton.Polarization[2]);
+            lVertex = mOffset + G4ThreeVector(lPhoton.Vertex[0], lPhoton.Vertex[1], lPhoton.Vertex[2]) * mm;
+            lWavelength = lPhoton.Wavelength * nm;
+            lAncestorID = lPhoton.AncestorID;
+            if (!mLegacyCache) lWeight = lPhoton.Weight;
+        }
+        else
+        {
+            Photon lPhoton;
+            std::memcpy(&lPhoton, lRecord, sizeof(lPhoton));
+            lTime = lPhoton.Time * ns;
+            lPosition = G4ThreeVector(lPhoton.Position[0], lPhoton.Position[1], lPhoton.Position[2]) * mm;
+            lDirection = G4ThreeVector(lPhoton.Direction[0], lPhoton.Direction[1], lPhoton.Direction[2]);
+            lPolarization = G4ThreeVector(lPhoton.Polarization[0], lPhoton.Polarization[1], lPhoton.Polarization[2]);
+            lVertex = lPosition;
+            lWavelength = lPhoton.Wavelength * nm;
+            lAncestorID = lPhoton.AncestorID;
+        }
+        if (lWavelength <= 0) continue;
+
+        G4PrimaryVertex* lPrimaryVertex = new G4PrimaryVertex(lPosition, lTime);
+        G4PrimaryParticle* lParticle = new G4PrimaryParticle(G4OpticalPhoton::Definition());
+        lParticle->SetMomentumDirection(lDirection.unit());
+        lParticle->SetKineticEnergy(h_Planck * c_light / lWavelength);
+        lParticle->SetPolarization(lPolarization.x(), lPolarization.y(), lPolarization.z());
+        lParticle->SetWeight(lWeight);
+        if (lWeight != 1) gAnalysisManager.weighted = true;
+        lParticle->SetUserInformation(new OMSimPrimaryPhotonInfo(lVertex, lAncestorID));
+        lPrimaryVertex->SetPrimary(lParticle);
+        pEvent->AddPrimaryVertex(lPrimaryVertex);
+    }
+    return mNext - lFirst;
+}
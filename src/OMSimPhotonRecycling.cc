@@ -0,0 +1,100 @@
+/** @file OMSimPhotonRecycling.cc
+ *  @brief Oversampling of photons arriving at the module, using its azimuthal (and up-down) symmetry.
+ *
+ *  @date October 2026
+ *
+ *  @version Geant4 10.7
+ */
+
+#include "OMSimPhotonRecycling.hh"
+#include "OMSimAnalysisManager.hh"
+#include "OMSimModuleBounds.hh"
+#include "OMSimPhotonInfo.hh"
+
+#include "G4DynamicParticle.hh"
+#include "G4OpticalPhoton.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4RotationMatrix.hh"
+#include "G4Step.hh"
+#include "G4Track.hh"
+#include "Randomize.hh"
+
+extern G4int gRecyclingFactor;
+extern G4bool gRecyclingMirror;
+extern OMSimAnalysisManager gAnalysisManager;
+
+OMSimPhotonRecycling* OMSimPhotonRecycling::GetInstance()
+{
+    static G4ThreadLocal OMSimPhotonRecycling* lInstance = nullptr;
+    if (!lInstance) lInstance = new OMSimPhotonRecycling();
+    return lInstance;
+}
+
+OMSimPhotonRecycling::OMSimPhotonRecycling()
+{
+    mFactor = gRecyclingFactor;
+    mMirror = gRecyclingMirror;
+    if (IsActive()) gAnalysisManager.weighted = true;
+}
+
+/**
+ * Recycle the photon of this step if it enters a module bounding sphere for the first time.
+ * @param pStep Current step of an optical photon in the bulk ice
+ * @param pSecondaries Secondary vector of the stepping manager
+ */
+void OMSimPhotonRecycling::Apply(const G4Step* pStep, G4TrackVector* pSecondaries)
+{
+    G4Track* lTrack = pStep->GetTrack();
+    OMSimPhotonInfo* lInfo = (OMSimPhotonInfo*)lTrack->GetUserInformation();
+    if (lInfo && lInfo->Recycled) return;
+
+    G4ThreeVector lCrossing;
+    G4double lFraction;
+    const G4int lModule = OMSimModuleBounds::FirstEnteredModule(pStep, lCrossing, lFraction);
+    if (lModule < 0) return;
+    const OMSimModuleBounds::Sphere& lSphere = OMSimModuleBounds::GetModule(lModule);
+
+    if (!lInfo)
+    {
+        lInfo = new OMSimPhotonInfo(lTrack->GetVertexPosition());
+        lTrack->SetUserInformation(lInfo);
+    }
+    lInfo->Recycled = true;
+
+    const G4StepPoint* lPre = pStep->GetPreStepPoint();
+    const G4double lTime = lPre->GetGlobalTime() + lFraction * (pStep->GetPostStepPoint()->GetGlobalTime() - lPre->GetGlobalTime());
+    const G4double lWeight = lTrack->GetWeight() / mFactor;
+    lTrack->SetWeight(lWeight);
+
+    for (G4int i = 1; i < mFactor; i++)
+    {
+        G4RotationMatrix lRotation;
+        lRotation.rotateZ(twopi * G4UniformRand());
+        G4ThreeVector lPosition = lRotation * (lCrossing - lSphere.Center);
+        G4ThreeVector lDirection = lRotation * lPre->GetMomentumDirection();
+        G4ThreeVector lPolarization = lRotation * lPre->GetPolarization();
+        if (mMirror && G4UniformRand() < 0.5)
+        {
+            lPosition.setZ(-lPosition.z());
+            lDirection.setZ(-lDirection.z());
+            lPolarization.setZ(-lPolarization.z());
+        }
+
+        G4DynamicParticle* lParticle = new G4DynamicParticle(G4OpticalPhoton::Definition(), lDirection, lPre->GetKineticEnergy());
+        lParticle->SetPolarization(lPolarization.x(), lPolarization.y(), lPolarization.z());
+        G4Track* lCopy = new G4Track(lParticle, lTime, lSphere.Center + lPosition);
+        lCopy->SetWeight(lWeight);
+        lCopy->SetParentID(lTrack->GetParentID());
+        lCopy->SetCreatorProcess(lTrack->GetCreatorProcess());
+        lCopy->SetUserInformation(new OMSimPhotonInfo(*lInfo));
+        pSecondaries->push_back(lCopy);
+    }
+    mRecycled++;
+}
+
+void OMSimPhotonRecycling::PrintSummary()
+{
+    if (!IsActive()) return;
+    G4cout << "::::::::::::Photon recycling (factor " << mFactor << (mMirror ? ", with up-down mirroring" : "") << "):::::::::::" << G4endl;
+    G4cout << "Photons recycled at the module boundary: " << mRecycled << " (" << mRecycled * (mFactor - 1) << " copies)" << G4endl;
+}
@@ -4,6 +4,22 @@
 #include "G4Event.hh"
 //#include "G4GeneralParticleSource.hh"
 #include "G4ParticleTypes.hh"
+#include "G4PhysicalConstants.hh"
+#include "Randomize.hh"
+
+#include "OMSimAcceptanceTable.hh"
+#include "OMSimAnalyticHits.hh"
+#include "OMSimAnalysisManager.hh"
+#include "OMSimModuleBounds.hh"
+#include "OMSimPropagationTable.hh"
+#include "OMSimShowerLibrary.hh"
+#include "OMSimPhotonCache.hh"
+#include "OMSimPhotonList.hh"
+#include "OMSimPhotonInfo.hh"
+
+#include "G4PrimaryParticle.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4RunManager.hh"
 
 #include <iostream>
 #include <random>
@@ -12,7 +28,17 @@
 #include <vector>
 #include <stdlib.h>
 
+#include "OMSimLogger.hh"
+
 extern G4double gworldsize;
+extern G4String gGeneratorMode;
+extern G4int gAcceptancePhotons;
+extern G4int gPropagationPhotons;
+extern G4double gPropagationInnerRadius;
+extern G4String gPhotonCacheFile;
+extern G4String gPhotonListFile;
+extern G4int gPhotonListBatch;
+extern OMSimAnalysisManager gAnalysisManager;
 
 
 OMSimPrimaryGeneratorAction::OMSimPrimaryGeneratorAction()
@@ -34,6 +60,30 @@ OMSimPrimaryGeneratorAction::~OMSimPrimaryGeneratorAction()
 void OMSimPrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
 {
 	//particleSource->GeneratePrimaryVertex(anEvent);
+	if (gGeneratorMode == "acceptance") {
+		GeneratePlaneWave(anEvent);
+		return;
+	}
+	if (gGeneratorMode == "proptable") {
+		GeneratePropagationBin(anEvent);
+		return;
+	}
+	if (gGeneratorMode == "photoncache") {
+		GenerateFromPhotonCache(anEvent);
+		return;
+	}
+	if (gGeneratorMode == "photonlist") {
+		GenerateFromPhotonList(anEvent);
+		return;
+	}
+	if (gGeneratorMode == "analytic") {
+		GenerateAnalyticHits();
+		return;
+	}
+	if (gGeneratorMode == "showerbuild") {
+		GenerateLibraryShower(anEvent);
+		return;
+	}
 
 	using namespace std;
 	SetUpEnergyAndPosition();
@@ -133,3 +183,184 @@ void OMSimPrimaryGeneratorAction::SetUpEnergyAndPosition()
 
     G4cout << "Particles Information are set up for " << numParticles << " particles!" << G4endl;
 }
+
+
+/**
+ * Analytic mode: the positrons of the sntools files are not tracked, their hits are computed from the light yield,
+ * propagation and acceptance tables (OMSimAnalyticHits). The event has no primaries.
+ */
+void OMSimPrimaryGeneratorAction::GenerateAnalyticHits()
+{
+	SetUpEnergyAndPosition();
+	OMSimAnalyticHits* lAnalytic = OMSimAnalyticHits::GetInstance();
+	for (G4int i = 0; i < numParticles; i++) {
+		const G4ThreeVector lPosition(data[X][i] * m, data[Y][i] * m, data[Z][i] * m);
+		const G4ThreeVector lDirection(data[AX][i], data[AY][i], data[AZ][i]);
+		lAnalytic->AddPositron(lPosition, lDirection, data[ENERGY][i] * MeV, data[TIME][i] * ms, i + 1); // track id the positron would get
+	}
+	for (auto& vals : data) {
+		vals.clear();
+	}
+}
+
+
+/**
+ * Shower library building: one positron of energy bin i % number of bins along +z, half way between the module and
+ * the edge of the world, so that no light of its cascade is absorbed by the module.
+ */
+void OMSimPrimaryGeneratorAction::GenerateLibraryShower(G4Event* anEvent)
+{
+	OMSimShowerLibrary* lLibrary = OMSimShowerLibrary::GetInstance();
+	if (lLibrary->GetNumberOfBins() == 0) {
+		lLibrary->SetDefaultBinning();
+	}
+	const G4int lBin = anEvent->GetEventID() % lLibrary->GetNumberOfBins();
+	const G4double lEnergy = lLibrary->SampleEnergy(lBin);
+	const G4ThreeVector lVertex(-gworldsize / 4, 0, 0);
+	lLibrary->BeginShower(lBin, lEnergy, lVertex);
+
+	fParticleGun->SetParticleDefinition(G4Positron::Definition());
+	fParticleGun->SetParticlePosition(lVertex);
+	fParticleGun->SetParticleMomentumDirection(G4ThreeVector(0, 0, 1));
+	fParticleGun->SetParticleEnergy(lEnergy);
+	fParticleGun->SetParticleTime(0);
+	fParticleGun->GeneratePrimaryVertex(anEvent);
+}
+
+
+/**
+ * Acceptance table building: gAcceptancePhotons optical photons of one beam bin (direction and wavelength), starting
+ * on a disk of the radius of the module bounding sphere just in front of it, so that every photon that travels
+ * straight ends on the bounding sphere with uniform impact point. Event i fills beam bin i % number of beam bins,
+ * the photons are counted in their impact bins here and their hits by the stepping action.
+ */
+void OMSimPrimaryGeneratorAction::GeneratePlaneWave(G4Event* anEvent)
+{
+	OMSimAcceptanceTable* lTable = OMSimAcceptanceTable::GetInstance();
+	if (lTable->GetNumberOfBeamBins() == 0) {
+		lTable->SetDefaultBinning(gAnalysisManager.GetNumberOfPMTs(), OMSimModuleBounds::GetModule(0).Radius);
+	}
+	const G4int lBin = anEvent->GetEventID() % lTable->GetNumberOfBeamBins();
+	lTable->SetCurrentBin(lBin);
+
+	const OMSimModuleBounds::Sphere& lSphere = OMSimModuleBounds::GetModule(0);
+	fParticleGun->SetParticleDefinition(G4OpticalPhoton::Definition());
+	fParticleGun->SetParticleTime(0);
+	for (G4int i = 0; i < gAcceptancePhotons; i++) {
+		G4ThreeVector lDirection;
+		G4double lLambda;
+		lTable->SampleBin(lBin, lDirection, lLambda);
+		G4ThreeVector lE1, lE2;
+		OMSimAcceptanceTable::DiskBasis(lDirection, lE1, lE2);
+		const G4double lR = lSphere.Radius * std::sqrt(G4UniformRand());
+		const G4double lAngle = twopi * G4UniformRand();
+		const G4double lPolarisation = twopi * G4UniformRand();
+		const G4ThreeVector lImpact = lR * (std::cos(lAngle) * lE1 + std::sin(lAngle) * lE2);
+		lTable->AddPhoton(lBin, lTable->FindImpactBin(lDirection, lImpact));
+
+		fParticleGun->SetParticlePosition(lSphere.Center - (lSphere.Radius + 1 * mm) * lDirection + lImpact);
+		fParticleGun->SetParticleMomentumDirection(lDirection);
+		fParticleGun->SetParticlePolarization(std::cos(lPolarisation) * lE1 + std::sin(lPolarisation) * lE2);
+		fParticleGun->SetParticleEnergy(h_Planck * c_light / lLambda);
+		fParticleGun->GeneratePrimaryVertex(anEvent);
+	}
+}
+
+
+/**
+ * Propagation table building: gPropagationPhotons optical photons of one table bin (distance, angle to the module
+ * direction and wavelength) with random orientation around the module center. Event i fills bin i % number of bins.
+ */
+void OMSimPrimaryGeneratorAction::GeneratePropagationBin(G4Event* anEvent)
+{
+	OMSimPropagationTable* lTable = OMSimPropagationTable::GetInstance();
+	if (lTable->GetNumberOfBins() == 0) {
+		// distance bins up to the edge of the world
+		lTable->SetDefaultBinning(gPropagationInnerRadius, gworldsize / 2 - 1 * cm);
+	}
+	const G4int lBin = anEvent->GetEventID() % lTable->GetNumberOfBins();
+	lTable->SetCurrentBin(lBin);
+	lTable->AddPhotons(lBin, gPropagationPhotons);
+
+	const G4ThreeVector lCenter = OMSimModuleBounds::GetNumberOfModules() > 0 ? OMSimModuleBounds::GetModule(0).Center : G4ThreeVector();
+	fParticleGun->SetParticleDefinition(G4OpticalPhoton::Definition());
+	fParticleGun->SetParticleTime(0);
+	for (G4int i = 0; i < gPropagationPhotons; i++) {
+		G4double lR, lCosAlpha, lLambda;
+		lTable->SampleBin(lBin, lR, lCosAlpha, lLambda);
+		const G4double lCosTheta = 2 * G4UniformRand() - 1;
+		const G4double lPhi = twopi * G4UniformRand();
+		const G4double lSinTheta = std::sqrt(1 - lCosTheta * lCosTheta);
+		const G4ThreeVector lRadial(lSinTheta * std::cos(lPhi), lSinTheta * std::sin(lPhi), lCosTheta);
+		const G4ThreeVector lE1 = lRadial.orthogonal().unit();
+		const G4double lAzimuth = twopi * G4UniformRand();
+		const G4ThreeVector lTransverse = std::cos(lAzimuth) * lE1 + std::sin(lAzimuth) * lRadial.cross(lE1);
+		const G4ThreeVector lDirection = -lCosAlpha * lRadial + std::sqrt(1 - lCosAlpha * lCosAlpha) * lTransverse;
+		const G4ThreeVector lP1 = lDirection.orthogonal().unit();
+		const G4double lPolarisation = twopi * G4UniformRand();
+
+		fParticleGun->SetParticlePosition(lCenter + lR * lRadial);
+		fParticleGun->SetParticleMomentumDirection(lDirection);
+		fParticleGun->SetParticlePolarization(std::cos(lPolarisation) * lP1 + std::sin(lPolarisation) * lDirection.cross(lP1));
+		fParticleGun->SetParticleEnergy(h_Planck * c_light / lLambda);
+		fParticleGun->GeneratePrimaryVertex(anEvent);
+	}
+}
+
+
+/**
+ * Second stage of a two-stage simulation: inject the photons of the next event of the photon cache as primaries,
+ * around the module that is currently built. The run is aborted when the cache is exhausted.
+ */
+void OMSimPrimaryGeneratorAction::GenerateFromPhotonCache(G4Event* anEvent)
+{
+	OMSimPhotonCache* lCache = OMSimPhotonCache::GetInstance();
+	static G4ThreadLocal G4bool lOpened = false;
+	if (!lOpened) {
+		lOpened = true;
+		if (lCache->OpenForReading(gPhotonCacheFile) && OMSimModuleBounds::GetNumberOfModules() > 0
+		    && OMSimModuleBounds::GetModule(0).Radius > lCache->GetRadius()) {
+			warning("The module is larger than the sphere of the photon cache, photons start inside it");
+		}
+	}
+
+	std::vector<OMSimPhotonCache::Record> lRecords;
+	if (!lCache->ReadEvent(lRecords)) {
+		G4cout << "Photon cache exhausted, aborting run" << G4endl;
+		G4RunManager::GetRunManager()->AbortRun(true);
+		return;
+	}
+
+	const G4ThreeVector lCenter = OMSimModuleBounds::GetNumberOfModules() > 0 ? OMSimModuleBounds::GetModule(0).Center : G4ThreeVector();
+	for (const OMSimPhotonCache::Record& lRecord : lRecords) {
+		G4PrimaryVertex* lVertex = new G4PrimaryVertex(lCenter + G4ThreeVector(lRecord.Position[0], lRecord.Position[1], lRecord.Position[2]) * mm, lRecord.Time * ns);
+		G4PrimaryParticle* lPhoton = new G4PrimaryParticle(G4OpticalPhoton::Definition());
+		lPhoton->SetMomentumDirection(G4ThreeVector(lRecord.Direction[0], lRecord.Direction[1], lRecord.Direction[2]));
+		lPhoton->SetKineticEnergy(h_Planck * c_light / (lRecord.Wavelength * nm));
+		lPhoton->SetPolarization(lRecord.Polarization[0], lRecord.Polarization[1], lRecord.Polarization[2]);
+		lPhoton->SetWeight(lRecord.Weight);
+		if (lRecord.Weight != 1) gAnalysisManager.weighted = true;
+		lPhoton->SetUserInformation(new OMSimPrimaryPhotonInfo(lCenter + G4ThreeVector(lRecord.Vertex[0], lRecord.Vertex[1], lRecord.Vertex[2]) * mm, lRecord.AncestorID));
+		lVertex->SetPrimary(lPhoton);
+		anEvent->AddPrimaryVertex(lVertex);
+	}
+}
+
+
+/**
+ * Inject the next gPhotonListBatch photons of the photon list as primaries. The run is aborted when the list is
+ * exhausted.
+ */
+void OMSimPrimaryGeneratorAction::GenerateFromPhotonList(G4Event* anEvent)
+{
+	OMSimPhotonList* lList = OMSimPhotonList::GetInstance();
+	static G4ThreadLocal G4bool lOpened = false;
+	if (!lOpened) {
+		lOpened = true;
+		lList->Open(gPhotonListFile);
+	}
+	if (lList->AddBatch(anEvent, gPhotonListBatch) == 0) {
+		G4cout << "Photon list exhausted, aborting run" << G4endl;
+		G4RunManager::GetRunManager()->AbortRun(true);
+	}
+}
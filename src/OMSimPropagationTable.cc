@@ -0,0 +1,225 @@
+/** @file OMSimPropagationTable.cc
+ *  @brief Photon propagation tables of the bulk ice for the fast simulation.
+ *
+ *  @date October 2026
+ *
+ *  @version Geant4 10.7
+ */
+
+#include "OMSimPropagationTable.hh"
+
+#include "G4PhysicalConstants.hh"
+#include "G4Step.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4Track.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+#include "OMSimLogger.hh"
+
+namespace
+{
+    const char gTableMagic[8] = {'O', 'M', 'S', 'I', 'M', 'P', 'T', '1'};
+
+    // default binning of new tables
+    const G4int gDefaultNrR = 30;
+    const G4int gDefaultNrCosAlpha = 20;
+    const G4int gDefaultNrLambda = 10;
+    const G4double gDefaultLambdaMin = 300 * nm;
+    const G4double gDefaultLambdaMax = 600 * nm;
+    const G4int gDefaultReservoir = 64;
+}
+
+OMSimPropagationTable* OMSimPropagationTable::GetInstance()
+{
+    static G4ThreadLocal OMSimPropagationTable* lInstance = nullptr;
+    if (!lInstance) lInstance = new OMSimPropagationTable();
+    return lInstance;
+}
+
+/**
+ * Define the bins of an empty table (for building). Radial bins are logarithmic between pRMin and pRMax.
+ * @param pReservoir Maximum number of arrivals stored per bin
+ */
+void OMSimPropagationTable::SetBinning(G4int pNrR, G4int pNrCosAlpha, G4int pNrLambda, G4double pRMin, G4double pRMax,
+                                       G4double pLambdaMin, G4double pLambdaMax, G4int pReservoir)
+{
+    mNrR = pNrR;
+    mNrCosAlpha = pNrCosAlpha;
+    mNrLambda = pNrLambda;
+    mRMin = pRMin;
+    mRMax = pRMax;
+    mLambdaMin = pLambdaMin;
+    mLambdaMax = pLambdaMax;
+    mReservoir = pReservoir;
+    mPhotons.assign(GetNumberOfBins(), 0);
+    mArrivals.assign(GetNumberOfBins(), 0);
+    mSamples.assign(GetNumberOfBins(), std::vector<Arrival>());
+    mLoaded = false;
+}
+
+/**
+ * Logarithmic distance bins between pRMin and pRMax, 20 angle bins, 10 wavelength bins between 300 and 600 nm.
+ */
+void OMSimPropagationTable::SetDefaultBinning(G4double pRMin, G4double pRMax)
+{
+    SetBinning(gDefaultNrR, gDefaultNrCosAlpha, gDefaultNrLambda, pRMin, pRMax, gDefaultLambdaMin, gDefaultLambdaMax, gDefaultReservoir);
+}
+
+G4int OMSimPropagationTable::GetDefaultNumberOfBins()
+{
+    return gDefaultNrR * gDefaultNrCosAlpha * gDefaultNrLambda;
+}
+
+/**
+ * Binary format: 8 byte magic "OMSIMPT1", binning (4 x int32, 4 x double in mm/nm), then per bin
+ * photons (double), arrivals (double), number of samples (int32) and the samples (7 x float).
+ */
+G4bool OMSimPropagationTable::Load(G4String pFileName)
+{
+    std::ifstream lFile(pFileName.c_str(), std::ios::binary);
+    char lMagic[8];
+    if (!lFile.is_open() || !lFile.read(lMagic, 8) || std::memcmp(lMagic, gTableMagic, 8) != 0)
+    {
+        error("Could not read propagation table %s", pFileName.c_str());
+        return false;
+    }
+    int32_t lInts[4];
+    G4double lDoubles[4];
+    lFile.read((char*)lInts, sizeof(lInts));
+    lFile.read((char*)lDoubles, sizeof(lDoubles));
+    SetBinning(lInts[0], lInts[1], lInts[2], lDoubles[0] * mm, lDoubles[1] * mm, lDoubles[2] * nm, lDoubles[3] * nm, lInts[3]);
+    for (G4int i = 0; i < GetNumberOfBins() && lFile; i++)
+    {
+        int32_t lNrSamples = 0;
+        lFile.read((char*)&mPhotons[i], sizeof(G4double));
+        lFile.read((char*)&mArrivals[i], sizeof(G4double));
+        lFile.read((char*)&lNrSamples, sizeof(int32_t));
+        mSamples[i].resize(lNrSamples);
+        lFile.read((char*)mSamples[i].data(), lNrSamples * sizeof(Arrival));
+    }
+    if (!lFile)
+    {
+        error("Propagation table %s is truncated", pFileName.c_str());
+        return false;
+    }
+    mLoaded = true;
+    info("Propagation table %s loaded (%d bins, inner radius %f m)", pFileName.c_str(), GetNumberOfBins(), mRMin / m);
+    return true;
+}
+
+void OMSimPropagationTable::Save(G4String pFileName)
+{
+    std::ofstream lFile(pFileName.c_str(), std::ios::binary);
+    if (!lFile.is_open())
+    {
+        error("Could not write propagation table %s", pFileName.c_str());
+        return;
+    }
+    const int32_t lInts[4] = {mNrR, mNrCosAlpha, mNrLambda, mReservoir};
+    const G4double lDoubles[4] = {mRMin / mm, mRMax / mm, mLambdaMin / nm, mLambdaMax / nm};
+    lFile.write(gTableMagic, 8);
+    lFile.write((const char*)lInts, sizeof(lInts));
+    lFile.write((const char*)lDoubles, sizeof(lDoubles));
+    for (G4int i = 0; i < GetNumberOfBins(); i++)
+    {
+        const int32_t lNrSamples = (int32_t)mSamples[i].size();
+        lFile.write((const char*)&mPhotons[i], sizeof(G4double));
+        lFile.write((const char*)&mArrivals[i], sizeof(G4double));
+        lFile.write((const char*)&lNrSamples, sizeof(int32_t));
+        lFile.write((const char*)mSamples[i].data(), lNrSamples * sizeof(Arrival));
+    }
+    info("Propagation table written to %s", pFileName.c_str());
+}
+
+/**
+ * @return Bin index, -1 if outside of the table
+ */
+G4int OMSimPropagationTable::FindBin(G4double pR, G4double pCosAlpha, G4double pLambda)
+{
+    if (pR < mRMin || pR >= mRMax || pLambda < mLambdaMin || pLambda >= mLambdaMax) return -1;
+    const G4int lR = (G4int)(std::log(pR / mRMin) / std::log(mRMax / mRMin) * mNrR);
+    const G4int lCos = std::max(0, std::min(mNrCosAlpha - 1, (G4int)((pCosAlpha + 1) / 2 * mNrCosAlpha)));
+    const G4int lLambda = (G4int)((pLambda - mLambdaMin) / (mLambdaMax - mLambdaMin) * mNrLambda);
+    return (lR * mNrCosAlpha + lCos) * mNrLambda + lLambda;
+}
+
+/**
+ * Random start parameters uniformly distributed inside a bin (r uniform in log r).
+ */
+void OMSimPropagationTable::SampleBin(G4int pBin, G4double& pR, G4double& pCosAlpha, G4double& pLambda)
+{
+    const G4int lLambda = pBin % mNrLambda;
+    const G4int lCos = (pBin / mNrLambda) % mNrCosAlpha;
+    const G4int lR = pBin / (mNrLambda * mNrCosAlpha);
+    pR = mRMin * std::pow(mRMax / mRMin, (lR + G4UniformRand()) / mNrR);
+    pCosAlpha = -1 + 2. * (lCos + G4UniformRand()) / mNrCosAlpha;
+    pLambda = mLambdaMin + (mLambdaMax - mLambdaMin) * (lLambda + G4UniformRand()) / mNrLambda;
+}
+
+G4double OMSimPropagationTable::GetArrivalProbability(G4int pBin)
+{
+    if (pBin < 0 || mPhotons[pBin] <= 0) return 0;
+    return mArrivals[pBin] / mPhotons[pBin];
+}
+
+/**
+ * @return Random arrival of the bin, nullptr if the bin has none
+ */
+const OMSimPropagationTable::Arrival* OMSimPropagationTable::SampleArrival(G4int pBin)
+{
+    if (pBin < 0 || mSamples[pBin].empty()) return nullptr;
+    return &mSamples[pBin][(size_t)(G4UniformRand() * mSamples[pBin].size()) % mSamples[pBin].size()];
+}
+
+/**
+ * Local frame of a photon: z from the module center to the photon, x along the part of the photon direction
+ * perpendicular to z (any perpendicular vector for radial photons), y = z cross x.
+ */
+void OMSimPropagationTable::LocalFrame(const G4ThreeVector& pFromCenter, const G4ThreeVector& pDirection, G4ThreeVector& pX, G4ThreeVector& pY, G4ThreeVector& pZ)
+{
+    pZ = pFromCenter.unit();
+    pX = pDirection - pDirection.dot(pZ) * pZ;
+    if (pX.mag2() < 1e-12) pX = pZ.orthogonal();
+    pX = pX.unit();
+    pY = pZ.cross(pX);
+}
+
+void OMSimPropagationTable::AddPhotons(G4int pBin, G4long pPhotons)
+{
+    if (pBin >= 0 && pBin < GetNumberOfBins()) mPhotons[pBin] += pPhotons;
+}
+
+/**
+ * Building: store the arrival of a photon on the inner sphere in the bin of the current event. The local frame is
+ * reconstructed from the vertex of the track, the photons of the builder start at t = 0. Reservoir sampling keeps an
+ * unbiased subset of mReservoir arrivals per bin.
+ * @param pStep Step ending on the inner sphere
+ * @param pCenter Module center
+ */
+void OMSimPropagationTable::RecordArrival(const G4Step* pStep, G4ThreeVector pCenter)
+{
+    if (mCurrentBin < 0 || mCurrentBin >= GetNumberOfBins()) return;
+    const G4Track* lTrack = pStep->GetTrack();
+    G4ThreeVector lX, lY, lZ;
+    LocalFrame(lTrack->GetVertexPosition() - pCenter, lTrack->GetVertexMomentumDirection(), lX, lY, lZ);
+    const G4ThreeVector lPosition = (pStep->GetPostStepPoint()->GetPosition() - pCenter).unit();
+    const G4ThreeVector lDirection = pStep->GetPostStepPoint()->GetMomentumDirection();
+
+    const Arrival lArrival = {(G4float)(pStep->GetPostStepPoint()->GetGlobalTime() / ns),
+                              {(G4float)lPosition.dot(lX), (G4float)lPosition.dot(lY), (G4float)lPosition.dot(lZ)},
+                              {(G4float)lDirection.dot(lX), (G4float)lDirection.dot(lY), (G4float)lDirection.dot(lZ)}};
+    mArrivals[mCurrentBin] += 1;
+    std::vector<Arrival>& lSamples = mSamples[mCurrentBin];
+    if ((G4int)lSamples.size() < mReservoir)
+    {
+        lSamples.push_back(lArrival);
+        return;
+    }
+    const size_t lIndex = (size_t)(G4UniformRand() * mArrivals[mCurrentBin]);
+    if (lIndex < lSamples.size()) lSamples[lIndex] = lArrival;
+}
@@ -0,0 +1,589 @@
+/** @file OMSimRevolvedSolid.cc
+ *  @brief Analytic solid of revolution (union of ellipsoids, sphere sectors, frustums and convex polycones) for PMT bulbs and pressure vessels.
+ *
+ *  @date October 2026
+ *
+ *  @version Geant4 10.7
+ */
+
+#include "OMSimRevolvedSolid.hh"
+
+#include "G4AffineTransform.hh"
+#include "G4BoundingEnvelope.hh"
+#include "G4Polycone.hh"
+#include "G4Polyhedron.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4VGraphicsScene.hh"
+#include "G4VoxelLimits.hh"
+
+#include <algorithm>
+#include <cmath>
+
+#include "OMSimLogger.hh"
+
+namespace
+{
+    // the pieces are kept in fixed-size arrays during DistanceToOut
+    const size_t gMaxPieces = 8;
+    // z planes of the polyhedron built from the profile, besides the ends of the pieces
+    const G4int gProfileSteps = 120;
+
+    /**
+     * Real roots of A t^2 + B t + C (A != 0), sorted.
+     * @return false if there is none
+     */
+    G4bool SolveQuadratic(G4double pA, G4double pB, G4double pC, G4double &pT1, G4double &pT2)
+    {
+        const G4double lDisc = pB * pB - 4 * pA * pC;
+        if (lDisc < 0) return false;
+        const G4double lRoot = std::sqrt(lDisc);
+        const G4double lQ = -0.5 * (pB + (pB >= 0 ? lRoot : -lRoot));
+        pT1 = lQ / pA;
+        pT2 = lQ != 0 ? pC / lQ : pT1;
+        if (pT1 > pT2) std::swap(pT1, pT2);
+        return true;
+    }
+
+    /**
+     * Ray parameters t where B t + C <= 0.
+     */
+    G4bool SolveLinear(G4double pB, G4double pC, G4double &pEnter, G4double &pExit)
+    {
+        pEnter = -kInfinity;
+        pExit = kInfinity;
+        if (pB == 0) return pC <= 0;
+        if (pB > 0) pExit = -pC / pB;
+        else pEnter = -pC / pB;
+        return true;
+    }
+}
+
+OMSimRevolvedSolid::OMSimRevolvedSolid(const G4String &pName, G4VSolid *pReference)
+    : G4VSolid(pName), mReference(pReference), mHalfTolerance(0.5 * kCarTolerance)
+{
+}
+
+/**
+ * Ellipsoid of revolution centred at (0, 0, pZ), optionally cut to pZMin <= z <= pZMax.
+ */
+void OMSimRevolvedSolid::AddEllipsoid(G4double pXYaxis, G4double pZaxis, G4double pZ, G4double pZMin, G4double pZMax)
+{
+    Constraint lEllipsoid;
+    lEllipsoid.Kind = kQuadric;
+    lEllipsoid.Alpha = 1. / (pXYaxis * pXYaxis);
+    lEllipsoid.Beta = 1. / (pZaxis * pZaxis);
+    lEllipsoid.Gamma = 1;
+    lEllipsoid.Z = pZ;
+    lEllipsoid.MinAxis = std::min(pXYaxis, pZaxis);
+    Piece lPiece;
+    lPiece.Constraints.push_back(lEllipsoid);
+    lPiece.Radius = pXYaxis;
+    lPiece.ZMin = pZ - pZaxis;
+    lPiece.ZMax = pZ + pZaxis;
+    AddPiece(lPiece, pZMin, pZMax);
+}
+
+/**
+ * Sector of a full sphere centred at (0, 0, pZ) between the polar angles 0 and pTheta (as G4Sphere with rmin = 0),
+ * optionally cut to pZMin <= z <= pZMax.
+ */
+void OMSimRevolvedSolid::AddSphereSector(G4double pRadius, G4double pZ, G4double pTheta, G4double pZMin, G4double pZMax)
+{
+    if (pTheta > 0.5 * CLHEP::pi + 1e-12)
+    {
+        critical("%s: sphere sectors wider than a hemisphere are not convex and cannot be added", GetName().c_str());
+        return;
+    }
+    Constraint lBall;
+    lBall.Kind = kQuadric;
+    lBall.Alpha = lBall.Beta = 1. / (pRadius * pRadius);
+    lBall.Gamma = 1;
+    lBall.Z = pZ;
+    lBall.MinAxis = pRadius;
+    Piece lPiece;
+    lPiece.Constraints.push_back(lBall);
+    lPiece.Radius = pRadius * std::sin(pTheta);
+    lPiece.ZMin = pZ;
+    lPiece.ZMax = pZ + pRadius;
+    if (pTheta < 0.5 * CLHEP::pi - 1e-12)
+    {
+        Constraint lCone;
+        lCone.Kind = kCone;
+        lCone.Z = pZ;
+        lCone.Slope = std::tan(pTheta);
+        lPiece.Constraints.push_back(lCone);
+        AddPiece(lPiece, pZMin, pZMax);
+    }
+    else
+    {
+        // hemisphere: the cone degenerates to the plane through the centre
+        lPiece.ZMin = -kInfinity;
+        AddPiece(lPiece, std::max(pZMin, pZ), pZMax);
+    }
+}
+
+void OMSimRevolvedSolid::AddCylinder(G4double pRadius, G4double pZMin, G4double pZMax)
+{
+    AddFrustum(pRadius, pRadius, pZMin, pZMax);
+}
+
+/**
+ * Frustum of a cone (or cylinder) with radius pRadiusLow at pZLow and pRadiusHigh at pZHigh.
+ */
+void OMSimRevolvedSolid::AddFrustum(G4double pRadiusLow, G4double pRadiusHigh, G4double pZLow, G4double pZHigh)
+{
+    if (pRadiusLow <= 0 && pRadiusHigh <= 0) return;
+    Piece lPiece;
+    AddSide(lPiece, pRadiusLow, pRadiusHigh, pZLow, pZHigh);
+    lPiece.Radius = std::max(pRadiusLow, pRadiusHigh);
+    lPiece.ZMin = -kInfinity;
+    lPiece.ZMax = kInfinity;
+    AddPiece(lPiece, pZLow, pZHigh);
+}
+
+/**
+ * Full polycone (rmin = 0, 2 pi) whose radius is a concave function of z, i.e. a convex solid. It is added as a single
+ * piece: the cones of all sections, each extended beyond its section.
+ * @return false (and nothing added) if the polycone is not of this kind
+ */
+G4bool OMSimRevolvedSolid::AddConvexPolycone(const G4Polycone *pPolycone)
+{
+    const G4PolyconeHistorical *lParameters = pPolycone->GetOriginalParameters();
+    const G4int lNrPlanes = lParameters->Num_z_planes;
+    if (lNrPlanes < 2 || lParameters->Opening_angle < CLHEP::twopi - 1e-9) return false;
+    std::vector<G4double> lZ(lParameters->Z_values, lParameters->Z_values + lNrPlanes);
+    std::vector<G4double> lR(lParameters->Rmax, lParameters->Rmax + lNrPlanes);
+    for (G4int i = 0; i < lNrPlanes; i++)
+        if (lParameters->Rmin[i] != 0) return false;
+    if (lZ.front() > lZ.back())
+    {
+        std::reverse(lZ.begin(), lZ.end());
+        std::reverse(lR.begin(), lR.end());
+    }
+    G4double lPreviousSlope = kInfinity;
+    for (G4int i = 0; i + 1 < lNrPlanes; i++)
+    {
+        if (lZ[i + 1] <= lZ[i]) return false;
+        const G4double lSlope = (lR[i + 1] - lR[i]) / (lZ[i + 1] - lZ[i]);
+        if (lSlope > lPreviousSlope + 1e-9) return false;
+        lPreviousSlope = lSlope;
+    }
+
+    Piece lPiece;
+    for (G4int i = 0; i + 1 < lNrPlanes; i++)
+        if (lR[i] > 0 || lR[i + 1] > 0) AddSide(lPiece, lR[i], lR[i + 1], lZ[i], lZ[i + 1]);
+    lPiece.Radius = *std::max_element(lR.begin(), lR.end());
+    lPiece.ZMin = -kInfinity;
+    lPiece.ZMax = kInfinity;
+    AddPiece(lPiece, lZ.front(), lZ.back());
+    return true;
+}
+
+/**
+ * Lateral surface through (pRadiusLow, pZLow) and (pRadiusHigh, pZHigh): a cylinder or one nappe of a cone.
+ */
+void OMSimRevolvedSolid::AddSide(Piece &pPiece, G4double pRadiusLow, G4double pRadiusHigh, G4double pZLow, G4double pZHigh)
+{
+    Constraint lSide;
+    if (pRadiusLow == pRadiusHigh)
+    {
+        lSide.Kind = kQuadric;
+        lSide.Alpha = 1. / (pRadiusLow * pRadiusLow);
+        lSide.Gamma = 1;
+        lSide.MinAxis = pRadiusLow;
+    }
+    else
+    {
+        lSide.Kind = kCone;
+        lSide.Slope = std::fabs(pRadiusHigh - pRadiusLow) / (pZHigh - pZLow);
+        lSide.Direction = pRadiusHigh > pRadiusLow ? 1 : -1;
+        lSide.Z = pRadiusHigh > pRadiusLow ? pZLow - pRadiusLow / lSide.Slope : pZHigh + pRadiusHigh / lSide.Slope;
+    }
+    pPiece.Constraints.push_back(lSide);
+}
+
+/**
+ * Cut the piece to pZMin <= z <= pZMax and add it. Empty pieces are dropped.
+ */
+void OMSimRevolvedSolid::AddPiece(Piece &pPiece, G4double pZMin, G4double pZMax)
+{
+    if (pZMin > pPiece.ZMin)
+    {
+        Constraint lPlane;
+        lPlane.Kind = kZMin;
+        lPlane.Z = pZMin;
+        pPiece.Constraints.push_back(lPlane);
+        pPiece.ZMin = pZMin;
+    }
+    if (pZMax < pPiece.ZMax)
+    {
+        Constraint lPlane;
+        lPlane.Kind = kZMax;
+        lPlane.Z = pZMax;
+        pPiece.Constraints.push_back(lPlane);
+        pPiece.ZMax = pZMax;
+    }
+    if (pPiece.ZMin >= pPiece.ZMax) return;
+    if (pPiece.ZMin <= -kInfinity || pPiece.ZMax >= kInfinity)
+    {
+        critical("%s: pieces have to be bounded in z", GetName().c_str());
+        return;
+    }
+    if (mPieces.size() >= gMaxPieces)
+    {
+        critical("%s: more than %zu pieces are not supported", GetName().c_str(), gMaxPieces);
+        return;
+    }
+    mPieces.push_back(pPiece);
+}
+
+/**
+ * Signed distance of p to the surface of the constraint, negative inside. Exact for planes, cylinders and cones,
+ * first order for ellipsoids. With pSafety, ellipsoids return a value whose magnitude never exceeds the distance.
+ */
+G4double OMSimRevolvedSolid::Distance(const Constraint &pConstraint, const G4ThreeVector &p, G4bool pSafety) const
+{
+    switch (pConstraint.Kind)
+    {
+    case kZMin:
+        return pConstraint.Z - p.z();
+    case kZMax:
+        return p.z() - pConstraint.Z;
+    case kCone:
+        return (p.perp() - pConstraint.Slope * pConstraint.Direction * (p.z() - pConstraint.Z)) / std::sqrt(1 + pConstraint.Slope * pConstraint.Slope);
+    default:
+        break;
+    }
+    const G4double lRho2 = p.perp2();
+    if (pConstraint.Beta == 0) return std::sqrt(lRho2) - pConstraint.MinAxis;
+    const G4double lDz = p.z() - pConstraint.Z;
+    const G4double lScaled2 = pConstraint.Alpha * lRho2 + pConstraint.Beta * lDz * lDz;
+    if (pSafety) return (std::sqrt(lScaled2) - 1) * pConstraint.MinAxis;
+    const G4double lGradient = 2 * std::sqrt(pConstraint.Alpha * pConstraint.Alpha * lRho2 + pConstraint.Beta * pConstraint.Beta * lDz * lDz);
+    if (lGradient == 0) return -pConstraint.MinAxis;
+    return (lScaled2 - pConstraint.Gamma) / lGradient;
+}
+
+/**
+ * Outward normal of the surface of the constraint at p.
+ */
+G4ThreeVector OMSimRevolvedSolid::Normal(const Constraint &pConstraint, const G4ThreeVector &p) const
+{
+    switch (pConstraint.Kind)
+    {
+    case kZMin:
+        return G4ThreeVector(0, 0, -1);
+    case kZMax:
+        return G4ThreeVector(0, 0, 1);
+    case kCone:
+    {
+        const G4double lRho = p.perp();
+        if (lRho == 0) return G4ThreeVector(0, 0, -pConstraint.Direction);
+        return G4ThreeVector(p.x() / lRho, p.y() / lRho, -pConstraint.Slope * pConstraint.Direction).unit();
+    }
+    default:
+        break;
+    }
+    const G4ThreeVector lGradient(pConstraint.Alpha * p.x(), pConstraint.Alpha * p.y(), pConstraint.Beta * (p.z() - pConstraint.Z));
+    if (lGradient.mag2() == 0) return G4ThreeVector(0, 0, 1);
+    return lGradient.unit();
+}
+
+/**
+ * Interval of the ray p + t v (t of any sign) inside the constraint.
+ * @return false if the ray misses it
+ */
+G4bool OMSimRevolvedSolid::Interval(const Constraint &pConstraint, const G4ThreeVector &p, const G4ThreeVector &v, G4double &pEnter, G4double &pExit) const
+{
+    if (pConstraint.Kind == kZMin) return SolveLinear(-v.z(), pConstraint.Z - p.z(), pEnter, pExit);
+    if (pConstraint.Kind == kZMax) return SolveLinear(v.z(), p.z() - pConstraint.Z, pEnter, pExit);
+
+    const G4double lAlpha = pConstraint.Kind == kCone ? 1 : pConstraint.Alpha;
+    const G4double lBeta = pConstraint.Kind == kCone ? -pConstraint.Slope * pConstraint.Slope : pConstraint.Beta;
+    const G4double lGamma = pConstraint.Kind == kCone ? 0 : pConstraint.Gamma;
+    const G4double lDz = p.z() - pConstraint.Z;
+    const G4double lA = lAlpha * v.perp2() + lBeta * v.z() * v.z();
+    const G4double lB = 2 * (lAlpha * (p.x() * v.x() + p.y() * v.y()) + lBeta * lDz * v.z());
+    const G4double lC = lAlpha * p.perp2() + lBeta * lDz * lDz - lGamma;
+    const G4bool lLinear = std::fabs(lA) <= 1e-12 * (lAlpha + std::fabs(lBeta));
+
+    if (pConstraint.Kind == kQuadric)
+    {
+        if (lLinear) return SolveLinear(lB, lC, pEnter, pExit);
+        return SolveQuadratic(lA, lB, lC, pEnter, pExit);
+    }
+
+    // cone: both nappes, then the part on the side of the opening
+    G4double lIntervals[2][2];
+    G4int lNrIntervals = 0;
+    if (lLinear)
+    {
+        if (SolveLinear(lB, lC, lIntervals[0][0], lIntervals[0][1])) lNrIntervals = 1;
+    }
+    else
+    {
+        G4double lT1, lT2;
+        const G4bool lRoots = SolveQuadratic(lA, lB, lC, lT1, lT2);
+        if (lA > 0 && lRoots)
+        {
+            lIntervals[0][0] = lT1;
+            lIntervals[0][1] = lT2;
+            lNrIntervals = 1;
+        }
+        else if (lA < 0 && !lRoots)
+        {
+            lIntervals[0][0] = -kInfinity;
+            lIntervals[0][1] = kInfinity;
+            lNrIntervals = 1;
+        }
+        else if (lA < 0)
+        {
+            lIntervals[0][0] = -kInfinity;
+            lIntervals[0][1] = lT1;
+            lIntervals[1][0] = lT2;
+            lIntervals[1][1] = kInfinity;
+            lNrIntervals = 2;
+        }
+    }
+    G4double lUpperEnter, lUpperExit;
+    if (!SolveLinear(-pConstraint.Direction * v.z(), -pConstraint.Direction * lDz, lUpperEnter, lUpperExit)) return false;
+    G4bool lFound = false;
+    for (G4int i = 0; i < lNrIntervals; i++)
+    {
+        const G4double lEnter = std::max(lIntervals[i][0], lUpperEnter);
+        const G4double lExit = std::min(lIntervals[i][1], lUpperExit);
+        if (lExit <= lEnter || (lFound && lExit - lEnter <= pExit - pEnter)) continue;
+        pEnter = lEnter;
+        pExit = lExit;
+        lFound = true;
+    }
+    return lFound;
+}
+
+/**
+ * Interval of the ray p + t v inside a piece (intersection of its constraints).
+ * @param pExitConstraint Constraint through which the ray leaves the piece
+ */
+G4bool OMSimRevolvedSolid::Interval(const Piece &pPiece, const G4ThreeVector &p, const G4ThreeVector &v, G4double &pEnter, G4double &pExit, const Constraint *&pExitConstraint) const
+{
+    pEnter = -kInfinity;
+    pExit = kInfinity;
+    pExitConstraint = nullptr;
+    for (const Constraint &lConstraint : pPiece.Constraints)
+    {
+        G4double lEnter, lExit;
+        if (!Interval(lConstraint, p, v, lEnter, lExit)) return false;
+        pEnter = std::max(pEnter, lEnter);
+        if (lExit < pExit)
+        {
+            pExit = lExit;
+            pExitConstraint = &lConstraint;
+        }
+        if (pExit <= pEnter) return false;
+    }
+    return true;
+}
+
+EInside OMSimRevolvedSolid::Inside(const G4ThreeVector &p) const
+{
+    G4double lDistance = kInfinity;
+    for (const Piece &lPiece : mPieces)
+    {
+        G4double lPieceDistance = -kInfinity;
+        for (const Constraint &lConstraint : lPiece.Constraints)
+        {
+            lPieceDistance = std::max(lPieceDistance, Distance(lConstraint, p, false));
+            if (lPieceDistance > mHalfTolerance) break;
+        }
+        lDistance = std::min(lDistance, lPieceDistance);
+        if (lDistance < -mHalfTolerance) return kInside;
+    }
+    return lDistance > mHalfTolerance ? kOutside : kSurface;
+}
+
+G4ThreeVector OMSimRevolvedSolid::SurfaceNormal(const G4ThreeVector &p) const
+{
+    G4double lDistance = kInfinity;
+    const Constraint *lNearest = nullptr;
+    for (const Piece &lPiece : mPieces)
+    {
+        G4double lPieceDistance = -kInfinity;
+        const Constraint *lPieceNearest = nullptr;
+        for (const Constraint &lConstraint : lPiece.Constraints)
+        {
+            const G4double lConstraintDistance = Distance(lConstraint, p, false);
+            if (lConstraintDistance <= lPieceDistance) continue;
+            lPieceDistance = lConstraintDistance;
+            lPieceNearest = &lConstraint;
+        }
+        if (lPieceDistance < lDistance)
+        {
+            lDistance = lPieceDistance;
+            lNearest = lPieceNearest;
+        }
+    }
+    return lNearest ? Normal(*lNearest, p) : G4ThreeVector(0, 0, 1);
+}
+
+G4double OMSimRevolvedSolid::DistanceToIn(const G4ThreeVector &p, const G4ThreeVector &v) const
+{
+    G4double lDistance = kInfinity;
+    for (const Piece &lPiece : mPieces)
+    {
+        G4double lEnter, lExit;
+        const Constraint *lExitConstraint;
+        if (!Interval(lPiece, p, v, lEnter, lExit, lExitConstraint)) continue;
+        if (lExit <= mHalfTolerance || lExit - lEnter <= mHalfTolerance) continue;
+        lDistance = std::min(lDistance, std::max(lEnter, 0.));
+    }
+    return lDistance;
+}
+
+G4double OMSimRevolvedSolid::DistanceToIn(const G4ThreeVector &p) const
+{
+    G4double lSafety = kInfinity;
+    for (const Piece &lPiece : mPieces)
+    {
+        G4double lPieceSafety = -kInfinity;
+        for (const Constraint &lConstraint : lPiece.Constraints) lPieceSafety = std::max(lPieceSafety, Distance(lConstraint, p, true));
+        lSafety = std::min(lSafety, lPieceSafety);
+    }
+    return std::max(lSafety, 0.);
+}
+
+/**
+ * The intervals of all pieces along the ray are merged, starting at p, until the ray leaves the union.
+ */
+G4double OMSimRevolvedSolid::DistanceToOut(const G4ThreeVector &p, const G4ThreeVector &v, const G4bool calcNorm, G4bool *validNorm, G4ThreeVector *n) const
+{
+    G4double lEnter[gMaxPieces], lExit[gMaxPieces];
+    const Constraint *lExitConstraints[gMaxPieces];
+    G4bool lHit[gMaxPieces];
+    for (size_t i = 0; i < mPieces.size(); i++) lHit[i] = Interval(mPieces[i], p, v, lEnter[i], lExit[i], lExitConstraints[i]);
+
+    G4double lDistance = 0;
+    const Constraint *lExitConstraint = nullptr;
+    G4bool lExtended = true;
+    while (lExtended)
+    {
+        lExtended = false;
+        for (size_t i = 0; i < mPieces.size(); i++)
+        {
+            if (!lHit[i] || lEnter[i] > lDistance + mHalfTolerance || lExit[i] <= lDistance + mHalfTolerance) continue;
+            lDistance = lExit[i];
+            lExitConstraint = lExitConstraints[i];
+            lExtended = true;
+        }
+    }
+
+    if (calcNorm)
+    {
+        // a single piece is convex
+        if (validNorm) *validNorm = mPieces.size() == 1 && lExitConstraint;
+        if (n) *n = lExitConstraint ? Normal(*lExitConstraint, p + lDistance * v) : SurfaceNormal(p);
+    }
+    return lDistance;
+}
+
+G4double OMSimRevolvedSolid::DistanceToOut(const G4ThreeVector &p) const
+{
+    G4double lSafety = 0;
+    for (const Piece &lPiece : mPieces)
+    {
+        G4double lPieceSafety = -kInfinity;
+        for (const Constraint &lConstraint : lPiece.Constraints) lPieceSafety = std::max(lPieceSafety, Distance(lConstraint, p, true));
+        lSafety = std::max(lSafety, -lPieceSafety);
+    }
+    return lSafety;
+}
+
+void OMSimRevolvedSolid::BoundingLimits(G4ThreeVector &pMin, G4ThreeVector &pMax) const
+{
+    G4double lRadius = 0;
+    G4double lZMin = kInfinity;
+    G4double lZMax = -kInfinity;
+    for (const Piece &lPiece : mPieces)
+    {
+        lRadius = std::max(lRadius, lPiece.Radius);
+        lZMin = std::min(lZMin, lPiece.ZMin);
+        lZMax = std::max(lZMax, lPiece.ZMax);
+    }
+    if (mPieces.empty()) lZMin = lZMax = 0;
+    pMin.set(-lRadius, -lRadius, lZMin);
+    pMax.set(lRadius, lRadius, lZMax);
+}
+
+G4bool OMSimRevolvedSolid::CalculateExtent(const EAxis pAxis, const G4VoxelLimits &pVoxelLimit, const G4AffineTransform &pTransform, G4double &pMin, G4double &pMax) const
+{
+    G4ThreeVector lMin, lMax;
+    BoundingLimits(lMin, lMax);
+    G4BoundingEnvelope lBox(lMin, lMax);
+    return lBox.CalculateExtent(pAxis, pVoxelLimit, pTransform, pMin, pMax);
+}
+
+std::ostream &OMSimRevolvedSolid::StreamInfo(std::ostream &os) const
+{
+    os << "-----------------------------------------------------------\n"
+       << "    *** Dump for solid - " << GetName() << " ***\n"
+       << "    ===================================================\n"
+       << " Solid type: " << GetEntityType() << "\n"
+       << " Pieces: " << mPieces.size() << "\n";
+    for (const Piece &lPiece : mPieces)
+        os << "    " << lPiece.Constraints.size() << " constraints, rho <= " << lPiece.Radius / mm << " mm, " << lPiece.ZMin / mm << " mm <= z <= " << lPiece.ZMax / mm << " mm\n";
+    os << "-----------------------------------------------------------\n";
+    return os;
+}
+
+G4ThreeVector OMSimRevolvedSolid::GetPointOnSurface() const
+{
+    return mReference ? mReference->GetPointOnSurface() : G4VSolid::GetPointOnSurface();
+}
+
+void OMSimRevolvedSolid::DescribeYourselfTo(G4VGraphicsScene &scene) const
+{
+    scene.AddSolid(*this);
+}
+
+/**
+ * Radius of the cross-section of a piece at height pZ.
+ * @return -1 if the plane z = pZ misses the piece
+ */
+G4double OMSimRevolvedSolid::Radius(const Piece &pPiece, G4double pZ) const
+{
+    if (pZ < pPiece.ZMin - mHalfTolerance || pZ > pPiece.ZMax + mHalfTolerance) return -1;
+    G4double lRadius = pPiece.Radius;
+    for (const Constraint &lConstraint : pPiece.Constraints)
+    {
+        const G4double lDz = pZ - lConstraint.Z;
+        if (lConstraint.Kind == kCone) lRadius = std::min(lRadius, lConstraint.Slope * lConstraint.Direction * lDz);
+        else if (lConstraint.Kind == kQuadric) lRadius = std::min(lRadius, std::sqrt(std::max(0., (lConstraint.Gamma - lConstraint.Beta * lDz * lDz) / lConstraint.Alpha)));
+    }
+    return lRadius;
+}
+
+/**
+ * Polyhedron of the reference solid, or without reference a polycone through the profile of the union.
+ */
+G4Polyhedron *OMSimRevolvedSolid::CreatePolyhedron() const
+{
+    if (mReference) return mReference->CreatePolyhedron();
+    if (mPieces.empty()) return nullptr;
+
+    G4ThreeVector lMin, lMax;
+    BoundingLimits(lMin, lMax);
+    std::vector<G4double> lZ;
+    for (G4int i = 0; i <= gProfileSteps; i++) lZ.push_back(lMin.z() + (lMax.z() - lMin.z()) * i / gProfileSteps);
+    for (const Piece &lPiece : mPieces)
+    {
+        lZ.push_back(lPiece.ZMin);
+        lZ.push_back(lPiece.ZMax);
+    }
+    std::sort(lZ.begin(), lZ.end());
+    lZ.erase(std::unique(lZ.begin(), lZ.end(), [this](G4double pA, G4double pB) { return pB - pA < mHalfTolerance; }), lZ.end());
+
+    std::vector<G4double> lRMin(lZ.size(), 0);
+    std::vector<G4double> lRMax(lZ.size(), 0);
+    for (size_t i = 0; i < lZ.size(); i++)
+        for (const Piece &lPiece : mPieces) lRMax[i] = std::max(lRMax[i], Radius(lPiece, lZ[i]));
+    return new G4PolyhedronPcon(0, CLHEP::twopi, (G4int)lZ.size(), lZ.data(), lRMin.data(), lRMax.data());
+}
@@ -7,12 +7,34 @@
 #include <sys/time.h>
 
 #include "OMSimAnalysisManager.hh"
+#include "OMSimTrackGuard.hh"
+#include "OMSimPhotonCulling.hh"
+#include "OMSimImportanceBiasing.hh"
+#include "OMSimNextEventEstimator.hh"
+#include "OMSimAcceptanceTable.hh"
+#include "OMSimAnalyticHits.hh"
+#include "OMSimShowerLibrary.hh"
+#include "OMSimPropagationTable.hh"
+#include "OMSimIceFastModel.hh"
+#include "OMSimPhotonCache.hh"
+#include "OMSimPhotonRecycling.hh"
+#include "OMSimModuleBounds.hh"
+#include "OMSimSteppingAction.hh"
+
+#include "G4SystemOfUnits.hh"
 #include <time.h>
 #include <sys/time.h>
 extern G4String	ghitsfilename;
 extern G4String	gHittype;
 extern OMSimAnalysisManager gAnalysisManager;
-extern G4int gcounter;
+extern G4long gcounter;
+extern G4String gGeneratorMode;
+extern G4String gAcceptanceTableFile;
+extern G4String gPropagationTableFile;
+extern G4String gShowerLibraryFile;
+extern G4bool gPhotonCacheRecord;
+extern G4String gPhotonCacheFile;
+extern G4double gPhotonCacheRadius;
 
 
 OMSimRunAction::OMSimRunAction(){}
@@ -22,7 +44,19 @@ void OMSimRunAction::BeginOfRunAction(const G4Run*)
 {
     G4cout << ":::::::::This is the beginning of Run Action::::::::" << G4endl;
     startingtime = clock() / CLOCKS_PER_SEC;
+	// the stepping action decodes the generator mode of this run once
+	const G4UserSteppingAction* lSteppingAction = G4RunManager::GetRunManager()->GetUserSteppingAction();
+	if (lSteppingAction) const_cast<OMSimSteppingAction*>(static_cast<const OMSimSteppingAction*>(lSteppingAction))->BeginOfRun();
 	gAnalysisManager.datafile.open(ghitsfilename.c_str(), std::ios::out|std::ios::app);
+	if (OMSimPhotonRecycling::GetInstance()->IsActive() && gAnalysisManager.datafile.is_open()) {
+		// hit weights are 1/K, readers need the factor to get the number of simulated photons
+		gAnalysisManager.datafile << "# oversampling factor " << OMSimPhotonRecycling::GetInstance()->GetFactor() << G4endl;
+	}
+	if (gPhotonCacheRecord && OMSimModuleBounds::GetNumberOfModules() > 0) {
+		// the cache sphere has to enclose every module the cache will be replayed into
+		const OMSimModuleBounds::Sphere& lModule = OMSimModuleBounds::GetModule(0);
+		OMSimPhotonCache::GetInstance()->OpenForWriting(gPhotonCacheFile, gPhotonCacheRadius > 0 ? gPhotonCacheRadius : lModule.Radius + 1 * cm, lModule.Center);
+	}
 
 }
 
@@ -40,6 +74,27 @@ void OMSimRunAction::EndOfRunAction(const G4Run*)
 // 	Close output data file
 gAnalysisManager.datafile.close();
 gAnalysisManager.Reset();
+OMSimTrackGuard::GetInstance()->PrintSummary();
+OMSimTrackGuard::GetInstance()->Reset();
+OMSimPhotonCulling::GetInstance()->PrintSummary();
+OMSimPhotonCulling::GetInstance()->Reset();
+OMSimImportanceBiasing::GetInstance()->PrintSummary();
+OMSimImportanceBiasing::GetInstance()->Reset();
+OMSimPhotonRecycling::GetInstance()->PrintSummary();
+OMSimPhotonRecycling::GetInstance()->Reset();
+OMSimNextEventEstimator::GetInstance()->PrintSummary();
+OMSimNextEventEstimator::GetInstance()->Reset();
+OMSimAnalyticHits::GetInstance()->PrintSummary();
+OMSimAnalyticHits::GetInstance()->Reset();
+OMSimShowerLibrary::GetInstance()->PrintSummary();
+OMSimShowerLibrary::GetInstance()->Reset();
+if (gGeneratorMode == "acceptance") OMSimAcceptanceTable::GetInstance()->Save(gAcceptanceTableFile);
+if (gGeneratorMode == "proptable") OMSimPropagationTable::GetInstance()->Save(gPropagationTableFile);
+if (gGeneratorMode == "showerbuild") OMSimShowerLibrary::GetInstance()->Save(gShowerLibraryFile);
+if (OMSimIceFastModel::GetInstance()) {
+	OMSimIceFastModel::GetInstance()->PrintValidation();
+	OMSimIceFastModel::GetInstance()->Reset();
+}
 double finishtime=clock() / CLOCKS_PER_SEC;
 G4cout << "Computation time: " << finishtime-startingtime << " seconds." << G4endl;
 }
@@ -0,0 +1,65 @@
+/** @file OMSimRunManager.cc
+ *  @brief G4RunManager with the initialisation and run phases wrapped in timeline spans.
+ *
+ *  Nothing changes in the behaviour of the base class, each phase is only forwarded inside an OMSimScopedTimer.
+ *  Physics tables are built inside RunInitialization(), so the first run shows them as its own span.
+ *
+ *  @date October 2026
+ *
+ *  @version Geant4 10.7
+ */
+
+#include "OMSimRunManager.hh"
+#include "OMSimTimeline.hh"
+
+extern G4bool gTimelinePerEvent;
+
+OMSimRunManager::OMSimRunManager() : G4RunManager()
+{
+}
+
+void OMSimRunManager::InitializeGeometry()
+{
+    OMSimScopedTimer lTimer("Geometry construction");
+    G4RunManager::InitializeGeometry();
+}
+
+void OMSimRunManager::InitializePhysics()
+{
+    OMSimScopedTimer lTimer("Physics list construction");
+    G4RunManager::InitializePhysics();
+}
+
+void OMSimRunManager::RunInitialization()
+{
+    OMSimScopedTimer lTimer("Run initialisation (physics tables)", "run");
+    G4RunManager::RunInitialization();
+}
+
+void OMSimRunManager::DoEventLoop(G4int pNumberOfEvents, const char* pMacroFile, G4int pNumberSelected)
+{
+    OMSimScopedTimer lTimer("Event loop (" + std::to_string(pNumberOfEvents) + " events)", "run");
+    G4RunManager::DoEventLoop(pNumberOfEvents, pMacroFile, pNumberSelected);
+}
+
+/**
+ * One span per event is only recorded if gTimelinePerEvent is set, large runs would otherwise produce huge traces.
+ */
+void OMSimRunManager::ProcessOneEvent(G4int pEventID)
+{
+    if (gTimelinePerEvent)
+    {
+        OMSimScopedTimer lTimer("Event " + std::to_string(pEventID), "event");
+        G4RunManager::ProcessOneEvent(pEventID);
+    }
+    else
+    {
+        G4RunManager::ProcessOneEvent(pEventID);
+    }
+}
+
+void OMSimRunManager::RunTermination()
+{
+    OMSimScopedTimer lTimer("Run termination", "run");
+    G4RunManager::RunTermination();
+}
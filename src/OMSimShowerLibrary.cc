@@ -0,0 +1,296 @@
+/** @file OMSimShowerLibrary.cc
+ *  @brief Library of pre-simulated Cherenkov emission of IBD positrons, replayed instead of tracking the cascade.
+ *
+ *  @date October 2026
+ *
+ *  @version Geant4 10.7
+ */
+
+#include "OMSimShowerLibrary.hh"
+
+#include "G4DynamicParticle.hh"
+#include "G4OpticalPhoton.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4Step.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4Track.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+
+#include "OMSimLogger.hh"
+
+extern G4int gShowersPerBin;
+
+static_assert(sizeof(OMSimShowerLibrary::Photon) == 44, "shower library photons must not contain padding");
+
+namespace
+{
+    const char gLibraryMagic[8] = {'O', 'M', 'S', 'I', 'M', 'S', 'L', '1'};
+
+    // default binning of new libraries: 2 MeV bins up to 80 MeV
+    const G4int gDefaultNrBins = 40;
+    const G4double gDefaultEMin = 0 * MeV;
+    const G4double gDefaultEMax = 80 * MeV;
+
+    // largest number of copies of a library photon: showers of much lower energy than the positron would give a few
+    // photons many correlated copies
+    const G4double gMaxEnergyRatio = 2;
+}
+
+OMSimShowerLibrary* OMSimShowerLibrary::GetInstance()
+{
+    static G4ThreadLocal OMSimShowerLibrary* lInstance = nullptr;
+    if (!lInstance) lInstance = new OMSimShowerLibrary();
+    return lInstance;
+}
+
+/**
+ * Define the energy bins of an empty library (for building).
+ * @param pShowersPerBin Number of showers kept per bin
+ */
+void OMSimShowerLibrary::SetBinning(G4int pNrBins, G4double pEMin, G4double pEMax, G4int pShowersPerBin)
+{
+    mNrBins = pNrBins;
+    mEMin = pEMin;
+    mEMax = pEMax;
+    mShowersPerBin = pShowersPerBin;
+    mShowers.assign(mNrBins, std::vector<Shower>());
+    mLoaded = false;
+}
+
+void OMSimShowerLibrary::SetDefaultBinning()
+{
+    SetBinning(gDefaultNrBins, gDefaultEMin, gDefaultEMax, gShowersPerBin);
+}
+
+/**
+ * @return Number of events needed to fill every bin of the default binning
+ */
+G4int OMSimShowerLibrary::GetDefaultNumberOfShowers()
+{
+    return gDefaultNrBins * gShowersPerBin;
+}
+
+G4int OMSimShowerLibrary::FindBin(G4double pEnergy)
+{
+    const G4int lBin = (G4int)((pEnergy - mEMin) / (mEMax - mEMin) * mNrBins);
+    return std::max(0, std::min(mNrBins - 1, lBin));
+}
+
+/**
+ * @return Random energy inside the bin
+ */
+G4double OMSimShowerLibrary::SampleEnergy(G4int pBin)
+{
+    return mEMin + (mEMax - mEMin) * (pBin + G4UniformRand()) / mNrBins;
+}
+
+/**
+ * Start recording the shower of a positron fired along +z from pVertex at time 0.
+ */
+void OMSimShowerLibrary::BeginShower(G4int pBin, G4double pEnergy, G4ThreeVector pVertex)
+{
+    mCurrentBin = pBin;
+    mVertex = pVertex;
+    mCurrent.Energy = pEnergy / MeV;
+    mCurrent.Photons.clear();
+}
+
+/**
+ * Store a new optical photon in the current shower.
+ * @return true if the photon was recorded (and is not tracked)
+ */
+G4bool OMSimShowerLibrary::RecordPhoton(const G4Track* pTrack)
+{
+    if (mCurrentBin < 0 || pTrack->GetDefinition() != G4OpticalPhoton::Definition()) return false;
+    const G4ThreeVector lPosition = pTrack->GetPosition() - mVertex;
+    const G4ThreeVector lDirection = pTrack->GetMomentumDirection();
+    const G4ThreeVector lPolarization = pTrack->GetPolarization();
+    const Photon lPhoton = {{(G4float)(lPosition.x() / mm), (G4float)(lPosition.y() / mm), (G4float)(lPosition.z() / mm)},
+                            {(G4float)lDirection.x(), (G4float)lDirection.y(), (G4float)lDirection.z()},
+                            {(G4float)lPolarization.x(), (G4float)lPolarization.y(), (G4float)lPolarization.z()},
+                            (G4float)(pTrack->GetGlobalTime() / ns),
+                            (G4float)(h_Planck * c_light / pTrack->GetKineticEnergy() / nm)};
+    mCurrent.Photons.push_back(lPhoton);
+    return true;
+}
+
+/**
+ * Add the shower of the event to its bin, unless the bin is full.
+ */
+void OMSimShowerLibrary::EndShower()
+{
+    if (mCurrentBin < 0 || mCurrentBin >= mNrBins) return;
+    if ((G4int)mShowers[mCurrentBin].size() < mShowersPerBin) mShowers[mCurrentBin].push_back(std::move(mCurrent));
+    mCurrent = Shower();
+    mCurrentBin = -1;
+}
+
+void OMSimShowerLibrary::Save(G4String pFileName)
+{
+    std::ofstream lFile(pFileName.c_str(), std::ios::binary);
+    if (!lFile.is_open())
+    {
+        error("Could not write shower library %s", pFileName.c_str());
+        return;
+    }
+    const int32_t lHeader[2] = {mNrBins, mShowersPerBin};
+    const G4double lRange[2] = {mEMin / MeV, mEMax / MeV};
+    lFile.write(gLibraryMagic, 8);
+    lFile.write((const char*)lHeader, sizeof(lHeader));
+    lFile.write((const char*)lRange, sizeof(lRange));
+    G4long lPhotons = 0;
+    for (const std::vector<Shower>& lBin : mShowers)
+    {
+        const int32_t lNrShowers = (int32_t)lBin.size();
+        lFile.write((const char*)&lNrShowers, sizeof(int32_t));
+        for (const Shower& lShower : lBin)
+        {
+            const int32_t lNrPhotons = (int32_t)lShower.Photons.size();
+            lFile.write((const char*)&lShower.Energy, sizeof(G4float));
+            lFile.write((const char*)&lNrPhotons, sizeof(int32_t));
+            lFile.write((const char*)lShower.Photons.data(), lNrPhotons * sizeof(Photon));
+            lPhotons += lNrPhotons;
+        }
+    }
+    info("Shower library with %ld photons written to %s", lPhotons, pFileName.c_str());
+}
+
+G4bool OMSimShowerLibrary::Load(G4String pFileName)
+{
+    std::ifstream lFile(pFileName.c_str(), std::ios::binary);
+    char lMagic[8];
+    int32_t lHeader[2];
+    G4double lRange[2];
+    if (!lFile.is_open() || !lFile.read(lMagic, 8) || std::memcmp(lMagic, gLibraryMagic, 8) != 0
+        || !lFile.read((char*)lHeader, sizeof(lHeader)) || !lFile.read((char*)lRange, sizeof(lRange)))
+    {
+        error("Could not read shower library %s", pFileName.c_str());
+        return false;
+    }
+    SetBinning(lHeader[0], lRange[0] * MeV, lRange[1] * MeV, lHeader[1]);
+    G4int lEmpty = 0;
+    for (std::vector<Shower>& lBin : mShowers)
+    {
+        int32_t lNrShowers = 0;
+        lFile.read((char*)&lNrShowers, sizeof(int32_t));
+        lBin.resize(std::max(0, lNrShowers));
+        for (Shower& lShower : lBin)
+        {
+            int32_t lNrPhotons = 0;
+            lFile.read((char*)&lShower.Energy, sizeof(G4float));
+            lFile.read((char*)&lNrPhotons, sizeof(int32_t));
+            lShower.Photons.resize(std::max(0, lNrPhotons));
+            lFile.read((char*)lShower.Photons.data(), lShower.Photons.size() * sizeof(Photon));
+        }
+        if (lBin.empty()) lEmpty++;
+    }
+    if (!lFile)
+    {
+        error("Shower library %s is truncated", pFileName.c_str());
+        SetBinning(0, 0, 0, 0);
+        return false;
+    }
+    if (lEmpty > 0) warning("%d energy bins of the shower library are empty, their positrons produce no light", lEmpty);
+    mLoaded = true;
+    info("Shower library %s loaded (%d bins, %.0f to %.0f MeV)", pFileName.c_str(), mNrBins, mEMin / MeV, mEMax / MeV);
+    return true;
+}
+
+/**
+ * @return Shower of the bin of pEnergy or of its neighbour bins whose energy is closest to pEnergy, nullptr if there is none
+ */
+const OMSimShowerLibrary::Shower* OMSimShowerLibrary::FindClosestShower(G4double pEnergy)
+{
+    const G4int lBin = FindBin(pEnergy);
+    const Shower* lClosest = nullptr;
+    for (G4int i = std::max(0, lBin - 1); i <= std::min(mNrBins - 1, lBin + 1); i++)
+        for (const Shower& lShower : mShowers[i])
+        {
+            if (lShower.Energy <= 0) continue;
+            if (!lClosest || std::fabs(lShower.Energy * MeV - pEnergy) < std::fabs(lClosest->Energy * MeV - pEnergy)) lClosest = &lShower;
+        }
+    return lClosest;
+}
+
+/**
+ * Replace the positron of this step by the photons of a library shower. The secondaries the positron produced in
+ * the step are removed, the photons are pushed to the secondary vector with the positron as parent.
+ * @param pStep First step of a primary positron
+ * @param pSecondaries Secondary vector of the stepping manager
+ * @return true if the positron was replaced (and has to be killed)
+ */
+G4bool OMSimShowerLibrary::ReplaceShower(const G4Step* pStep, G4TrackVector* pSecondaries)
+{
+    const G4StepPoint* lPre = pStep->GetPreStepPoint();
+    const G4double lEnergy = lPre->GetKineticEnergy();
+    const Shower* lClosest = FindClosestShower(lEnergy);
+    if (!lClosest) return false;
+    const Shower& lShower = *lClosest;
+
+    const size_t lNrCurrent = pStep->GetSecondaryInCurrentStep()->size();
+    for (size_t i = 0; i < lNrCurrent && !pSecondaries->empty(); i++)
+    {
+        delete pSecondaries->back();
+        pSecondaries->pop_back();
+    }
+
+    const G4Track* lTrack = pStep->GetTrack();
+    const G4ThreeVector lVertex = lPre->GetPosition();
+    const G4ThreeVector lAxis = lPre->GetMomentumDirection();
+    const G4double lTime = lPre->GetGlobalTime();
+    const G4double lAzimuth = twopi * G4UniformRand();
+    G4double lRatio = lEnergy / (lShower.Energy * MeV);
+    if (lRatio > gMaxEnergyRatio)
+    {
+        if (mCapped++ == 0) warning("Library shower of %.2f MeV used for a positron of %.2f MeV, photon copies capped at %.0f (light is missing)",
+                                    lShower.Energy, lEnergy / MeV, gMaxEnergyRatio);
+        lRatio = gMaxEnergyRatio;
+    }
+    auto lRotate = [&](const G4float* pVector) {
+        G4ThreeVector lVector(pVector[0], pVector[1], pVector[2]);
+        lVector.rotateZ(lAzimuth);
+        lVector.rotateUz(lAxis);
+        return lVector;
+    };
+
+    for (const Photon& lPhoton : lShower.Photons)
+    {
+        const G4int lCopies = (G4int)lRatio + (G4UniformRand() < lRatio - std::floor(lRatio) ? 1 : 0);
+        if (lCopies == 0) continue;
+        const G4ThreeVector lPosition = lVertex + lRotate(lPhoton.Position) * mm;
+        const G4ThreeVector lDirection = lRotate(lPhoton.Direction);
+        const G4ThreeVector lPolarization = lRotate(lPhoton.Polarization);
+        for (G4int i = 0; i < lCopies; i++)
+        {
+            G4DynamicParticle* lParticle = new G4DynamicParticle(G4OpticalPhoton::Definition(), lDirection, h_Planck * c_light / (lPhoton.Wavelength * nm));
+            lParticle->SetPolarization(lPolarization.x(), lPolarization.y(), lPolarization.z());
+            G4Track* lNew = new G4Track(lParticle, lTime + lPhoton.Time * ns, lPosition);
+            lNew->SetParentID(lTrack->GetTrackID());
+            pSecondaries->push_back(lNew);
+            mPhotons++;
+        }
+    }
+    mReplaced++;
+    return true;
+}
+
+void OMSimShowerLibrary::PrintSummary()
+{
+    if (mReplaced == 0) return;
+    G4cout << "::::::::::::Shower library:::::::::::" << G4endl;
+    G4cout << "Positrons replaced by library showers: " << mReplaced << " (" << mPhotons << " photons)" << G4endl;
+    if (mCapped > 0) G4cout << "Showers with copies capped at " << gMaxEnergyRatio << " per photon (light missing): " << mCapped << G4endl;
+}
+
+void OMSimShowerLibrary::Reset()
+{
+    mReplaced = 0;
+    mPhotons = 0;
+    mCapped = 0;
+}
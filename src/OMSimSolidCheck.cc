@@ -0,0 +1,97 @@
+/** @file OMSimSolidCheck.cc
+ *  @brief Comparison of two solids that should describe the same shape (exactness and navigation speed).
+ *
+ *  @date October 2026
+ *
+ *  @version Geant4 10.7
+ */
+
+#include "OMSimSolidCheck.hh"
+
+#include "G4PhysicalConstants.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4ThreeVector.hh"
+#include "G4VSolid.hh"
+#include "CLHEP/Random/MTwistEngine.h"
+
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+#include "OMSimLogger.hh"
+
+/**
+ * @param pPoints Number of sampled points
+ * @param pTolerance Largest accepted difference of the distances
+ */
+OMSimSolidCheck::Result OMSimSolidCheck::Compare(const G4VSolid* pReference, const G4VSolid* pCandidate, G4int pPoints, G4double pTolerance)
+{
+    Result lResult;
+    lResult.Points = pPoints;
+    CLHEP::MTwistEngine lEngine(20261019);
+
+    G4ThreeVector lMin, lMax;
+    pReference->BoundingLimits(lMin, lMax);
+    lMin -= G4ThreeVector(1, 1, 1) * mm;
+    lMax += G4ThreeVector(1, 1, 1) * mm;
+    std::vector<G4ThreeVector> lPoints(pPoints), lDirections(pPoints);
+    for (G4int i = 0; i < pPoints; i++)
+    {
+        lPoints[i] = G4ThreeVector(lMin.x() + lEngine.flat() * (lMax.x() - lMin.x()), lMin.y() + lEngine.flat() * (lMax.y() - lMin.y()),
+                                   lMin.z() + lEngine.flat() * (lMax.z() - lMin.z()));
+        const G4double lCos = 2 * lEngine.flat() - 1;
+        const G4double lPhi = twopi * lEngine.flat();
+        const G4double lSin = std::sqrt(1 - lCos * lCos);
+        lDirections[i] = G4ThreeVector(lSin * std::cos(lPhi), lSin * std::sin(lPhi), lCos);
+    }
+
+    // the same queries on both solids: Inside, then a distance along the ray depending on the side of the point
+    std::vector<EInside> lInside[2] = {std::vector<EInside>(pPoints), std::vector<EInside>(pPoints)};
+    std::vector<G4double> lDistance[2] = {std::vector<G4double>(pPoints), std::vector<G4double>(pPoints)};
+    const G4VSolid* lSolids[2] = {pReference, pCandidate};
+    G4double* lTimes[2] = {&lResult.ReferenceTime, &lResult.CandidateTime};
+    for (G4int s = 0; s < 2; s++)
+    {
+        const auto lStart = std::chrono::steady_clock::now();
+        for (G4int i = 0; i < pPoints; i++)
+        {
+            lInside[s][i] = lSolids[s]->Inside(lPoints[i]);
+            lDistance[s][i] = lInside[s][i] == kOutside ? lSolids[s]->DistanceToIn(lPoints[i], lDirections[i])
+                            : lInside[s][i] == kInside ? lSolids[s]->DistanceToOut(lPoints[i], lDirections[i]) : 0;
+        }
+        *lTimes[s] = std::chrono::duration<G4double>(std::chrono::steady_clock::now() - lStart).count();
+    }
+
+    for (G4int i = 0; i < pPoints; i++)
+    {
+        if (lInside[0][i] != lInside[1][i])
+        {
+            if (lInside[0][i] == kSurface || lInside[1][i] == kSurface) lResult.SurfaceMismatches++;
+            else lResult.InsideMismatches++;
+            continue;
+        }
+        const G4bool lBothInfinite = lDistance[0][i] >= kInfinity && lDistance[1][i] >= kInfinity;
+        if (!lBothInfinite && std::fabs(lDistance[0][i] - lDistance[1][i]) > pTolerance) lResult.DistanceMismatches++;
+        else if (lInside[0][i] == kInside)
+        {
+            const G4ThreeVector lExit = lPoints[i] + lDistance[0][i] * lDirections[i];
+            if ((pReference->SurfaceNormal(lExit) - pCandidate->SurfaceNormal(lExit)).mag() > 1e-5) lResult.NormalMismatches++;
+        }
+    }
+    return lResult;
+}
+
+/**
+ * Compare and print the result.
+ * @param pName Name of the shape in the printout
+ */
+OMSimSolidCheck::Result OMSimSolidCheck::CompareAndPrint(const G4VSolid* pReference, const G4VSolid* pCandidate, G4int pPoints, G4String pName, G4double pTolerance)
+{
+    const Result lResult = Compare(pReference, pCandidate, pPoints, pTolerance);
+    info("%s: %d points, %d inside/outside, %d surface, %d distance and %d normal mismatches; %.2f us per query instead of %.2f us (x%.1f)",
+         pName.c_str(), lResult.Points, lResult.InsideMismatches, lResult.SurfaceMismatches, lResult.DistanceMismatches, lResult.NormalMismatches,
+         1e6 * lResult.CandidateTime / pPoints, 1e6 * lResult.ReferenceTime / pPoints,
+         lResult.CandidateTime > 0 ? lResult.ReferenceTime / lResult.CandidateTime : 0.);
+    if (lResult.InsideMismatches > 0 || lResult.DistanceMismatches > 0 || lResult.NormalMismatches > 0) warning("%s is not equivalent to the reference solid", pName.c_str());
+    return lResult;
+}
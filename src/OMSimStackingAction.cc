@@ -0,0 +1,33 @@
+/** @file OMSimStackingAction.cc
+ *  @brief Stacking action: photon culling at creation and photon recording of the shower library.
+ *
+ *  @date October 2026
+ *
+ *  @version Geant4 10.7
+ */
+
+#include "OMSimStackingAction.hh"
+#include "OMSimPhotonCulling.hh"
+#include "OMSimShowerLibrary.hh"
+
+#include "G4Track.hh"
+
+extern G4String gGeneratorMode;
+
+OMSimStackingAction::OMSimStackingAction()
+{
+	mCulling = OMSimPhotonCulling::GetInstance();
+	mShowers = OMSimShowerLibrary::GetInstance();
+}
+
+OMSimStackingAction::~OMSimStackingAction()
+{}
+
+G4ClassificationOfNewTrack OMSimStackingAction::ClassifyNewTrack(const G4Track* aTrack)
+{
+	// shower library building: the photons of the cascade are stored, not tracked
+	if (gGeneratorMode == "showerbuild" && mShowers->RecordPhoton(aTrack)) return fKill;
+	// optical photons that can not reach any module are not tracked (see OMSimPhotonCulling)
+	if (mCulling->IsActive() && mCulling->CullAtCreation(aTrack)) return fKill;
+	return fUrgent;
+}
@@ -4,34 +4,97 @@
 #include "G4SteppingManager.hh"
 #include "G4Step.hh"
 #include "G4ThreeVector.hh"
+#include "G4Positron.hh"
 //since Geant4.10: include units manually
 #include "G4SystemOfUnits.hh"
+#include "G4PhysicalConstants.hh"
+
+#include <algorithm>
 
 #include "OMSimAnalysisManager.hh"
+#include "OMSimProbes.hh"
+#include "OMSimTrackGuard.hh"
+#include "OMSimPhotonCulling.hh"
+#include "OMSimImportanceBiasing.hh"
+#include "OMSimPhotonInfo.hh"
+#include "OMSimNextEventEstimator.hh"
+#include "OMSimIceFastModel.hh"
+#include "OMSimPropagationTable.hh"
+#include "OMSimModuleBounds.hh"
+#include "OMSimPhotonCache.hh"
+#include "OMSimPhotonRecycling.hh"
+#include "OMSimAcceptanceTable.hh"
+#include "OMSimShowerLibrary.hh"
+#include "OMSimLogger.hh"
 
 extern OMSimAnalysisManager gAnalysisManager;
 extern G4String	gHittype;
-extern G4int gcounter;
+extern G4long gcounter;
+extern G4long gBoundarySteps;
+extern G4long gPhotonTracks;
 extern G4String gQEFile;
+extern G4String gGeneratorMode;
+extern G4bool gFastSimValidation;
+extern G4bool gAcceptanceFastMode;
+extern G4String gAcceptanceTableFile;
+extern G4String gShowerLibraryFile;
 
 
 OMSimSteppingAction::OMSimSteppingAction()
 {
+    // the QE table is read once here, not for every photon reaching a photocathode
+    pmt_qe -> ReadQeTable();
+    mTrackGuard = OMSimTrackGuard::GetInstance();
+    mCulling = OMSimPhotonCulling::GetInstance();
+    mBiasing = OMSimImportanceBiasing::GetInstance();
+    mEstimator = OMSimNextEventEstimator::GetInstance();
+    mCache = OMSimPhotonCache::GetInstance();
+    mRecycling = OMSimPhotonRecycling::GetInstance();
+    mAcceptance = OMSimAcceptanceTable::GetInstance();
+    mShowers = OMSimShowerLibrary::GetInstance();
+    BeginOfRun();
+    if ( gAcceptanceFastMode && !mAcceptance->IsLoaded() && !mAcceptance->Load(gAcceptanceTableFile) ) {
+        error("Acceptance fast mode needs an acceptance table (gAcceptanceTableFile), photons are tracked into the module");
+    }
+    if ( gAcceptanceFastMode && mAcceptance->IsLoaded() ) {
+        info("Acceptance fast mode: photons outside of %.0f - %.0f nm are tracked into the module", mAcceptance->GetLambdaMin() / nm, mAcceptance->GetLambdaMax() / nm);
+    }
+}
 
+
+/**
+ * Decode the generator mode, called by the run action at the beginning of every run (table building and benchmarks
+ * change gGeneratorMode between runs).
+ */
+void OMSimSteppingAction::BeginOfRun()
+{
+    mShowerReplay = gGeneratorMode == "showerlib";
+    mPropagationTable = gGeneratorMode == "proptable";
+    mAcceptanceTable = gGeneratorMode == "acceptance";
+    if ( mShowerReplay && !mShowers->IsLoaded() && !mShowers->Load(gShowerLibraryFile) ) {
+        error("Shower library mode needs a library (gShowerLibraryFile), positrons are tracked");
+    }
 }
 
 
 void OMSimSteppingAction::UserSteppingAction(const G4Step* aStep)
 {    G4Track* aTrack = aStep->GetTrack();
 
-    //kill particles that are stuck... e.g. doing a loop in the pressure vessel
-    if ( aTrack-> GetCurrentStepNumber() > 100000) {
-        G4cout << "Particle stuck   " <<  aTrack->GetDefinition()->GetParticleName()  << " " << 1239.84193/(aTrack->GetKineticEnergy()/eV)<< G4endl;
+    //kill particles that are stuck... e.g. doing a loop in the pressure vessel (budgets per volume, see OMSimTrackGuard)
+    if ( mTrackGuard->IsStuck(aStep) ) {
         // gAnalysisManager.infiniteLoop = true;
         //gAnalysisManager.SaveThisEvent = true;
         if ( aTrack->GetTrackStatus() != fStopAndKill ) {
             aTrack->SetTrackStatus(fStopAndKill);
         }
+    }
+    // shower library: primary positrons are replaced by the photons of a pre-simulated cascade
+    if ( mShowerReplay && aTrack->GetParentID() == 0 && aTrack->GetCurrentStepNumber() == 1 && mShowers->IsLoaded()
+         && aTrack->GetDefinition() == G4Positron::Definition() ) {
+        if ( mShowers->ReplaceShower(aStep, fpSteppingManager->GetfSecondary()) ) {
+            aTrack->SetTrackStatus(fStopAndKill);
+            return;
+        }
     }
         //just to find the source of the weird positrons!
         /*if(aTrack -> GetDefinition() -> GetParticleName() == "e+")
@@ -52,6 +115,63 @@ void OMSimSteppingAction::UserSteppingAction(const G4Step* aStep)
     //	Check if optical photon is about to hit a photocathode, if so, destroy it and save the hit
     if ( aTrack->GetDefinition()->GetParticleName() == "opticalphoton" ) {
         gcounter ++;
+        if ( aStep->GetPostStepPoint()->GetStepStatus() == fGeomBoundary ) gBoundarySteps++;
+        if ( aTrack->GetCurrentStepNumber() == 1 ) gPhotonTracks++;
+#if OMSIM_PROBES_ENABLED
+        if (aTrack->GetCurrentStepNumber() == 1) {
+            OMSIM_PROBE2(photon_created, aTrack->GetTrackID(), (long)(1239.84193e3 / (aTrack->GetKineticEnergy() / eV)));
+        }
+#endif
+        // photons scattered beyond the horizon of every module are not tracked further (see OMSimPhotonCulling)
+        if ( mCulling->IsActive() && mCulling->CullAfterStep(aStep) ) {
+            aTrack->SetTrackStatus(fStopAndKill);
+        }
+        // first stage of a two-stage simulation: store photons entering the cache sphere, stop those whose step ends inside
+        if ( mCache->IsRecording() && aTrack->GetTrackStatus() != fStopAndKill && mCache->RecordCrossing(aStep) ) {
+            aTrack->SetTrackStatus(fStopAndKill);
+        }
+        // arrivals on the inner sphere of the ice envelope: propagation table building and fast simulation validation
+        if ( (mPropagationTable || gFastSimValidation) && OMSimIceFastModel::IsInnerSphereArrival(aStep) ) {
+            if ( mPropagationTable ) {
+                const G4ThreeVector lCenter = OMSimModuleBounds::GetNumberOfModules() > 0 ? OMSimModuleBounds::GetModule(0).Center : G4ThreeVector();
+                if ( (aStep->GetPostStepPoint()->GetPosition() - lCenter).dot(aTrack->GetMomentumDirection()) < 0 ) {
+                    OMSimPropagationTable::GetInstance()->RecordArrival(aStep, lCenter);
+                    aTrack->SetTrackStatus(fStopAndKill);
+                }
+            }
+            else if ( OMSimIceFastModel::GetInstance() ) OMSimIceFastModel::GetInstance()->RecordValidationArrival(aStep);
+        }
+        // expected hits from the next flight of photons scattered in the ice
+        if ( mEstimator->IsActive() ) mEstimator->ScoreStep(aStep);
+        // splitting / Russian roulette on the importance shells around the modules
+        if ( mBiasing->IsActive() && aTrack->GetTrackStatus() != fStopAndKill ) {
+            mBiasing->Apply(aStep, fpSteppingManager->GetfSecondary());
+        }
+        // parametric fast mode: photons reaching a module are replaced by hits drawn from the acceptance table
+        if ( gAcceptanceFastMode && mAcceptance->IsLoaded() && aTrack->GetTrackStatus() != fStopAndKill && OMSimModuleBounds::IsBulkIce(aStep->GetPreStepPoint()->GetPhysicalVolume()) ) {
+            // every photon crossing a bounding sphere is sampled and killed, also those that would pass the module: the
+            // table probabilities are per photon crossing the sphere. Photons outside of the bins of the table (wavelength
+            // range) are tracked into the module.
+            G4ThreeVector lCrossing;
+            G4double lFraction;
+            const G4int lModule = OMSimModuleBounds::FirstEnteredModule(aStep, lCrossing, lFraction);
+            const G4ThreeVector lDirection = aStep->GetPreStepPoint()->GetMomentumDirection();
+            const G4int lBin = lModule >= 0 ? mAcceptance->FindBin(lDirection, h_Planck * c_light / aTrack->GetKineticEnergy()) : -1;
+            const G4int lImpact = lBin >= 0 ? mAcceptance->FindImpactBin(lDirection, lCrossing - OMSimModuleBounds::GetModule(lModule).Center) : -1;
+            if ( lImpact >= 0 ) {
+                const G4int lPMT = mAcceptance->SamplePMT(lBin, lImpact);
+                if ( lPMT >= 0 ) {
+                    // time of arrival at the bounding sphere, the transit time inside the module is not tabulated
+                    const G4double lPreTime = aStep->GetPreStepPoint()->GetGlobalTime();
+                    gAnalysisManager.AddHit(lPMT, lModule, aTrack, lCrossing, lPreTime + lFraction * (aStep->GetPostStepPoint()->GetGlobalTime() - lPreTime));
+                }
+                aTrack->SetTrackStatus(fStopAndKill);
+            }
+        }
+        // oversampling of photons reaching a module, rotated about its axis
+        if ( mRecycling->IsActive() && aTrack->GetTrackStatus() != fStopAndKill && OMSimModuleBounds::IsBulkIce(aStep->GetPreStepPoint()->GetPhysicalVolume()) ) {
+            mRecycling->Apply(aStep, fpSteppingManager->GetfSecondary());
+        }
 
         //G4cout << "++++++++++ I CAN IDENTIFY OPTICAL PHOTONS! ++++++++++" << G4endl;
         if ( aTrack->GetTrackStatus() != fStopAndKill ) {
@@ -62,12 +182,8 @@ void OMSimSteppingAction::UserSteppingAction(const G4Step* aStep)
 
             if ( aStep->GetPostStepPoint()->GetMaterial()->GetName() == "RiAbs_Photocathode") {
 
-                G4ThreeVector vertex_pos;
-                vertex_pos = aTrack -> GetVertexPosition();
-
            //G4cout << "+++++++++++++++++++ I HIT A PHOTO CATHODE! +++++++++++" << G4endl;
                 G4double Ekin;
-                G4double t1, t2;
                 //G4Track* aTrack = aStep->GetTrack();
 
                // G4double h = 4.136E-15*eV*s;
@@ -77,16 +193,17 @@ void OMSimSteppingAction::UserSteppingAction(const G4Step* aStep)
 
                 Ekin = aTrack->GetKineticEnergy() ;
                 lambda = (hc/Ekin) * nm;
+                OMSIM_PROBE2(photocathode_hit, aTrack->GetTrackID(), (long)(lambda / (1e-3 * nm)));
                 //std::cout << "Lambda : " << lambda / nm<< std::endl;
-                pmt_qe -> ReadQeTable();
                 double qe = (pmt_qe -> GetQe(lambda)) / 100;
                 //double random = pmt_qe -> RandomGen();
                 double random = CLHEP::RandFlat::shoot(0.0, 1.0);
-                std::cout << "++++++++++QE : " << qe << "++++" << std::endl;
+                diag(1000, "QE : %f", qe);
                 bool survived = (random < (qe)) ? true : false;
+                OMSIM_PROBE2(qe_decision, aTrack->GetTrackID(), (int)survived);
                 if(survived) ///taking QE into consideration
                 {
-                std::cout << "+++++++++++++I Survived!! ++++++++++" << std::endl;
+                diag(1000, "Photon detected by QE check");
 
 
 
@@ -94,30 +211,18 @@ void OMSimSteppingAction::UserSteppingAction(const G4Step* aStep)
                 //G4cout << "+++++++++++++++++++ I HIT A PHOTO CATHODE! +++++++++++" << G4endl;
                 std::vector<G4String> n;
                 extern std::vector<G4String> explode (G4String s, char d);
-                G4ThreeVector deltapos;
 
 
                 n = explode(aStep->GetPreStepPoint()->GetPhysicalVolume()->GetName(),'_');
-                gAnalysisManager.stats_PMT_hit.push_back(atoi(n.at(1)));
+                G4int lPMT = atoi(n.at(1));
+                // the module logical volumes are shared, the module is identified by the copy number of its placement
+                const G4int lModule = std::max(0, OMSimModuleBounds::GetModuleID(aStep->GetPreStepPoint()->GetTouchable()));
+                gAnalysisManager.AddHit(lPMT, lModule, aTrack, aTrack->GetPosition(), aTrack->GetGlobalTime());
+                if ( mCulling->IsActive() ) mCulling->CountHit(aTrack);
+                if ( mEstimator->IsActive() ) mEstimator->CountHit(aTrack, lPMT);
+                if ( mAcceptanceTable ) mAcceptance->AddHit(aTrack, lPMT, OMSimModuleBounds::GetModule(lModule).Center);
                 //G4cout << "+++++++++++++ The Fuck Is " << atoi(n.at(1)) << " ++++++++" << G4endl;
 
-                if (gHittype == "individual") {
-                    deltapos = aTrack->GetVertexPosition() - aTrack->GetPosition();
-                    t1 = aTrack->GetGlobalTime() /ns;
-                    t2 = aTrack->GetLocalTime();
-                    Ekin = aTrack->GetKineticEnergy();
-                    gAnalysisManager.stats_photon_direction.push_back(aTrack->GetMomentumDirection());
-                    gAnalysisManager.stats_photon_position.push_back(aTrack->GetPosition());
-                    gAnalysisManager.stats_event_id.push_back(gAnalysisManager.current_event_id);
-                    gAnalysisManager.stats_photon_flight_time.push_back(t2);
-                    gAnalysisManager.stats_photon_track_length.push_back(aTrack->GetTrackLength()/m);
-                    gAnalysisManager.stats_hit_time.push_back(t1);
-                    gAnalysisManager.stats_photon_energy.push_back(Ekin/eV);
-                    gAnalysisManager.stats_event_distance.push_back(deltapos.mag()/m);
-                    gAnalysisManager.stats_vertex_position.push_back(vertex_pos);
-                    gAnalysisManager.stats_positron_id.push_back(aTrack -> GetParentID());
-                }
-
                 aTrack->SetTrackStatus(fStopAndKill);
                } 		// kills counted photon to prevent scattering and double-counting
             }
@@ -0,0 +1,136 @@
+/** @file OMSimTimeline.cc
+ *  @brief Wall-clock spans written as a Chrome trace-format JSON file.
+ *
+ *  @date October 2026
+ *
+ *  @version Geant4 10.7
+ */
+
+#include "OMSimTimeline.hh"
+#include "OMSimLogger.hh"
+
+#include "G4AutoLock.hh"
+
+#include <algorithm>
+#include <fstream>
+
+namespace
+{
+    G4Mutex gTimelineMutex = G4MUTEX_INITIALIZER;
+
+    /**
+     * Escape a span name so it can be written as a JSON string.
+     */
+    G4String JSONEscape(const G4String& pText)
+    {
+        G4String lOut;
+        for (char c : pText)
+        {
+            if (c == '"' || c == '\\') lOut += '\\';
+            if (c == '\n') { lOut += "\\n"; continue; }
+            lOut += c;
+        }
+        return lOut;
+    }
+}
+
+OMSimTimeline* OMSimTimeline::GetInstance()
+{
+    static OMSimTimeline lInstance;
+    return &lInstance;
+}
+
+/**
+ * Start recording spans. Times of all spans are given relative to this call.
+ * @param pFileName Output file, written when Close() is called
+ */
+void OMSimTimeline::Open(G4String pFileName)
+{
+    G4AutoLock lLock(&gTimelineMutex);
+    mFileName = pFileName;
+    mOrigin = std::chrono::steady_clock::now();
+    mSpans.clear();
+    mThreads.clear();
+    mActive = true;
+}
+
+/**
+ * @return Microseconds since Open()
+ */
+G4double OMSimTimeline::Now()
+{
+    return std::chrono::duration<G4double, std::micro>(std::chrono::steady_clock::now() - mOrigin).count();
+}
+
+/**
+ * Store a finished span. Thread safe, spans of worker threads go to their own track.
+ * @param pName Name shown in the trace viewer
+ * @param pCategory Category of the span (init, run, event...)
+ * @param pStart Start time in microseconds (see Now())
+ * @param pDuration Duration in microseconds
+ */
+void OMSimTimeline::AddSpan(const G4String& pName, const G4String& pCategory, G4double pStart, G4double pDuration)
+{
+    if (!mActive) return;
+    G4int lThread = G4Threading::G4GetThreadId() + 1; // master/sequential is -1
+    G4AutoLock lLock(&gTimelineMutex);
+    if (!mActive) return; // closed meanwhile
+    mSpans.push_back({pName, pCategory, pStart, pDuration, lThread});
+    if (std::find(mThreads.begin(), mThreads.end(), lThread) == mThreads.end()) mThreads.push_back(lThread);
+}
+
+/**
+ * Write all spans to the output file and stop recording.
+ */
+void OMSimTimeline::Close()
+{
+    G4AutoLock lLock(&gTimelineMutex);
+    if (!mActive) return;
+    mActive = false;
+
+    std::ofstream lFile(mFileName.c_str());
+    if (!lFile.is_open())
+    {
+        error("Could not open timeline file %s", mFileName.c_str());
+        return;
+    }
+    lFile << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[" << std::endl;
+    G4bool lFirst = true;
+    for (G4int lThread : mThreads)
+    {
+        if (!lFirst) lFile << "," << std::endl;
+        lFirst = false;
+        lFile << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << lThread
+              << ",\"args\":{\"name\":\"" << (lThread == 0 ? std::string("master") : "worker " + std::to_string(lThread - 1)) << "\"}}";
+    }
+    lFile << std::fixed;
+    lFile.precision(3);
+    for (const Span& lSpan : mSpans)
+    {
+        if (!lFirst) lFile << "," << std::endl;
+        lFirst = false;
+        lFile << "{\"name\":\"" << JSONEscape(lSpan.Name) << "\",\"cat\":\"" << JSONEscape(lSpan.Category)
+              << "\",\"ph\":\"X\",\"ts\":" << lSpan.Start << ",\"dur\":" << lSpan.Duration
+              << ",\"pid\":0,\"tid\":" << lSpan.ThreadID << "}";
+    }
+    lFile << std::endl << "]}" << std::endl;
+    lFile.close();
+    G4cout << "Timeline with " << mSpans.size() << " spans written to " << mFileName << G4endl;
+    mSpans.clear();
+}
+
+OMSimScopedTimer::OMSimScopedTimer(const G4String& pName, const G4String& pCategory)
+{
+    mActive = OMSimTimeline::GetInstance()->IsActive();
+    if (!mActive) return;
+    mName = pName;
+    mCategory = pCategory;
+    mStart = OMSimTimeline::GetInstance()->Now();
+}
+
+OMSimScopedTimer::~OMSimScopedTimer()
+{
+    if (!mActive) return;
+    OMSimTimeline* lTimeline = OMSimTimeline::GetInstance();
+    lTimeline->AddSpan(mName, mCategory, mStart, lTimeline->Now() - mStart);
+}
@@ -0,0 +1,213 @@
+/** @file OMSimTrackGuard.cc
+ *  @brief Step and path-length budgets against looping tracks, with counters of the killed tracks per volume.
+ *
+ *  @date October 2026
+ *
+ *  @version Geant4 10.7
+ */
+
+#include "OMSimTrackGuard.hh"
+#include "OMSimInputData.hh"
+
+#include "G4LogicalVolume.hh"
+#include "G4OpBoundaryProcess.hh"
+#include "G4OpticalPhoton.hh"
+#include "G4ProcessManager.hh"
+#include "G4Step.hh"
+#include "G4Track.hh"
+#include "G4UnitsTable.hh"
+#include "G4VPhysicalVolume.hh"
+
+#include <iomanip>
+
+#include "OMSimLogger.hh"
+
+extern G4String gTrackBudgetFile;
+
+OMSimTrackGuard* OMSimTrackGuard::GetInstance()
+{
+    static G4ThreadLocal OMSimTrackGuard* lInstance = nullptr;
+    if (!lInstance) lInstance = new OMSimTrackGuard();
+    return lInstance;
+}
+
+OMSimTrackGuard::OMSimTrackGuard()
+{
+    if (gTrackBudgetFile != "") LoadBudgets(gTrackBudgetFile);
+}
+
+/**
+ * Read step, path and total internal reflection budgets from a json file. Example:
+ *
+ *     {"jName": "TrackBudgets",
+ *      "jMaxTotalSteps": 100000,
+ *      "jDefault": {"jMaxSteps": 100000, "jMaxPathLength": {"jValue": 1, "jUnit": "km"}, "jMaxTIR": 500},
+ *      "jVolumes": {"Glass_log": {"jMaxSteps": 2000, "jMaxPathLength": {"jValue": 5, "jUnit": "m"}, "jMaxTIR": 200}}}
+ *
+ * Volumes are identified by the name of their logical volume. Missing values fall back to jDefault.
+ * @param pFileName json file
+ */
+void OMSimTrackGuard::LoadBudgets(G4String pFileName)
+{
+    ParameterTable lTable;
+    lTable.AppendParameterTable(pFileName);
+    const G4String lKey = lTable.mTable.begin()->first;
+    pt::ptree& lTree = lTable.mTable.at(lKey);
+
+    auto lRead = [&](const G4String& pPath, const Budget& pFallback) {
+        Budget lBudget = pFallback;
+        if (lTree.get_child_optional(pPath + ".jMaxSteps")) lBudget.MaxSteps = (G4long)lTable.GetValue(lKey, pPath + ".jMaxSteps");
+        if (lTree.get_child_optional(pPath + ".jMaxPathLength")) lBudget.MaxPathLength = lTable.GetValue(lKey, pPath + ".jMaxPathLength");
+        if (lTree.get_child_optional(pPath + ".jMaxTIR")) lBudget.MaxTIR = (G4long)lTable.GetValue(lKey, pPath + ".jMaxTIR");
+        return lBudget;
+    };
+
+    if (lTree.get_child_optional("jMaxTotalSteps")) mMaxTotalSteps = (G4long)lTable.GetValue(lKey, "jMaxTotalSteps");
+    if (lTree.get_child_optional("jDefault")) mDefaultBudget = lRead("jDefault", mDefaultBudget);
+
+    mVolumeBudgets.clear();
+    if (auto lVolumes = lTree.get_child_optional("jVolumes"))
+    {
+        for (auto& lVolume : *lVolumes)
+        {
+            // volume names may contain dots, so the children are read directly instead of through GetValue paths
+            Budget lBudget = mDefaultBudget;
+            const pt::ptree& lSub = lVolume.second;
+            auto lGet = [&](const char* pParam) {
+                const pt::ptree& lNode = lSub.get_child(pParam);
+                if (lNode.get_child_optional("jValue"))
+                {
+                    const G4double lValue = lNode.get<G4double>("jValue");
+                    const G4String lUnit = lNode.get<G4String>("jUnit", "NULL");
+                    return lUnit == "NULL" ? lValue : lValue * G4UnitDefinition::GetValueOf(lUnit);
+                }
+                return lNode.get_value<G4double>();
+            };
+            if (lSub.get_child_optional("jMaxSteps")) lBudget.MaxSteps = (G4long)lGet("jMaxSteps");
+            if (lSub.get_child_optional("jMaxPathLength")) lBudget.MaxPathLength = lGet("jMaxPathLength");
+            if (lSub.get_child_optional("jMaxTIR")) lBudget.MaxTIR = (G4long)lGet("jMaxTIR");
+            mVolumeBudgets[lVolume.first] = lBudget;
+        }
+    }
+    G4String mssg = "Track budgets loaded from " + pFileName + " (" + std::to_string(mVolumeBudgets.size()) + " volumes with own budget)";
+    info("%s", mssg.c_str());
+}
+
+const OMSimTrackGuard::Budget& OMSimTrackGuard::GetBudget(const G4String& pVolume)
+{
+    auto lFound = mVolumeBudgets.find(pVolume);
+    if (lFound != mVolumeBudgets.end()) return lFound->second;
+    return mDefaultBudget;
+}
+
+/**
+ * The boundary process of optical photons is looked up once, its status tells us if the last step ended in a total internal reflection.
+ */
+G4OpBoundaryProcess* OMSimTrackGuard::FindBoundaryProcess()
+{
+    mBoundarySearched = true;
+    G4ProcessManager* lManager = G4OpticalPhoton::Definition()->GetProcessManager();
+    if (!lManager) return nullptr;
+    G4ProcessVector* lProcesses = lManager->GetProcessList();
+    for (G4int i = 0; i < (G4int)lProcesses->size(); i++)
+    {
+        if ((*lProcesses)[i]->GetProcessName() == "OpBoundary") return (G4OpBoundaryProcess*)(*lProcesses)[i];
+    }
+    warning("OpBoundary process not found, total internal reflection loops will not be detected");
+    return nullptr;
+}
+
+void OMSimTrackGuard::Kill(const G4String& pVolume, G4long KillCounter::*pReason, G4long pSteps)
+{
+    KillCounter& lCounter = mKilled[pVolume];
+    lCounter.*pReason += 1;
+    lCounter.WastedSteps += pSteps;
+    diag(100, "Track stuck in %s after %ld steps", pVolume.c_str(), pSteps);
+}
+
+/**
+ * Update the state of the current track with this step and check it against the budgets.
+ * Cost per step is a few comparisons; the budget is only looked up when the track enters another volume.
+ * @param pStep current step
+ * @return true if the track should be killed
+ */
+G4bool OMSimTrackGuard::IsStuck(const G4Step* pStep)
+{
+    G4Track* lTrack = pStep->GetTrack();
+    G4LogicalVolume* lVolume = pStep->GetPreStepPoint()->GetPhysicalVolume()->GetLogicalVolume();
+    const G4int lStepNumber = lTrack->GetCurrentStepNumber();
+
+    if (lStepNumber == 1 || lTrack->GetTrackID() != mTrackID)
+    {
+        mTrackID = lTrack->GetTrackID();
+        mCurrentVolume = nullptr;
+        mConsecutiveTIR = 0;
+    }
+    if (lVolume != mCurrentVolume)
+    {
+        mCurrentVolume = lVolume;
+        mCurrentBudget = mVolumeBudgets.empty() ? &mDefaultBudget : &GetBudget(lVolume->GetName());
+        mVolumeSteps = 0;
+        mVolumePath = 0;
+    }
+    mVolumeSteps++;
+    mVolumePath += pStep->GetStepLength();
+
+    if (lStepNumber > mMaxTotalSteps)
+    {
+        Kill(lVolume->GetName(), &KillCounter::Total, lStepNumber);
+        return true;
+    }
+
+    const Budget& lBudget = *mCurrentBudget;
+    if (mVolumeSteps > lBudget.MaxSteps)
+    {
+        Kill(lVolume->GetName(), &KillCounter::Steps, lStepNumber);
+        return true;
+    }
+    if (mVolumePath > lBudget.MaxPathLength)
+    {
+        Kill(lVolume->GetName(), &KillCounter::Path, lStepNumber);
+        return true;
+    }
+
+    if (lTrack->GetDefinition() == G4OpticalPhoton::Definition())
+    {
+        if (!mBoundarySearched) mBoundaryProcess = FindBoundaryProcess();
+        if (mBoundaryProcess)
+        {
+            const G4OpBoundaryProcessStatus lStatus = mBoundaryProcess->GetStatus();
+            if (lStatus == TotalInternalReflection) mConsecutiveTIR++;
+            else if (lStatus != NotAtBoundary && lStatus != StepTooSmall && lStatus != Undefined) mConsecutiveTIR = 0;
+
+            if (mConsecutiveTIR > lBudget.MaxTIR)
+            {
+                Kill(lVolume->GetName(), &KillCounter::TIR, lStepNumber);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * Print the killed tracks of the run per logical volume.
+ */
+void OMSimTrackGuard::PrintSummary()
+{
+    if (mKilled.empty()) return;
+    G4cout << "::::::::::::Tracks killed as stuck (per volume):::::::::::" << G4endl;
+    G4cout << std::setw(30) << "volume" << std::setw(10) << "steps" << std::setw(10) << "path" << std::setw(10) << "TIR"
+           << std::setw(10) << "total" << std::setw(16) << "wasted steps" << G4endl;
+    for (auto& lEntry : mKilled)
+    {
+        const KillCounter& c = lEntry.second;
+        G4cout << std::setw(30) << lEntry.first << std::setw(10) << c.Steps << std::setw(10) << c.Path << std::setw(10) << c.TIR
+               << std::setw(10) << c.Total << std::setw(16) << c.WastedSteps << G4endl;
+    }
+}
+
+void OMSimTrackGuard::Reset()
+{
+    mKilled.clear();
+}
@@ -4,6 +4,9 @@
 #include "G4TrackingManager.hh"
 #include "G4Track.hh"
 #include "G4ThreeVector.hh"
+#include "G4PrimaryParticle.hh"
+
+#include "OMSimPhotonInfo.hh"
 
 
 OMSimTrackingAction::OMSimTrackingAction()
@@ -17,6 +20,16 @@ OMSimTrackingAction::~OMSimTrackingAction()
 
 void OMSimTrackingAction::PreUserTrackingAction(const G4Track* aTrack)
 {
+    // photons injected as primaries keep the ancestry they had in the run that produced them
+    if (aTrack->GetParentID() == 0 && !aTrack->GetUserInformation()) {
+        G4PrimaryParticle* lPrimary = aTrack->GetDynamicParticle()->GetPrimaryParticle();
+        OMSimPrimaryPhotonInfo* lPrimaryInfo = lPrimary ? dynamic_cast<OMSimPrimaryPhotonInfo*>(lPrimary->GetUserInformation()) : nullptr;
+        if (lPrimaryInfo) {
+            OMSimPhotonInfo* lInfo = new OMSimPhotonInfo(lPrimaryInfo->VertexPosition);
+            lInfo->AncestorID = lPrimaryInfo->AncestorID;
+            const_cast<G4Track*>(aTrack)->SetUserInformation(lInfo);
+        }
+    }
 }
 
 void OMSimTrackingAction::PostUserTrackingAction(const G4Track* aTrack)
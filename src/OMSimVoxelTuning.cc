@@ -0,0 +1,198 @@
+/** @file OMSimVoxelTuning.cc
+ *  @brief Smartless and voxelisation settings of the dense logical volumes of the optical modules.
+ *
+ *  @date October 2026
+ *
+ *  @version Geant4 10.7
+ */
+
+#include "OMSimVoxelTuning.hh"
+#include "OMSimInputData.hh"
+#include "abcDetectorComponent.hh"
+
+#include "G4LogicalVolume.hh"
+#include "voxeldefs.hh"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include "OMSimLogger.hh"
+
+OMSimInputData* OMSimVoxelTuning::mData = nullptr;
+G4String OMSimVoxelTuning::mKey = "";
+std::vector<G4LogicalVolume*> OMSimVoxelTuning::mVolumes;
+
+/**
+ * Remember a constructed module for Apply(), GetDenseVolumes() and Record().
+ * @param pData input data the module was built from
+ * @param pModule module, its json table is GetDataKey() ("" for modules without json file: pDOM, custom)
+ */
+void OMSimVoxelTuning::SetModule(OMSimInputData* pData, abcDetectorComponent* pModule)
+{
+    mData = pData;
+    mKey = pModule ? pModule->GetDataKey() : "";
+    mVolumes = pModule ? pModule->GetLogicalVolumes() : std::vector<G4LogicalVolume*>();
+}
+
+/**
+ * Apply the settings of jVoxelTuning in the json table of the module to its logical volumes of the same name. Has to be
+ * called after SetModule() and before the geometry is closed (voxelised).
+ */
+void OMSimVoxelTuning::Apply()
+{
+    if (mKey == "" || !mData->CheckIfKeyInTable(mKey)) return;
+    boost::optional<pt::ptree&> lTuning = mData->mTable.at(mKey).get_child_optional("jVoxelTuning");
+    if (!lTuning) return;
+
+    G4int lApplied = 0;
+    for (auto& lEntry : *lTuning)
+    {
+        Setting lSetting;
+        lSetting.Smartless = lEntry.second.get<G4double>("jSmartless", kSmartless);
+        lSetting.Optimise = lEntry.second.get<G4int>("jOptimise", 1) != 0;
+        G4int lFound = 0;
+        for (G4LogicalVolume* lVolume : mVolumes)
+        {
+            if (lVolume->GetName() != lEntry.first) continue;
+            Set(lVolume, lSetting);
+            lFound++;
+        }
+        if (lFound == 0) warning("Volume \"%s\" of the voxel tuning of %s not found in the module", lEntry.first.c_str(), mKey.c_str());
+        lApplied += lFound;
+    }
+    info("Voxel tuning of %s applied to %d logical volumes", mKey.c_str(), lApplied);
+}
+
+/**
+ * Logical volumes of the module with many daughters, for which the voxelisation matters. Volumes without name or whose
+ * name is not unique within the module are left out, their settings could not be told apart in the json file.
+ * @param pMinDaughters smallest number of daughters
+ * @return volumes, ordered as in abcDetectorComponent::GetLogicalVolumes()
+ */
+std::vector<G4LogicalVolume*> OMSimVoxelTuning::GetDenseVolumes(G4int pMinDaughters)
+{
+    std::vector<G4LogicalVolume*> lVolumes;
+    for (G4LogicalVolume* lVolume : mVolumes)
+    {
+        if (lVolume->GetName() == "" || (G4int)lVolume->GetNoDaughters() < pMinDaughters) continue;
+        const G4String lName = lVolume->GetName();
+        if (std::count_if(mVolumes.begin(), mVolumes.end(), [&lName](G4LogicalVolume* pOther) { return pOther->GetName() == lName; }) > 1)
+        {
+            warning("Volume name \"%s\" is not unique in %s, the volume is not tuned", lName.c_str(), mKey.c_str());
+            continue;
+        }
+        lVolumes.push_back(lVolume);
+    }
+    return lVolumes;
+}
+
+/**
+ * Current setting of a logical volume.
+ */
+OMSimVoxelTuning::Setting OMSimVoxelTuning::Get(const G4LogicalVolume* pVolume)
+{
+    Setting lSetting;
+    lSetting.Smartless = pVolume->GetSmartless();
+    lSetting.Optimise = pVolume->IsToOptimise();
+    return lSetting;
+}
+
+/**
+ * Set the voxelisation of a logical volume. The geometry has to be reoptimised for it to take effect (closed again,
+ * e.g. by G4RunManager::GeometryHasBeenModified and a new run).
+ */
+void OMSimVoxelTuning::Set(G4LogicalVolume* pVolume, const Setting& pSetting)
+{
+    pVolume->SetSmartless(pSetting.Smartless);
+    pVolume->SetOptimisation(pSetting.Optimise);
+}
+
+/**
+ * Write settings as jVoxelTuning into the json file of the module applied last, replacing the former ones. The file is
+ * edited as text, so the rest of it keeps its formatting; it is written to a temporary file first and then renamed.
+ * The next construction of the module reads and applies them.
+ * @param pSettings settings per logical volume name
+ * @return true if the file was written
+ */
+G4bool OMSimVoxelTuning::Record(const std::vector<std::pair<G4String, Setting>>& pSettings)
+{
+    if (!mData || mKey == "" || mData->mFileNames.find(mKey) == mData->mFileNames.end())
+    {
+        error("No json file to record the voxel tuning in (module without json table)");
+        return false;
+    }
+    const G4String lFileName = mData->mFileNames.at(mKey);
+    std::ifstream lInput(lFileName.c_str());
+    std::stringstream lBuffer;
+    lBuffer << lInput.rdbuf();
+    std::string lText = lBuffer.str();
+
+    std::ostringstream lObject;
+    lObject << "{";
+    for (size_t i = 0; i < pSettings.size(); i++)
+    {
+        lObject << (i ? "," : "") << "\n        \"" << pSettings[i].first << "\": { \"jSmartless\": " << pSettings[i].second.Smartless
+                << ", \"jOptimise\": " << (pSettings[i].second.Optimise ? 1 : 0) << " }";
+    }
+    lObject << "\n    }";
+
+    const std::string lKey = "\"jVoxelTuning\"";
+    const size_t lPosition = lText.find(lKey);
+    if (lPosition != std::string::npos)
+    {
+        // replace the former object: find its closing brace, skipping braces in strings
+        const size_t lOpen = lText.find('{', lPosition);
+        G4int lDepth = 0;
+        G4bool lInString = false;
+        size_t lClose = std::string::npos;
+        for (size_t i = lOpen; i < lText.size() && lClose == std::string::npos; i++)
+        {
+            if (lInString)
+            {
+                if (lText[i] == '\\') i++;
+                else if (lText[i] == '"') lInString = false;
+            }
+            else if (lText[i] == '"') lInString = true;
+            else if (lText[i] == '{') lDepth++;
+            else if (lText[i] == '}' && --lDepth == 0) lClose = i;
+        }
+        if (lOpen == std::string::npos || lClose == std::string::npos)
+        {
+            error("Could not parse jVoxelTuning in %s", lFileName.c_str());
+            return false;
+        }
+        lText.replace(lOpen, lClose - lOpen + 1, lObject.str());
+    }
+    else
+    {
+        // new last member of the top-level object
+        const size_t lEnd = lText.rfind('}');
+        const size_t lLast = lEnd == std::string::npos ? std::string::npos : lText.find_last_not_of(" \t\r\n", lEnd - 1);
+        if (lLast == std::string::npos)
+        {
+            error("Could not parse %s", lFileName.c_str());
+            return false;
+        }
+        lText.insert(lLast + 1, ",\n    " + lKey + ": " + lObject.str());
+    }
+
+    const G4String lTemporary = lFileName + ".tmp";
+    {
+        std::ofstream lOutput(lTemporary.c_str());
+        lOutput << lText;
+        if (!lOutput.good())
+        {
+            error("Could not write %s", lTemporary.c_str());
+            return false;
+        }
+    }
+    if (std::rename(lTemporary.c_str(), lFileName.c_str()) != 0)
+    {
+        error("Could not replace %s", lFileName.c_str());
+        return false;
+    }
+    info("Voxel tuning of %d volumes recorded in %s", (G4int)pSettings.size(), lFileName.c_str());
+    return true;
+}
@@ -3,10 +3,17 @@
 #include "abcDetectorComponent.hh"
 #include "OMSimPMTConstruction.hh"
 #include "OMSimLogger.hh"
+#include "G4DisplacedSolid.hh"
+#include "G4LogicalSkinSurface.hh"
 #include "G4LogicalVolume.hh"
+#include "G4Material.hh"
 #include "G4PVPlacement.hh"
 #include "G4SystemOfUnits.hh"
 #include "G4Transform3D.hh"
+#include "G4UnionSolid.hh"
+
+#include <algorithm>
+#include <map>
 
 /**
  * Append one component to Components vector. 
@@ -35,7 +42,7 @@ Component abcDetectorComponent::GetComponent(G4String pName) {
         if (Component->Name == pName) return *Component;
     }
     G4String mssg = pName+" not found in component list. This will probably throw a segmentation fault...";
-    critical(mssg);
+    critical("%s", mssg.c_str());
 }
 
 
@@ -52,15 +59,18 @@ G4Transform3D abcDetectorComponent::GetNewPosition(G4ThreeVector pPosition, G4Ro
  * @param pMother G4LogicalVolume where the module is going to be placed (as in G4PVPlacement())
  * @param pIncludeHarness bool Harness is placed if true
  * @param pNameExtension G4String name of the physical volume. You should not have two physicals with the same name
+ * @param pCopyNumber G4int copy number of the placed components (module ID when several modules are placed)
+ * @param pDetailLevel DetailLevel of this placement, only the components of that level are placed
  */
-void abcDetectorComponent::PlaceIt(G4ThreeVector pPosition, G4RotationMatrix pRotation, G4LogicalVolume*& pMother, G4String pNameExtension)
+void abcDetectorComponent::PlaceIt(G4ThreeVector pPosition, G4RotationMatrix pRotation, G4LogicalVolume*& pMother, G4String pNameExtension, G4int pCopyNumber, G4int pDetailLevel)
 {
     mPlacedPositions.push_back(pPosition);
     mPlacedOrientations.push_back(pRotation);
     G4Transform3D lTrans;
     for (auto Component : Components) {
+        if (!(Component->Levels & (1 << pDetailLevel))) continue;
         lTrans = GetNewPosition(pPosition, pRotation, Component->Position, Component->Rotation);
-        new G4PVPlacement(lTrans, Component->VLogical, Component->Name + pNameExtension, pMother, false, 0, mCheckOverlaps);
+        new G4PVPlacement(lTrans, Component->VLogical, Component->Name + pNameExtension, pMother, false, pCopyNumber, mCheckOverlaps);
     }
 
 }
@@ -84,6 +94,87 @@ void abcDetectorComponent::IntegrateDetectorComponent(abcDetectorComponent* pToI
 }
 
 
+/**
+ * Integrate the components of a harness (placed around the module, at its origin) with levels of detail: every part is
+ * placed at full detail only, the simplified level places the merged proxies of AppendHarnessProxies instead and the
+ * minimal level none of them.
+ * @param pHarness harness whose components we want to integrate
+ * @param pAllLevels names of parts placed at every level, e.g. parts filling a hole cut into the vessel for them
+ */
+void abcDetectorComponent::IntegrateHarness(abcDetectorComponent* pHarness, std::vector<G4String> pAllLevels)
+{
+    const size_t lFirst = Components.size();
+    IntegrateDetectorComponent(pHarness, G4ThreeVector(0, 0, 0), G4RotationMatrix(), "");
+    std::vector<Component*> lParts;
+    for (size_t i = lFirst; i < Components.size(); i++) {
+        if (std::find(pAllLevels.begin(), pAllLevels.end(), Components[i]->Name) != pAllLevels.end()) continue;
+        Components[i]->Levels = 1 << kFullDetail;
+        lParts.push_back(Components[i]);
+    }
+    AppendHarnessProxies(lParts);
+}
+
+
+/**
+ * Proxies of the simplified level: the parts are grouped by material and skin surface, each group becomes one voxelised
+ * G4MultiUnion. Boolean unions of the parts are flattened into the leaves of the G4MultiUnion, so the proxy covers
+ * exactly the same space as the parts (same shadowing and reflections), but the mother volume has one daughter per
+ * group and a query no longer walks through the union trees.
+ * @param pParts parts to merge, placed at the origin of this component
+ */
+void abcDetectorComponent::AppendHarnessProxies(const std::vector<Component*>& pParts)
+{
+    std::map<std::pair<G4Material*, G4SurfaceProperty*>, std::vector<Component*>> lGroups;
+    std::vector<std::pair<G4Material*, G4SurfaceProperty*>> lOrder; // groups in the order of their first part
+    for (auto Component : pParts) {
+        G4LogicalSkinSurface* lSkin = G4LogicalSkinSurface::GetSurface(Component->VLogical);
+        std::pair<G4Material*, G4SurfaceProperty*> lKey(Component->VLogical->GetMaterial(), lSkin ? lSkin->GetSurfaceProperty() : nullptr);
+        if (lGroups.find(lKey) == lGroups.end()) lOrder.push_back(lKey);
+        lGroups[lKey].push_back(Component);
+    }
+
+    for (size_t i = 0; i < lOrder.size(); i++) {
+        const G4String lName = "HarnessProxy_" + std::to_string(i);
+        G4MultiUnion* lProxySolid = new G4MultiUnion(lName + "_solid");
+        for (auto Component : lGroups[lOrder[i]]) {
+            AddLeaves(lProxySolid, Component->VSolid, G4Transform3D(Component->Rotation, Component->Position));
+        }
+        lProxySolid->Voxelize();
+        G4LogicalVolume* lProxyLogical = new G4LogicalVolume(lProxySolid, lOrder[i].first, lName + "_logical");
+        if (lOrder[i].second) new G4LogicalSkinSurface(lName + "_skin", lProxyLogical, lOrder[i].second);
+        lProxyLogical->SetVisAttributes(lGroups[lOrder[i]].front()->VLogical->GetVisAttributes());
+        AppendComponent(lProxySolid, lProxyLogical, G4ThreeVector(0, 0, 0), G4RotationMatrix(), lName);
+        Components.back()->Levels = 1 << kSimplifiedDetail;
+        debug("%s: %d leaves (%s)", lName.c_str(), lProxySolid->GetNumberOfSolids(), lOrder[i].first->GetName().c_str());
+    }
+}
+
+
+/**
+ * Add a solid to a G4MultiUnion, splitting G4UnionSolid trees into their constituents.
+ * @param pUnion G4MultiUnion to fill
+ * @param pSolid solid to add
+ * @param pTransform placement of the solid in the G4MultiUnion
+ */
+void abcDetectorComponent::AddLeaves(G4MultiUnion* pUnion, G4VSolid* pSolid, G4Transform3D pTransform)
+{
+    if (G4UnionSolid* lUnion = dynamic_cast<G4UnionSolid*>(pSolid)) {
+        AddLeaves(pUnion, lUnion->GetConstituentSolid(0), pTransform);
+        AddLeaves(pUnion, lUnion->GetConstituentSolid(1), pTransform);
+        return;
+    }
+    if (G4DisplacedSolid* lDisplaced = dynamic_cast<G4DisplacedSolid*>(pSolid)) {
+        // rotation of the direct transform from the images of the axes, which avoids the conventions of G4AffineTransform
+        const G4AffineTransform lDirect = lDisplaced->GetDirectTransform();
+        G4RotationMatrix lRotation;
+        lRotation.rotateAxes(lDirect.TransformAxis(G4ThreeVector(1, 0, 0)), lDirect.TransformAxis(G4ThreeVector(0, 1, 0)), lDirect.TransformAxis(G4ThreeVector(0, 0, 1)));
+        AddLeaves(pUnion, lDisplaced->GetConstituentMovedSolid(), pTransform * G4Transform3D(lRotation, lDirect.NetTranslation()));
+        return;
+    }
+    pUnion->AddNode(*pSolid, pTransform);
+}
+
+
 G4SubtractionSolid* abcDetectorComponent::SubstractToVolume(G4VSolid* pInputVolume, G4ThreeVector pSubstractionPos, G4RotationMatrix pSubstractionRot, G4String pNewVolumeName)
 {
     G4SubtractionSolid* lSubstractedVolume;
@@ -101,3 +192,43 @@ G4SubtractionSolid* abcDetectorComponent::SubstractToVolume(G4VSolid* pInputVolu
     return lSubstractedVolume;
 }
 
+
+
+/**
+ * Radius of a sphere around the origin of the component that contains all its components (bounding boxes of the solids
+ * are transformed to the mother frame, so the value is slightly conservative).
+ * @return bounding radius
+ */
+G4double abcDetectorComponent::GetBoundingRadius()
+{
+    G4double lRadius = 0;
+    G4ThreeVector lMin, lMax;
+    for (auto Component : Components) {
+        Component->VSolid->BoundingLimits(lMin, lMax);
+        for (G4int i = 0; i < 8; i++) {
+            G4ThreeVector lCorner((i & 1) ? lMax.x() : lMin.x(), (i & 2) ? lMax.y() : lMin.y(), (i & 4) ? lMax.z() : lMin.z());
+            lRadius = std::max(lRadius, (Component->Rotation * lCorner + Component->Position).mag());
+        }
+    }
+    return lRadius;
+}
+
+
+/**
+ * Logical volumes of the component: those of its components and all volumes placed inside them, each once.
+ * @return volumes, components first, then their daughters
+ */
+std::vector<G4LogicalVolume*> abcDetectorComponent::GetLogicalVolumes()
+{
+    std::vector<G4LogicalVolume*> lVolumes;
+    for (auto Component : Components) {
+        if (std::find(lVolumes.begin(), lVolumes.end(), Component->VLogical) == lVolumes.end()) lVolumes.push_back(Component->VLogical);
+    }
+    for (size_t i = 0; i < lVolumes.size(); i++) {
+        for (size_t j = 0; j < lVolumes[i]->GetNoDaughters(); j++) {
+            G4LogicalVolume* lDaughter = lVolumes[i]->GetDaughter(j)->GetLogicalVolume();
+            if (std::find(lVolumes.begin(), lVolumes.end(), lDaughter) == lVolumes.end()) lVolumes.push_back(lDaughter);
+        }
+    }
+    return lVolumes;
+}